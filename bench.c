@@ -0,0 +1,389 @@
+// Benchmark suite for dynamic_int.h
+//
+// Times the core operations across operand sizes from 1 limb up to 1M
+// limbs, then a few whole workloads (factorial, digits of pi, modular
+// exponentiation). Results go to stdout as CSV (default) or JSON so runs
+// from different versions can be compared by a script.
+//
+// Usage: bench [--json] [--max-limbs N] [--min-time MS] [--filter TEXT]
+//
+//   --json          JSON instead of CSV
+//   --max-limbs N   run every operation up to N limbs; by default each
+//                   operation stops at a size where one call stays
+//                   below about a second (quadratic ones stop early)
+//   --min-time MS   time each case for at least MS milliseconds (100)
+//   --filter TEXT   only cases whose name contains TEXT
+//
+// Set DI_CPU to compare kernel sets (see di_set_cpu()).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define DI_IMPLEMENTATION
+#include "dynamic_int.h"
+
+typedef struct {
+    di_int a;
+    di_int b;
+    di_int m;
+    char* text;
+} bench_operands;
+
+typedef struct {
+    const char* name;
+    size_t default_max_limbs;
+    void (*setup)(bench_operands* ops, size_t limbs, di_rng* rng);
+    void (*run)(bench_operands* ops);
+} bench_case;
+
+typedef struct {
+    const char* name;
+    size_t bits;            // Approximate result size, for --max-limbs
+    size_t (*run)(void);    // Returns the result's limb count, 0 on error
+} bench_workload;
+
+static bool bench_json = false;
+static size_t bench_rows = 0;
+
+static double bench_now_ns(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Exactly 'limbs' limbs: top bit set so sizes do not drift
+static di_int bench_random(size_t limbs, di_rng* rng) {
+    di_int r = di_random_r(limbs * DI_LIMB_BITS - 1, rng);
+    di_int one = di_one();
+    di_int top = di_shift_left(one, limbs * DI_LIMB_BITS - 1);
+    di_int value = di_or(r, top);
+    di_release(&r);
+    di_release(&one);
+    di_release(&top);
+    return value;
+}
+
+static di_int bench_from_u32(uint32_t value) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u", (unsigned)value);
+    return di_from_string(buf, 10);
+}
+
+static void bench_report(const char* name, size_t limbs, size_t iterations, double ns_per_op) {
+    double limbs_per_ns = ns_per_op > 0 ? (double)limbs / ns_per_op : 0.0;
+    if (bench_json) {
+        printf("%s\n    {\"benchmark\": \"%s\", \"limbs\": %zu, \"iterations\": %zu, "
+               "\"ns_per_op\": %.1f, \"limbs_per_ns\": %.6f}",
+               bench_rows ? "," : "", name, limbs, iterations, ns_per_op, limbs_per_ns);
+    } else {
+        printf("%s,%zu,%zu,%.1f,%.6f\n", name, limbs, iterations, ns_per_op, limbs_per_ns);
+    }
+    bench_rows++;
+    fflush(stdout);
+}
+
+/* Operation cases */
+
+static void setup_pair(bench_operands* ops, size_t limbs, di_rng* rng) {
+    ops->a = bench_random(limbs, rng);
+    ops->b = bench_random(limbs, rng);
+}
+
+static void setup_div(bench_operands* ops, size_t limbs, di_rng* rng) {
+    ops->a = bench_random(2 * limbs, rng);
+    ops->b = bench_random(limbs, rng);
+}
+
+static void setup_string(bench_operands* ops, size_t limbs, di_rng* rng) {
+    ops->a = bench_random(limbs, rng);
+    ops->text = di_to_string(ops->a, 10);
+}
+
+// Odd modulus, so di_mod_pow() takes the Montgomery path
+static void setup_mod_pow(bench_operands* ops, size_t limbs, di_rng* rng) {
+    setup_pair(ops, limbs, rng);
+    di_int m = bench_random(limbs, rng);
+    di_int one = di_one();
+    ops->m = di_or(m, one);
+    di_release(&m);
+    di_release(&one);
+}
+
+static void run_add(bench_operands* ops) {
+    di_int r = di_add(ops->a, ops->b);
+    di_release(&r);
+}
+
+static void run_sub(bench_operands* ops) {
+    di_int r = di_sub(ops->a, ops->b);
+    di_release(&r);
+}
+
+static void run_mul(bench_operands* ops) {
+    di_int r = di_mul(ops->a, ops->b);
+    di_release(&r);
+}
+
+static void run_div(bench_operands* ops) {
+    di_int r = di_div(ops->a, ops->b);
+    di_release(&r);
+}
+
+static void run_shift_left(bench_operands* ops) {
+    di_int r = di_shift_left(ops->a, 13);
+    di_release(&r);
+}
+
+static void run_and(bench_operands* ops) {
+    di_int r = di_and(ops->a, ops->b);
+    di_release(&r);
+}
+
+static void run_to_string(bench_operands* ops) {
+    char* s = di_to_string(ops->a, 10);
+    free(s);
+}
+
+static void run_from_string(bench_operands* ops) {
+    di_int r = di_from_string(ops->text, 10);
+    di_release(&r);
+}
+
+static void run_mod_pow(bench_operands* ops) {
+    di_int r = di_mod_pow(ops->a, ops->b, ops->m);
+    di_release(&r);
+}
+
+static const bench_case bench_cases[] = {
+    { "add", 1048576, setup_pair, run_add },
+    { "sub", 1048576, setup_pair, run_sub },
+    { "shift_left", 1048576, setup_pair, run_shift_left },
+    { "and", 1048576, setup_pair, run_and },
+    { "mul", 65536, setup_pair, run_mul },
+    { "div", 256, setup_div, run_div },
+    { "to_string", 1024, setup_string, run_to_string },
+    { "from_string", 1024, setup_string, run_from_string },
+    { "mod_pow", 256, setup_mod_pow, run_mod_pow },
+};
+
+// Double the batch until it runs for min_ns, then report the last batch
+static void bench_time_case(const bench_case* c, size_t limbs, double min_ns, di_rng* rng) {
+    bench_operands ops = { NULL, NULL, NULL, NULL };
+    c->setup(&ops, limbs, rng);
+
+    c->run(&ops); // Warm caches and lazy initialization
+    size_t iterations = 1;
+    double elapsed;
+    for (;;) {
+        double start = bench_now_ns();
+        for (size_t i = 0; i < iterations; i++) c->run(&ops);
+        elapsed = bench_now_ns() - start;
+        if (elapsed >= min_ns || iterations >= ((size_t)1 << 30)) break;
+        iterations *= 2;
+    }
+    bench_report(c->name, limbs, iterations, elapsed / (double)iterations);
+
+    di_release(&ops.a);
+    di_release(&ops.b);
+    di_release(&ops.m);
+    free(ops.text);
+}
+
+/* Workloads */
+
+static size_t workload_factorial(uint32_t n) {
+    di_int f = di_factorial(n);
+    size_t limbs = f ? di_limb_count(f) : 0;
+    di_release(&f);
+    return limbs;
+}
+
+static size_t workload_factorial_10000(void) {
+    return workload_factorial(10000);
+}
+
+static size_t workload_factorial_100000(void) {
+    return workload_factorial(100000);
+}
+
+// 10^k by repeated squaring
+static di_int bench_pow10(size_t k) {
+    di_int result = di_one();
+    di_int square = bench_from_u32(10);
+    for (; k; k >>= 1) {
+        if (k & 1) {
+            di_int next = di_mul(result, square);
+            di_release(&result);
+            result = next;
+        }
+        if (k > 1) {
+            di_int next = di_mul(square, square);
+            di_release(&square);
+            square = next;
+        }
+    }
+    di_release(&square);
+    return result;
+}
+
+// unity * arctan(1 / x) by its Taylor series
+static di_int bench_arctan_inv(di_int unity, uint32_t x) {
+    di_int divisor = bench_from_u32(x);
+    di_int x2 = bench_from_u32(x * x);
+    di_int term = di_div(unity, divisor);
+    di_int sum = di_retain(term);
+    for (uint32_t k = 1; !di_is_zero(term); k++) {
+        di_int next = di_div(term, x2);
+        di_release(&term);
+        term = next;
+        di_int odd = bench_from_u32(2 * k + 1);
+        di_int part = di_div(term, odd);
+        di_int total = (k & 1) ? di_sub(sum, part) : di_add(sum, part);
+        di_release(&sum);
+        sum = total;
+        di_release(&odd);
+        di_release(&part);
+    }
+    di_release(&divisor);
+    di_release(&x2);
+    di_release(&term);
+    return sum;
+}
+
+// Machin: pi = 16 arctan(1/5) - 4 arctan(1/239), with 10 guard digits
+static size_t workload_pi_digits(size_t digits) {
+    di_int unity = bench_pow10(digits + 10);
+    di_int a = bench_arctan_inv(unity, 5);
+    di_int b = bench_arctan_inv(unity, 239);
+    di_int a16 = di_shift_left(a, 4);
+    di_int b4 = di_shift_left(b, 2);
+    di_int scaled = di_sub(a16, b4);
+    di_int guard = bench_pow10(10);
+    di_int pi = di_div(scaled, guard);
+
+    char* text = di_to_string(pi, 10);
+    size_t limbs = text && strncmp(text, "314159265358979323846", 21) == 0 ? di_limb_count(pi) : 0;
+    free(text);
+    di_release(&unity);
+    di_release(&a);
+    di_release(&b);
+    di_release(&a16);
+    di_release(&b4);
+    di_release(&scaled);
+    di_release(&guard);
+    di_release(&pi);
+    return limbs;
+}
+
+static size_t workload_pi_digits_5000(void) {
+    return workload_pi_digits(5000);
+}
+
+static size_t workload_modexp(size_t bits) {
+    di_rng rng;
+    di_rng_seed(&rng, bits);
+    size_t limbs = bits / DI_LIMB_BITS;
+    bench_operands ops = { NULL, NULL, NULL, NULL };
+    setup_mod_pow(&ops, limbs, &rng);
+    di_int r = di_mod_pow(ops.a, ops.b, ops.m);
+    size_t result = r ? limbs : 0;
+    di_release(&r);
+    di_release(&ops.a);
+    di_release(&ops.b);
+    di_release(&ops.m);
+    return result;
+}
+
+static size_t workload_modexp_2048(void) {
+    return workload_modexp(2048);
+}
+
+static size_t workload_modexp_4096(void) {
+    return workload_modexp(4096);
+}
+
+static const bench_workload bench_workloads[] = {
+    { "factorial(10000)", 118459, workload_factorial_10000 },
+    { "factorial(100000)", 1516705, workload_factorial_100000 },
+    { "pi_digits(5000)", 16645, workload_pi_digits_5000 },
+    { "modexp(2048)", 2048, workload_modexp_2048 },
+    { "modexp(4096)", 4096, workload_modexp_4096 },
+};
+
+static bool bench_time_workload(const bench_workload* w, double min_ns) {
+    size_t limbs = 0;
+    size_t iterations = 0;
+    double start = bench_now_ns();
+    double elapsed;
+    do {
+        limbs = w->run();
+        if (!limbs) return false;
+        iterations++;
+        elapsed = bench_now_ns() - start;
+    } while (elapsed < min_ns);
+    bench_report(w->name, limbs, iterations, elapsed / (double)iterations);
+    return true;
+}
+
+static int bench_usage(const char* program) {
+    fprintf(stderr, "usage: %s [--json] [--max-limbs N] [--min-time MS] [--filter TEXT]\n", program);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    size_t max_limbs = 0;   // 0: each case's default
+    double min_ns = 100e6;
+    const char* filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            bench_json = true;
+        } else if (strcmp(argv[i], "--max-limbs") == 0 && i + 1 < argc) {
+            max_limbs = (size_t)strtoull(argv[++i], NULL, 10);
+            if (max_limbs == 0) return bench_usage(argv[0]);
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_ns = strtod(argv[++i], NULL) * 1e6;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            return bench_usage(argv[0]);
+        }
+    }
+
+    if (bench_json) {
+        printf("{\n  \"cpu\": \"%s\",\n  \"limb_bits\": %d,\n  \"threads\": %d,\n  \"results\": [",
+               di_get_cpu(), DI_LIMB_BITS, di_get_threads());
+    } else {
+        printf("benchmark,limbs,iterations,ns_per_op,limbs_per_ns\n");
+    }
+
+    di_rng rng;
+    di_rng_seed(&rng, 68);
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const bench_case* bc = &bench_cases[c];
+        if (filter && !strstr(bc->name, filter)) continue;
+        size_t limit = max_limbs ? max_limbs : bc->default_max_limbs;
+        for (size_t limbs = 1; limbs <= limit && limbs <= 1048576; limbs *= 4) {
+            bench_time_case(bc, limbs, min_ns, &rng);
+        }
+    }
+
+    int status = 0;
+    for (size_t w = 0; w < sizeof(bench_workloads) / sizeof(bench_workloads[0]); w++) {
+        const bench_workload* bw = &bench_workloads[w];
+        if (filter && !strstr(bw->name, filter)) continue;
+        if (max_limbs && bw->bits / DI_LIMB_BITS > max_limbs) continue;
+        if (!bench_time_workload(bw, min_ns)) {
+            fprintf(stderr, "%s: wrong result\n", bw->name);
+            status = 1;
+        }
+    }
+
+    if (bench_json) printf("\n  ]\n}\n");
+    return status;
+}
@@ -18,6 +18,25 @@
  * #define DI_FREE free             // custom deallocator
  * #define DI_ASSERT assert         // custom assert macro
  * #define DI_LIMB_BITS 32          // bits per limb (default: 32)
+ * #define DI_THREADSAFE            // atomic reference counts (C11 <stdatomic.h>)
+ * #define DI_THREAD_LOCAL          // thread-local storage keyword (auto-detected)
+ * #define DI_RNG_USE_RAND          // draw random bits from rand() (small MCUs only)
+ * #define DI_SECURE_RANDOM         // default generator reads OS entropy (see di_rng_secure())
+ * #define DI_THREADS               // POSIX threads (*_mt functions, di_set_threads())
+ * #define DI_STATS                 // count allocations and operations (di_stats_get())
+ * #define DI_TRACE                 // per-operation latency histograms (di_trace_dump())
+ * #define DI_KARATSUBA_THRESHOLD 32    // limbs where di_mul() switches to Karatsuba
+ * #define DI_IFMA_MUL_THRESHOLD 8      // limbs where di_mul() may use AVX-512 IFMA
+ * #define DI_IFMA_KARATSUBA_THRESHOLD 1024 // Karatsuba threshold when IFMA is used
+ * #define DI_IFMA_MONT_THRESHOLD 8     // modulus limbs where di_mod_pow() may use IFMA
+ * #define DI_MUL_THREAD_THRESHOLD 4096 // limbs where di_mul() may use threads
+ * #define DI_NO_TUNED              // ignore dynamic_int_tuned.h written by the tune target
+ * #define DI_BATCH_TASK_LIMBS 16384    // limb operations per *_batch() thread task
+ * #define DI_VEC_LANES 16              // values per di_vec block (SIMD width)
+ * #define DI_FIXED_MAX_LIMBS 32        // largest di_fixed capacity (sizes stack scratch)
+ * #define DI_NO_SIMD               // portable loops only, no AVX2/AVX-512/IFMA/NEON kernels
+ * #define DI_NEON                  // opt in to the NEON kernels on AArch64 (not yet tested on hardware)
+ * #define DI_NO_OVERFLOW_BUILTINS  // range checks instead of __builtin_*_overflow
  *
  * #define DI_IMPLEMENTATION
  * #include "dynamic_int.h"
@@ -43,6 +62,39 @@
  * di_release(&b);
  * di_release(&sum);
  * @endcode
+ *
+ * @section threads Thread Safety
+ *
+ * Integers carry no shared state, so operations on them are reentrant:
+ *
+ * - Any function may be called concurrently from several threads as long
+ *   as each call's inputs are either distinct or only read. Integers are
+ *   immutable once returned, so sharing a di_int for reading is safe.
+ * - di_retain() and di_release() modify the reference count. Sharing one
+ *   handle between threads that retain or release it requires building
+ *   with DI_THREADSAFE.
+ * - Random functions draw from an explicit di_rng. The *_r variants take
+ *   one; the others use a per-thread default (see di_rng_default()). A
+ *   single di_rng must not be used by two threads at once.
+ *
+ * A few settings are process-wide:
+ *
+ * - Worker pool (DI_THREADS): the pool behind the *_mt functions, di_mul()
+ *   and the batch operations is created on first use and shared by all
+ *   threads. di_set_threads() shuts it down to resize it, so it must not
+ *   run concurrently with itself or with any library call that may use
+ *   the pool; call it at startup or while no other thread is computing.
+ * - Kernel set: the limb kernels are chosen once per process from the CPU
+ *   and DI_CPU. di_set_cpu() switches them for every thread; with
+ *   DI_THREADS or DI_THREADSAFE it may be called at any time, otherwise
+ *   only before other threads use the library.
+ * - Statistics and tracing (DI_STATS, DI_TRACE): each thread counts into
+ *   its own block on a global list. di_stats_get(), di_trace_get() and
+ *   di_trace_dump() may run at any time and see counts that are at most
+ *   slightly stale; di_stats_reset() and di_trace_reset() may drop counts
+ *   taken by other threads while they run. Without DI_THREADS or
+ *   DI_THREADSAFE the counters are plain integers and the library must
+ *   only be used from one thread.
  */
 
 #ifndef DYNAMIC_INT_H
@@ -74,6 +126,57 @@
 #define DI_LIMB_BITS 32
 #endif
 
+// Crossovers measured on this host by the tune target, if it has been run
+#if !defined(DI_NO_TUNED) && !defined(DI_TUNING) && defined(__has_include)
+#if __has_include("dynamic_int_tuned.h")
+#include "dynamic_int_tuned.h"
+#endif
+#endif
+
+#ifndef DI_KARATSUBA_THRESHOLD
+#define DI_KARATSUBA_THRESHOLD 32    // limbs in the shorter operand
+#endif
+
+#ifndef DI_IFMA_MUL_THRESHOLD
+#define DI_IFMA_MUL_THRESHOLD 8      // limbs in the shorter operand
+#endif
+
+#ifndef DI_IFMA_KARATSUBA_THRESHOLD
+#define DI_IFMA_KARATSUBA_THRESHOLD 1024 // Karatsuba threshold with IFMA
+#endif
+
+#ifndef DI_IFMA_MONT_THRESHOLD
+#define DI_IFMA_MONT_THRESHOLD 8     // limbs in the modulus
+#endif
+
+#ifndef DI_MUL_THREAD_THRESHOLD
+#define DI_MUL_THREAD_THRESHOLD 4096 // limbs in the shorter operand
+#endif
+
+#ifndef DI_BATCH_TASK_LIMBS
+#define DI_BATCH_TASK_LIMBS 16384    // limb operations per batch task
+#endif
+
+#ifndef DI_FIXED_MAX_LIMBS
+#define DI_FIXED_MAX_LIMBS 32        // largest di_fixed capacity
+#endif
+
+#ifndef DI_VEC_LANES
+#define DI_VEC_LANES 16              // values per di_vec block
+#endif
+
+#ifndef DI_THREAD_LOCAL
+#if defined(_MSC_VER)
+#define DI_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define DI_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define DI_THREAD_LOCAL __thread
+#else
+#define DI_THREAD_LOCAL /* single-threaded targets */
+#endif
+#endif
+
 // API macros
 #ifdef DI_STATIC
 #define DI_DEF static
@@ -83,6 +186,23 @@
 #define DI_IMPL /* nothing - default linkage */
 #endif
 
+// Helpers defined in the header itself so callers inline them
+#if defined(_MSC_VER) && !defined(__cplusplus)
+#define DI_INLINE static __inline
+#else
+#define DI_INLINE static inline
+#endif
+
+// __builtin_{add,sub,mul}_overflow: GCC 5+, Clang 3.8+
+#if !defined(DI_NO_OVERFLOW_BUILTINS) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 5
+#define DI_HAS_OVERFLOW_BUILTINS 1
+#elif !defined(DI_NO_OVERFLOW_BUILTINS) && defined(__has_builtin)
+#if __has_builtin(__builtin_add_overflow) && __has_builtin(__builtin_sub_overflow) && \
+    __has_builtin(__builtin_mul_overflow)
+#define DI_HAS_OVERFLOW_BUILTINS 1
+#endif
+#endif
+
 #if DI_LIMB_BITS == 32
 typedef uint32_t di_limb_t;
 typedef uint64_t di_dlimb_t;  // Double-width for multiplication
@@ -271,6 +391,7 @@ DI_DEF di_int di_copy(di_int big);
  * @endcode
  * 
  * @note Use this when you want to share the same integer instance
+ * @note Build with DI_THREADSAFE to share instances across threads
  * @see di_release() for decrementing reference count
  * @see di_copy() for creating an independent copy
  */
@@ -374,6 +495,9 @@ DI_DEF di_int di_sub_i32(di_int a, int32_t b);
  * @since 1.0.0
  * 
  * @note Supports arbitrary precision multiplication
+ * @note On x86 CPUs with AVX-512 IFMA (checked at run time), products whose
+ *       shorter operand has DI_IFMA_MUL_THRESHOLD or more 32-bit limbs use
+ *       52-bit multiply-add instructions; define DI_NO_SIMD to disable
  * @see di_mul_i32() for mixed-type multiplication with int32_t
  */
 DI_DEF di_int di_mul(di_int a, di_int b);
@@ -472,12 +596,11 @@ DI_DEF di_int di_abs(di_int a);
 
 /**
  * @brief Raise integer to a power
- * @param base Base integer (may be NULL)
+ * @param base Base integer (must not be NULL)
  * @param exp Exponent (32-bit unsigned integer)
- * @return New di_int with result of base^exp, or NULL on failure
+ * @return New di_int with result of base^exp (1 when exp is 0)
  * @since 1.0.0
  * 
- * @note This is not yet implemented
  * @see di_mod_pow() for modular exponentiation
  */
 DI_DEF di_int di_pow(di_int base, uint32_t exp);
@@ -487,6 +610,11 @@ DI_DEF di_int di_pow(di_int base, uint32_t exp);
 /**
  * @defgroup bitwise_operations Bitwise Operations
  * @brief Bitwise operations for arbitrary precision integers
+ *
+ * On x86 the limb loops use AVX-512 or AVX2 when the CPU reports support
+ * at run time (see di_set_cpu()); define DI_NO_SIMD to build only the
+ * portable loops. NEON kernels for AArch64 are built only when DI_NEON is
+ * defined, until they have been tested on AArch64 hardware.
  * @{
  */
 
@@ -736,1951 +864,8178 @@ DI_DEF char* di_to_string(di_int big, int base);
 /** @} */ // end of conversion_operations
 
 /**
- * @defgroup utility_functions Utility Functions
- * @brief Utility functions for querying integer properties
+ * @defgroup serialization Binary Serialization
+ * @brief Functions for moving magnitudes in and out of raw word buffers
  * @{
  */
 
-/**
- * @brief Get bit length of integer (number of bits needed to represent)
- * @param big Integer to query (may be NULL)
- * @return Number of bits needed to represent integer, or 0 if NULL or zero
- * @since 1.0.0
- */
-DI_DEF size_t di_bit_length(di_int big);
+/** @brief Word order for di_export()/di_import(): most significant word first */
+#define DI_ORDER_MSF 1
+/** @brief Word order for di_export()/di_import(): least significant word first */
+#define DI_ORDER_LSF (-1)
+
+/** @brief Byte order within each word: most significant byte first */
+#define DI_ENDIAN_BIG 1
+/** @brief Byte order within each word: least significant byte first */
+#define DI_ENDIAN_LITTLE (-1)
+/** @brief Byte order within each word: whatever the host uses */
+#define DI_ENDIAN_NATIVE 0
 
 /**
- * @brief Get number of limbs used by integer
- * @param big Integer to query (may be NULL)
- * @return Number of limbs in use, or 0 if NULL
- * @since 1.0.0
- * 
- * @note Primarily for debugging and internal use
+ * @brief Get number of words needed to export the magnitude of an integer
+ * @param big Integer to query (must not be NULL)
+ * @param word_size Size of each word in bytes (must be > 0)
+ * @return Number of words di_export() will write, or 0 if big is zero
+ * @since 1.2.0
+ *
+ * @code
+ * size_t words = di_export_size(big, 1);   // bytes needed
+ * uint8_t* buf = malloc(words);
+ * di_export(big, buf, words, 1, DI_ENDIAN_BIG, DI_ORDER_MSF);
+ * @endcode
+ *
+ * @see di_export() for writing the words
  */
-DI_DEF size_t di_limb_count(di_int big);
+DI_DEF size_t di_export_size(di_int big, size_t word_size);
 
 /**
- * @brief Reserve capacity for an integer (performance optimization)
- * @param big Integer to resize (may be NULL)
- * @param capacity Number of limbs to reserve capacity for
- * @return true if successful, false on allocation failure
- * @since 1.0.0
- * 
+ * @brief Export the magnitude of an integer into a buffer of words
+ * @param big Integer to export (must not be NULL)
+ * @param buf Destination buffer (must not be NULL unless big is zero)
+ * @param cap Capacity of buf in bytes
+ * @param word_size Size of each word in bytes (must be > 0)
+ * @param endianness Byte order within a word: DI_ENDIAN_BIG, DI_ENDIAN_LITTLE or DI_ENDIAN_NATIVE
+ * @param order Word order: DI_ORDER_MSF or DI_ORDER_LSF
+ * @return Number of words written, or 0 if big is zero or buf is too small
+ * @since 1.2.0
+ *
+ * Works like GMP's mpz_export(): only the absolute value is written and the
+ * sign must be carried separately (see di_is_negative()). The most
+ * significant word is zero padded when the magnitude does not fill it.
+ * When word_size equals sizeof(di_limb_t) the limbs are copied directly,
+ * byte swapping only if the requested endianness differs from the host.
+ *
  * @code
- * di_int big = di_from_int32(0);
- * 
- * // Pre-allocate space for large operations to avoid repeated allocations
- * if (di_reserve(big, 100)) {
- *     // Now operations won't need to reallocate until 100 limbs are needed
- *     for (int i = 0; i < 1000; i++) {
- *         di_int temp = di_mul_i32(big, 2);
- *         di_release(&big);
- *         big = temp;
- *     }
- * }
+ * di_int big = di_from_string("123456789012345678901234567890", 10);
+ * uint8_t buf[64];
+ * size_t n = di_export(big, buf, sizeof(buf), 1, DI_ENDIAN_BIG, DI_ORDER_MSF);
+ * di_int back = di_import(buf, n, 1, DI_ENDIAN_BIG, DI_ORDER_MSF);
+ * assert(di_eq(big, back));
  * di_release(&big);
+ * di_release(&back);
  * @endcode
- * 
- * @note This is purely a performance optimization - integers work without it
- * @note Similar to std::vector::reserve() in C++
- * @see di_limb_count() for getting current limb count
+ *
+ * @note Use di_export_size() to tell a zero value from a short buffer
+ * @see di_import() for the reverse operation
  */
-DI_DEF bool di_reserve(di_int big, size_t capacity);
-
-/** @} */ // end of utility_functions
+DI_DEF size_t di_export(di_int big, void* buf, size_t cap, size_t word_size, int endianness, int order);
 
 /**
- * @defgroup advanced_math Advanced Mathematical Operations
- * @brief Advanced mathematical functions for arbitrary precision integers
- * @{
+ * @brief Create a non-negative integer from a buffer of words
+ * @param buf Source buffer (must not be NULL unless count is 0)
+ * @param count Number of words in buf
+ * @param word_size Size of each word in bytes (must be > 0)
+ * @param endianness Byte order within a word: DI_ENDIAN_BIG, DI_ENDIAN_LITTLE or DI_ENDIAN_NATIVE
+ * @param order Word order: DI_ORDER_MSF or DI_ORDER_LSF
+ * @return New non-negative di_int with the imported magnitude
+ * @since 1.2.0
+ *
+ * Works like GMP's mpz_import(). Leading zero words are allowed.
+ *
+ * @see di_export() for the reverse operation
+ * @see di_negate() for applying a separately stored sign
  */
+DI_DEF di_int di_import(const void* buf, size_t count, size_t word_size, int endianness, int order);
 
 /**
- * @brief Modular exponentiation: (base^exp) mod mod
- * @param base Base integer (may be NULL)
- * @param exp Exponent integer (may be NULL)
- * @param mod Modulus integer (may be NULL)
- * @return New di_int with result of (base^exp) mod mod, or NULL on failure
- * @since 1.0.0
- * 
- * @note Returns NULL if mod is zero or one
- * @note Uses binary exponentiation for efficiency
+ * @brief Get number of bytes needed to varint encode an integer
+ * @param big Integer to query (must not be NULL)
+ * @return Number of bytes di_encode_varint() will write (at least 1)
+ * @since 1.2.0
+ *
+ * @see di_encode_varint() for the encoding
  */
-DI_DEF di_int di_mod_pow(di_int base, di_int exp, di_int mod);
+DI_DEF size_t di_varint_size(di_int big);
 
 /**
- * @brief Greatest Common Divisor using Euclidean algorithm
- * @param a First integer (may be NULL)
- * @param b Second integer (may be NULL)
- * @return New di_int with GCD of |a| and |b|, or NULL on failure
- * @since 1.0.0
- * 
- * @see di_lcm() for Least Common Multiple
- * @see di_extended_gcd() for extended Euclidean algorithm
+ * @brief Encode an integer as a zigzag-signed LEB128 varint
+ * @param big Integer to encode (must not be NULL)
+ * @param buf Destination buffer
+ * @param cap Capacity of buf in bytes
+ * @return Number of bytes written, or 0 if buf is too small
+ * @since 1.2.0
+ *
+ * The value is zigzag mapped (0, -1, 1, -2, ... become 0, 1, 2, 3, ...) and
+ * then written 7 bits per byte, least significant group first, with the
+ * high bit of each byte flagging a continuation. Values that fit in 64
+ * bits produce exactly the bytes protobuf's sint64 would, so small
+ * integers take one or two bytes; larger values are streamed straight
+ * from the limb array.
+ *
+ * @code
+ * uint8_t buf[16];
+ * di_int a = di_from_int32(-3);
+ * size_t n = di_encode_varint(a, buf, sizeof(buf));  // n = 1, buf[0] = 0x05
+ * di_int b = di_decode_varint(buf, n, NULL);
+ * assert(di_eq(a, b));
+ * di_release(&a);
+ * di_release(&b);
+ * @endcode
+ *
+ * @see di_decode_varint() for the reverse operation
+ * @see di_encode_varint_batch() for encoding arrays
  */
-DI_DEF di_int di_gcd(di_int a, di_int b);
+DI_DEF size_t di_encode_varint(di_int big, uint8_t* buf, size_t cap);
 
 /**
- * @brief Least Common Multiple
- * @param a First integer (may be NULL)
- * @param b Second integer (may be NULL)
- * @return New di_int with LCM of a and b, or NULL on failure
- * @since 1.0.0
- * 
- * @note Uses identity: lcm(a,b) = |a*b| / gcd(a,b)
- * @see di_gcd() for Greatest Common Divisor
+ * @brief Decode a zigzag-signed LEB128 varint
+ * @param buf Source buffer (must not be NULL unless len is 0)
+ * @param len Number of bytes available in buf
+ * @param consumed Optional pointer to store the number of bytes read
+ * @return New di_int, or NULL if buf ends before the varint does
+ * @since 1.2.0
+ *
+ * @see di_encode_varint() for the encoding
  */
-DI_DEF di_int di_lcm(di_int a, di_int b);
+DI_DEF di_int di_decode_varint(const uint8_t* buf, size_t len, size_t* consumed);
 
 /**
- * @brief Extended Euclidean Algorithm
- * @param a First integer (may be NULL)
- * @param b Second integer (may be NULL)
- * @param x Pointer to store coefficient x
- * @param y Pointer to store coefficient y
- * @return GCD of a and b, with coefficients such that ax + by = gcd(a,b)
- * @since 1.0.0
- * 
- * @note Sets *x and *y to coefficients satisfying the Bezout identity
+ * @brief Get number of bytes needed to varint encode an array of integers
+ * @param values Array of integers (none may be NULL)
+ * @param count Number of integers in values
+ * @return Total number of bytes di_encode_varint_batch() will write
+ * @since 1.2.0
  */
-DI_DEF di_int di_extended_gcd(di_int a, di_int b, di_int* x, di_int* y);
+DI_DEF size_t di_varint_batch_size(const di_int* values, size_t count);
 
 /**
- * @brief Integer square root using Newton's method
- * @param n Integer to find square root of (may be NULL)
- * @return New di_int with floor(sqrt(n)), or NULL on failure
- * @since 1.0.0
- * 
- * @note Returns NULL for negative inputs
+ * @brief Encode an array of integers as consecutive varints
+ * @param values Array of integers (none may be NULL)
+ * @param count Number of integers in values
+ * @param buf Destination buffer
+ * @param cap Capacity of buf in bytes
+ * @return Number of bytes written, or 0 if buf is too small
+ * @since 1.2.0
+ *
+ * @see di_decode_varint_batch() for the reverse operation
  */
-DI_DEF di_int di_sqrt(di_int n);
+DI_DEF size_t di_encode_varint_batch(const di_int* values, size_t count, uint8_t* buf, size_t cap);
 
 /**
- * @brief Calculate factorial
- * @param n Non-negative integer
- * @return New di_int with n! (n factorial), or NULL on failure
- * @since 1.0.0
- * 
- * @code
- * di_int fact5 = di_factorial(5);  // 120
- * di_int fact10 = di_factorial(10); // 3628800
- * @endcode
+ * @brief Decode consecutive varints into an array of integers
+ * @param buf Source buffer (must not be NULL unless len is 0)
+ * @param len Number of bytes available in buf
+ * @param out Array receiving count new integers (caller releases them)
+ * @param count Number of varints to decode
+ * @return Number of bytes consumed, or 0 if buf holds fewer than count varints
+ * @since 1.2.0
+ *
+ * @note On failure nothing is left allocated and out is filled with NULL
  */
-DI_DEF di_int di_factorial(uint32_t n);
-
-/** @} */ // end of advanced_math
+DI_DEF size_t di_decode_varint_batch(const uint8_t* buf, size_t len, di_int* out, size_t count);
 
 /**
- * @defgroup prime_functions Prime Number Functions
- * @brief Functions for working with prime numbers
- * @{
+ * @brief Get number of bytes needed to CBOR encode an integer
+ * @param big Integer to query (must not be NULL)
+ * @return Number of bytes di_encode_cbor() will write
+ * @since 1.2.0
  */
+DI_DEF size_t di_cbor_size(di_int big);
 
 /**
- * @brief Test if integer is prime (Miller-Rabin test)
- * @param n Integer to test (may be NULL)
- * @param certainty Number of rounds for probabilistic test
- * @return true if n is probably prime, false if composite or NULL
- * @since 1.0.0
- * 
- * @note Higher certainty values increase accuracy but take longer
+ * @brief Encode an integer as a CBOR data item (RFC 8949)
+ * @param big Integer to encode (must not be NULL)
+ * @param buf Destination buffer
+ * @param cap Capacity of buf in bytes
+ * @return Number of bytes written, or 0 if buf is too small
+ * @since 1.2.0
+ *
+ * Follows preferred serialization: values in [-2^64, 2^64) are written as
+ * major type 0/1 integers, everything else as a tag 2 (positive) or tag 3
+ * (negative, holding -1 - n) bignum whose byte string is filled directly
+ * from the limbs.
+ *
+ * @code
+ * uint8_t buf[64];
+ * di_int big = di_from_string("18446744073709551616", 10);  // 2^64
+ * size_t n = di_encode_cbor(big, buf, sizeof(buf));
+ * // buf = C2 49 01 00 00 00 00 00 00 00 00
+ * di_release(&big);
+ * @endcode
+ *
+ * @see di_decode_cbor() for the reverse operation
  */
-DI_DEF bool di_is_prime(di_int n, int certainty);
+DI_DEF size_t di_encode_cbor(di_int big, uint8_t* buf, size_t cap);
 
 /**
- * @brief Find next prime number >= n
- * @param n Starting integer (may be NULL)
- * @return New di_int with next prime >= n, or NULL on failure
- * @since 1.0.0
+ * @brief Decode a CBOR integer or bignum
+ * @param buf Source buffer (must not be NULL unless len is 0)
+ * @param len Number of bytes available in buf
+ * @param consumed Optional pointer to store the number of bytes read
+ * @return New di_int, or NULL if buf does not start with a complete
+ *         major type 0/1 integer or tag 2/3 bignum
+ * @since 1.2.0
+ *
+ * @note Bignums with leading zero bytes are accepted
  */
-DI_DEF di_int di_next_prime(di_int n);
-
-/** @} */ // end of prime_functions
+DI_DEF di_int di_decode_cbor(const uint8_t* buf, size_t len, size_t* consumed);
 
 /**
- * @defgroup random_functions Random Number Generation
- * @brief Functions for generating random integers
- * @{
+ * @brief Get number of bytes needed to DER encode an integer
+ * @param big Integer to query (must not be NULL)
+ * @return Number of bytes di_encode_der() will write, tag and length included
+ * @since 1.2.0
  */
+DI_DEF size_t di_der_size(di_int big);
 
 /**
- * @brief Generate random integer with specified bit length
- * @param bits Number of bits for the random integer
- * @return New di_int with random value, or NULL on failure
- * @since 1.0.0
- * 
- * @warning Not cryptographically secure - use proper CSPRNG for security
- * @note Returns zero if bits is 0
+ * @brief Encode an integer as an ASN.1 DER INTEGER
+ * @param big Integer to encode (must not be NULL)
+ * @param buf Destination buffer
+ * @param cap Capacity of buf in bytes
+ * @return Number of bytes written, or 0 if buf is too small
+ * @since 1.2.0
+ *
+ * Writes the tag (0x02), a definite length and the minimal big-endian
+ * two's complement content. Negative values are complemented while the
+ * bytes are written, without building a temporary.
+ *
+ * @see di_decode_der() for the reverse operation
  */
-DI_DEF di_int di_random(size_t bits);
+DI_DEF size_t di_encode_der(di_int big, uint8_t* buf, size_t cap);
 
 /**
- * @brief Generate random integer in range [min, max)
- * @param min Minimum value (inclusive, may be NULL)
- * @param max Maximum value (exclusive, may be NULL)
- * @return New di_int with random value in range, or NULL on failure
- * @since 1.0.0
- * 
- * @warning Not cryptographically secure - use proper CSPRNG for security
- * @note Returns NULL if min >= max
+ * @brief Decode an ASN.1 DER INTEGER
+ * @param buf Source buffer (must not be NULL unless len is 0)
+ * @param len Number of bytes available in buf
+ * @param consumed Optional pointer to store the number of bytes read
+ * @return New di_int, or NULL if buf does not start with a complete,
+ *         minimally encoded DER INTEGER
+ * @since 1.2.0
  */
-DI_DEF di_int di_random_range(di_int min, di_int max);
+DI_DEF di_int di_decode_der(const uint8_t* buf, size_t len, size_t* consumed);
 
-/** @} */ // end of random_functions
+/** @} */ // end of serialization
 
 /**
- * @defgroup overflow_detection Overflow Detection Helpers
- * @brief Helper functions for detecting fixed-size arithmetic overflow
+ * @defgroup views Read-only Views
+ * @brief Zero-copy access to limb arrays owned by someone else
  * @{
  */
 
 /**
- * @brief Add two int32_t values with overflow detection
- * @param a First operand
- * @param b Second operand
- * @param result Pointer to store result
- * @return true if addition overflowed, false if safe
- * @since 1.0.0
- * 
+ * @brief Read-only view of an integer stored in external memory
+ *
+ * A view is a plain value (pointer, limb count, sign) that borrows a
+ * little-endian array of di_limb_t. It owns nothing and has no reference
+ * count, so it is only valid while the memory it points to is. Views let
+ * integers that live in memory-mapped files or network buffers be
+ * compared, added, multiplied and printed without first being copied into
+ * a di_int.
+ *
  * @code
- * int32_t result;
- * if (di_add_overflow_int32(INT32_MAX, 1, &result)) {
- *     // Overflow occurred, use big integer arithmetic
- *     di_int a = di_from_int32(INT32_MAX);
- *     di_int b = di_from_int32(1);
- *     di_int sum = di_add(a, b);
- *     // ... handle big integer result
- * }
+ * const di_limb_t limbs[] = { 0, 1 };   // 2^DI_LIMB_BITS
+ * di_view v = di_view_from_limbs(limbs, 2, false);
+ * di_int one = di_one();
+ * di_int sum = di_view_add(v, di_view_of(one));
+ * di_release(&one);
+ * di_release(&sum);
  * @endcode
+ *
+ * @note Build views with di_view_of() or di_view_from_limbs()
+ * @since 1.2.0
  */
-DI_DEF bool di_add_overflow_int32(int32_t a, int32_t b, int32_t* result);
+typedef struct {
+    const di_limb_t* limbs;   ///< Least significant limb first (may be NULL if limb_count is 0)
+    size_t limb_count;        ///< Number of significant limbs
+    bool is_negative;         ///< Sign flag (never set for zero)
+} di_view;
 
 /**
- * @brief Subtract two int32_t values with overflow detection
- * @param a Minuend
- * @param b Subtrahend
- * @param result Pointer to store result
- * @return true if subtraction overflowed, false if safe
- * @since 1.0.0
+ * @brief Get a read-only view of an existing integer
+ * @param big Integer to view (must not be NULL)
+ * @return View borrowing big's limbs (valid until big is released)
+ * @since 1.2.0
  */
-DI_DEF bool di_subtract_overflow_int32(int32_t a, int32_t b, int32_t* result);
+DI_DEF di_view di_view_of(di_int big);
 
 /**
- * @brief Multiply two int32_t values with overflow detection
- * @param a First operand
- * @param b Second operand
- * @param result Pointer to store result
- * @return true if multiplication overflowed, false if safe
- * @since 1.0.0
+ * @brief Wrap an external limb array in a read-only view
+ * @param limbs Little-endian limb array (must not be NULL unless limb_count is 0)
+ * @param limb_count Number of limbs in the array
+ * @param is_negative Sign of the value
+ * @return View over the array with leading zero limbs trimmed
+ * @since 1.2.0
+ *
+ * @note Nothing is copied; the array must outlive the view
  */
-DI_DEF bool di_multiply_overflow_int32(int32_t a, int32_t b, int32_t* result);
+DI_DEF di_view di_view_from_limbs(const di_limb_t* limbs, size_t limb_count, bool is_negative);
 
 /**
- * @brief Add two int64_t values with overflow detection
+ * @brief Create a new integer holding a copy of a view's value
+ * @param view View to copy
+ * @return New di_int with the same value
+ * @since 1.2.0
+ */
+DI_DEF di_int di_from_view(di_view view);
+
+/**
+ * @brief Compare two views
+ * @param a First view
+ * @param b Second view
+ * @return -1 if a < b, 0 if a == b, 1 if a > b
+ * @since 1.2.0
+ *
+ * @see di_compare() for di_int operands
+ */
+DI_DEF int di_view_compare(di_view a, di_view b);
+
+/**
+ * @brief Add two views
  * @param a First operand
  * @param b Second operand
- * @param result Pointer to store result
- * @return true if addition overflowed, false if safe
- * @since 1.0.0
+ * @return New di_int with result of a + b
+ * @since 1.2.0
+ *
+ * @see di_add() for di_int operands
  */
-DI_DEF bool di_add_overflow_int64(int64_t a, int64_t b, int64_t* result);
+DI_DEF di_int di_view_add(di_view a, di_view b);
 
 /**
- * @brief Subtract two int64_t values with overflow detection
+ * @brief Subtract two views
  * @param a Minuend
  * @param b Subtrahend
- * @param result Pointer to store result
- * @return true if subtraction overflowed, false if safe
- * @since 1.0.0
+ * @return New di_int with result of a - b
+ * @since 1.2.0
+ *
+ * @see di_sub() for di_int operands
  */
-DI_DEF bool di_subtract_overflow_int64(int64_t a, int64_t b, int64_t* result);
+DI_DEF di_int di_view_sub(di_view a, di_view b);
 
 /**
- * @brief Multiply two int64_t values with overflow detection
+ * @brief Multiply two views
  * @param a First operand
  * @param b Second operand
- * @param result Pointer to store result
- * @return true if multiplication overflowed, false if safe
- * @since 1.0.0
+ * @return New di_int with result of a * b
+ * @since 1.2.0
+ *
+ * @see di_mul() for di_int operands
  */
-DI_DEF bool di_multiply_overflow_int64(int64_t a, int64_t b, int64_t* result);
+DI_DEF di_int di_view_mul(di_view a, di_view b);
 
-/** @} */ // end of overflow_detection
+/**
+ * @brief Convert a view to string representation
+ * @param view View to convert
+ * @param base Number base (2-36)
+ * @return Dynamically allocated string (caller must free), or NULL if base is not supported
+ * @since 1.2.0
+ *
+ * @see di_to_string() for di_int operands
+ */
+DI_DEF char* di_view_to_string(di_view view, int base);
+
+/**
+ * @brief Get bit length of a view
+ * @param view View to query
+ * @return Number of bits needed to represent the magnitude, or 0 for zero
+ * @since 1.2.0
+ *
+ * @see di_bit_length() for di_int operands
+ */
+DI_DEF size_t di_view_bit_length(di_view view);
+
+/** @} */ // end of views
+
+/**
+ * @defgroup fixed_integers Fixed-Capacity Integers
+ * @brief Integers in caller-provided storage, for code that must not allocate
+ *
+ * A di_fixed keeps its limbs in an array the caller owns: on the stack,
+ * in static memory or in a pool set up at init. Nothing here calls
+ * DI_MALLOC. Each operation writes its result into a destination
+ * di_fixed and returns false instead of growing it when the result needs
+ * more limbs than the destination holds; the destination is then left
+ * unchanged. Destinations may alias operands.
+ *
+ * Capacities are bounded by DI_FIXED_MAX_LIMBS at compile time, which
+ * sizes the scratch arrays the operations keep on the stack (about
+ * 2 * DI_FIXED_MAX_LIMBS limbs for di_fixed_mul()).
+ *
+ * @code
+ * DI_FIXED(a, 8);          // up to 8 limbs, no heap
+ * DI_FIXED(b, 8);
+ * di_fixed_set_int64(&a, INT64_MAX);
+ * di_fixed_set_int64(&b, 3);
+ * if (!di_fixed_mul(&a, &a, &b)) {
+ *     // would need more than 8 limbs
+ * }
+ * char text[64];
+ * di_fixed_to_string(&a, 10, text, sizeof(text));   // "27670116110564327421"
+ * @endcode
+ * @{
+ */
+
+/**
+ * @brief Integer whose limbs live in caller-provided storage
+ * @since 1.2.0
+ *
+ * @note Declare with DI_FIXED() or set up with di_fixed_init()
+ */
+typedef struct {
+    di_limb_t* limbs;     ///< Storage, least significant limb first
+    size_t limb_count;    ///< Number of significant limbs
+    size_t capacity;      ///< Limbs available in storage (at most DI_FIXED_MAX_LIMBS)
+    bool is_negative;     ///< Sign flag (never set for zero)
+} di_fixed;
+
+/**
+ * @brief Declare a zero-valued di_fixed named name with max_limbs limbs of storage
+ *
+ * Works at block or file scope; the storage is an array named name_limbs.
+ * A max_limbs above DI_FIXED_MAX_LIMBS fails to compile.
+ */
+#define DI_FIXED(name, max_limbs)                                                      \
+    di_limb_t name##_limbs[(max_limbs) > 0 && (max_limbs) <= DI_FIXED_MAX_LIMBS ? (max_limbs) : -1]; \
+    di_fixed name = { name##_limbs, 0, (max_limbs), false }
+
+/**
+ * @brief Set up a di_fixed over existing storage, with value zero
+ * @param x Integer to set up (must not be NULL)
+ * @param limbs Storage of at least capacity limbs (must not be NULL)
+ * @param capacity Limbs in storage, from 1 to DI_FIXED_MAX_LIMBS
+ * @since 1.2.0
+ */
+DI_DEF void di_fixed_init(di_fixed* x, di_limb_t* limbs, size_t capacity);
+
+/**
+ * @brief Store an int64_t value
+ * @param r Destination
+ * @param value Value
+ * @return true on success, false if r is too small
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_set_int64(di_fixed* r, int64_t value);
+
+/**
+ * @brief Read the value as int64_t
+ * @param x Integer
+ * @param result Receives the value
+ * @return true if it fits, false otherwise
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_to_int64(const di_fixed* x, int64_t* result);
+
+/**
+ * @brief Store a copy of a view (or of a di_int, through di_view_of())
+ * @param r Destination
+ * @param view Value to copy
+ * @return true on success, false if r is too small
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_set_view(di_fixed* r, di_view view);
+
+/**
+ * @brief Get a read-only view of a fixed integer
+ * @param x Integer
+ * @return View borrowing x's storage
+ * @since 1.2.0
+ *
+ * Use it to pass the value to the di_view functions, or to di_from_view()
+ * to move it onto the heap.
+ */
+DI_DEF di_view di_fixed_view(const di_fixed* x);
+
+/**
+ * @brief Compare two fixed integers
+ * @param a First integer
+ * @param b Second integer
+ * @return -1 if a < b, 0 if equal, 1 if a > b
+ * @since 1.2.0
+ */
+DI_DEF int di_fixed_compare(const di_fixed* a, const di_fixed* b);
+
+/**
+ * @brief r = a + b
+ * @param r Destination
+ * @param a First operand
+ * @param b Second operand
+ * @return true on success, false if r is too small (r unchanged)
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_add(di_fixed* r, const di_fixed* a, const di_fixed* b);
+
+/**
+ * @brief r = a - b
+ * @param r Destination
+ * @param a Minuend
+ * @param b Subtrahend
+ * @return true on success, false if r is too small (r unchanged)
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_sub(di_fixed* r, const di_fixed* a, const di_fixed* b);
+
+/**
+ * @brief r = a * b
+ * @param r Destination
+ * @param a First operand
+ * @param b Second operand
+ * @return true on success, false if r is too small (r unchanged)
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_mul(di_fixed* r, const di_fixed* a, const di_fixed* b);
+
+/**
+ * @brief r = a shifted left by bits, like di_shift_left()
+ * @param r Destination
+ * @param a Operand
+ * @param bits Shift count
+ * @return true on success, false if r is too small (r unchanged)
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_shift_left(di_fixed* r, const di_fixed* a, size_t bits);
+
+/**
+ * @brief r = a shifted right by bits, like di_shift_right()
+ * @param r Destination
+ * @param a Operand
+ * @param bits Shift count
+ * @return true on success, false if r is too small (r unchanged)
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_shift_right(di_fixed* r, const di_fixed* a, size_t bits);
+
+/**
+ * @brief Parse a string into a fixed integer
+ * @param r Destination
+ * @param str Digits with optional leading whitespace and sign
+ * @param base Base from 2 to 36
+ * @return true on success; false if the string has no digits or does
+ *         not fit r (r unchanged)
+ *
+ * Like di_from_string(), parsing stops at the first character that is not
+ * a digit in base.
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_from_string(di_fixed* r, const char* str, int base);
+
+/**
+ * @brief Format a fixed integer into a caller buffer
+ * @param x Integer
+ * @param base Base from 2 to 36
+ * @param buf Output buffer
+ * @param size Size of buf in bytes, including the terminating NUL
+ * @return true on success, false if buf is too small
+ * @since 1.2.0
+ */
+DI_DEF bool di_fixed_to_string(const di_fixed* x, int base, char* buf, size_t size);
+
+/** @} */ // end of fixed_integers
+
+/**
+ * @defgroup column_storage Columnar File Storage
+ * @brief Persist large arrays of integers and reload them as zero-copy views
+ * @{
+ */
+
+/**
+ * @brief Handle for an opened integer column file
+ *
+ * The file holds a fixed header, an offset index (count + 1 limb offsets),
+ * a sign bitmap and one contiguous limb payload. di_column_open() maps the
+ * file into memory, so opening is O(1) no matter how many integers it
+ * holds and each entry is served as a di_view into the mapping.
+ *
+ * @note Files are written in the host's limb size and byte order and are
+ *       rejected by hosts that differ
+ * @since 1.2.0
+ */
+typedef struct di_column_internal* di_column;
+
+/**
+ * @brief Write an array of integers to a column file
+ * @param path File to create or truncate (must not be NULL)
+ * @param values Array of integers (none may be NULL)
+ * @param count Number of integers in values
+ * @return true on success, false if the file could not be written
+ * @since 1.2.0
+ *
+ * @code
+ * di_int values[3] = { di_from_int32(1), di_from_int32(-2), di_factorial(50) };
+ * if (di_column_write("values.dic", values, 3)) {
+ *     di_column col = di_column_open("values.dic");
+ *     char* str = di_view_to_string(di_column_get(col, 2), 10);  // 50!
+ *     free(str);
+ *     di_column_close(&col);
+ * }
+ * @endcode
+ *
+ * @see di_column_open() for reading the file back
+ */
+DI_DEF bool di_column_write(const char* path, const di_int* values, size_t count);
+
+/**
+ * @brief Open a column file for zero-copy access
+ * @param path File to open (must not be NULL)
+ * @return New column handle, or NULL if the file is missing or not a valid
+ *         column file for this host
+ * @since 1.2.0
+ *
+ * Uses mmap() where available. Define DI_NO_MMAP (or build for a platform
+ * without it) to read the file into one heap block instead.
+ */
+DI_DEF di_column di_column_open(const char* path);
+
+/**
+ * @brief Get number of integers stored in a column
+ * @param col Column to query (must not be NULL)
+ * @return Number of entries
+ * @since 1.2.0
+ */
+DI_DEF size_t di_column_count(di_column col);
+
+/**
+ * @brief Get a read-only view of one entry of a column
+ * @param col Column to read (must not be NULL)
+ * @param index Entry index (must be < di_column_count())
+ * @return View into the column's memory, valid until di_column_close();
+ *         a view with NULL limbs (reading as zero) if the entry's offsets
+ *         are corrupt
+ * @since 1.2.0
+ *
+ * Checks the entry's two offsets against each other and the payload, so a
+ * damaged file never leads to reads outside it.
+ */
+DI_DEF di_view di_column_get(di_column col, size_t index);
+
+/**
+ * @brief Close a column and unmap its memory
+ * @param col Pointer to column handle (may be NULL or point to NULL)
+ * @since 1.2.0
+ *
+ * @note Always sets the handle to NULL; views obtained from the column
+ *       become invalid
+ */
+DI_DEF void di_column_close(di_column* col);
+
+/** @} */ // end of column_storage
+
+/**
+ * @defgroup utility_functions Utility Functions
+ * @brief Utility functions for querying integer properties
+ * @{
+ */
+
+/**
+ * @brief Get bit length of integer (number of bits needed to represent)
+ * @param big Integer to query (may be NULL)
+ * @return Number of bits needed to represent integer, or 0 if NULL or zero
+ * @since 1.0.0
+ */
+DI_DEF size_t di_bit_length(di_int big);
+
+/**
+ * @brief Get number of limbs used by integer
+ * @param big Integer to query (may be NULL)
+ * @return Number of limbs in use, or 0 if NULL
+ * @since 1.0.0
+ * 
+ * @note Primarily for debugging and internal use
+ */
+DI_DEF size_t di_limb_count(di_int big);
+
+/**
+ * @brief Reserve capacity for an integer (performance optimization)
+ * @param big Integer to resize (may be NULL)
+ * @param capacity Number of limbs to reserve capacity for
+ * @return true if successful, false on allocation failure
+ * @since 1.0.0
+ * 
+ * @code
+ * di_int big = di_from_int32(0);
+ * 
+ * // Pre-allocate space for large operations to avoid repeated allocations
+ * if (di_reserve(big, 100)) {
+ *     // Now operations won't need to reallocate until 100 limbs are needed
+ *     for (int i = 0; i < 1000; i++) {
+ *         di_int temp = di_mul_i32(big, 2);
+ *         di_release(&big);
+ *         big = temp;
+ *     }
+ * }
+ * di_release(&big);
+ * @endcode
+ * 
+ * @note This is purely a performance optimization - integers work without it
+ * @note Similar to std::vector::reserve() in C++
+ * @see di_limb_count() for getting current limb count
+ */
+DI_DEF bool di_reserve(di_int big, size_t capacity);
+
+/** @} */ // end of utility_functions
+
+/**
+ * @defgroup advanced_math Advanced Mathematical Operations
+ * @brief Advanced mathematical functions for arbitrary precision integers
+ * @{
+ */
+
+/**
+ * @brief Modular exponentiation: (base^exp) mod mod
+ * @param base Base integer (may be NULL)
+ * @param exp Exponent integer (may be NULL)
+ * @param mod Modulus integer (may be NULL)
+ * @return New di_int with result of (base^exp) mod mod, or NULL on failure
+ * @since 1.0.0
+ * 
+ * @note Returns NULL if mod is zero or one
+ * @note Uses binary exponentiation for efficiency
+ * @note Odd moduli of DI_IFMA_MONT_THRESHOLD or more limbs use an AVX-512
+ *       IFMA Montgomery kernel when the CPU supports it
+ */
+DI_DEF di_int di_mod_pow(di_int base, di_int exp, di_int mod);
+
+/**
+ * @brief Greatest Common Divisor using Euclidean algorithm
+ * @param a First integer (may be NULL)
+ * @param b Second integer (may be NULL)
+ * @return New di_int with GCD of |a| and |b|, or NULL on failure
+ * @since 1.0.0
+ * 
+ * @see di_lcm() for Least Common Multiple
+ * @see di_extended_gcd() for extended Euclidean algorithm
+ */
+DI_DEF di_int di_gcd(di_int a, di_int b);
+
+/**
+ * @brief Least Common Multiple
+ * @param a First integer (may be NULL)
+ * @param b Second integer (may be NULL)
+ * @return New di_int with LCM of a and b, or NULL on failure
+ * @since 1.0.0
+ * 
+ * @note Uses identity: lcm(a,b) = |a*b| / gcd(a,b)
+ * @see di_gcd() for Greatest Common Divisor
+ */
+DI_DEF di_int di_lcm(di_int a, di_int b);
+
+/**
+ * @brief Extended Euclidean Algorithm
+ * @param a First integer (may be NULL)
+ * @param b Second integer (may be NULL)
+ * @param x Pointer to store coefficient x
+ * @param y Pointer to store coefficient y
+ * @return GCD of a and b, with coefficients such that ax + by = gcd(a,b)
+ * @since 1.0.0
+ * 
+ * @note Sets *x and *y to coefficients satisfying the Bezout identity
+ */
+DI_DEF di_int di_extended_gcd(di_int a, di_int b, di_int* x, di_int* y);
+
+/**
+ * @brief Integer square root using Newton's method
+ * @param n Integer to find square root of (may be NULL)
+ * @return New di_int with floor(sqrt(n)), or NULL on failure
+ * @since 1.0.0
+ * 
+ * @note Returns NULL for negative inputs
+ */
+DI_DEF di_int di_sqrt(di_int n);
+
+/**
+ * @brief Calculate factorial
+ * @param n Non-negative integer
+ * @return New di_int with n! (n factorial), or NULL on failure
+ * @since 1.0.0
+ * 
+ * Multiplies the odd parts of 2..n with a balanced product tree and
+ * applies the factors of two as one shift. With DI_THREADS and
+ * di_set_threads() the subtrees are multiplied in parallel; the result
+ * is identical either way.
+ *
+ * @code
+ * di_int fact5 = di_factorial(5);  // 120
+ * di_int fact10 = di_factorial(10); // 3628800
+ * @endcode
+ */
+DI_DEF di_int di_factorial(uint32_t n);
+
+/**
+ * @brief Multiply many integers together
+ * @param values Array of integers (must not be NULL unless count is 0)
+ * @param count Number of integers
+ * @return New di_int with the product (1 for an empty array)
+ * @since 1.2.0
+ *
+ * Uses a balanced product tree, which is much faster than multiplying
+ * left to right when the terms are similar in size. Subtrees run in
+ * parallel as for di_factorial().
+ */
+DI_DEF di_int di_product(const di_int* values, size_t count);
+
+/**
+ * @brief Calculate the binomial coefficient C(n, k)
+ * @param n Number of items
+ * @param k Number chosen
+ * @return New di_int with n! / (k! (n-k)!), zero if k > n
+ * @since 1.2.0
+ *
+ * Builds the result from its prime factorisation (Kummer's theorem), so
+ * no big-integer division is needed. Sieving the primes up to n takes
+ * n/16 bytes of temporary memory.
+ *
+ * @code
+ * di_int c = di_binomial(100, 50);  // 100891344545564193334812497256
+ * @endcode
+ */
+DI_DEF di_int di_binomial(uint32_t n, uint32_t k);
+
+/** @} */ // end of advanced_math
+
+/**
+ * @defgroup prime_functions Prime Number Functions
+ * @brief Functions for working with prime numbers
+ * @{
+ */
+
+/**
+ * @brief Test if integer is prime (Miller-Rabin test)
+ * @param n Integer to test (may be NULL)
+ * @param certainty Number of rounds for probabilistic test
+ * @return true if n is probably prime, false if composite or NULL
+ * @since 1.0.0
+ * 
+ * Trial division by the primes below 256 settles small n exactly. Below
+ * 2^81 (under the 3.3 * 10^24 bound of the 13 smallest prime bases)
+ * Miller-Rabin runs with those 13 bases whatever certainty is, so the
+ * answer is exact. Larger n get 'certainty' rounds: base 2, then random
+ * bases from a private generator seeded from n and a per-process value,
+ * so a composite chosen in advance still passes with probability at most
+ * about 4^-(certainty - 1). The default generator (di_rng_default()) is
+ * neither used nor advanced.
+ *
+ * @note Higher certainty values increase accuracy but take longer
+ */
+DI_DEF bool di_is_prime(di_int n, int certainty);
+
+/**
+ * @brief Find next prime number >= n
+ * @param n Starting integer (may be NULL)
+ * @return New di_int with next prime >= n, or NULL on failure
+ * @since 1.0.0
+ */
+DI_DEF di_int di_next_prime(di_int n);
+
+/** @} */ // end of prime_functions
+
+/**
+ * @defgroup random_functions Random Number Generation
+ * @brief Functions for generating random integers
+ * @{
+ */
+
+/**
+ * @brief Random number generator state
+ *
+ * Every random function draws from an explicit generator, so threads never
+ * share hidden state. Keep one di_rng per thread (or protect it with your
+ * own lock), seed it with di_rng_seed(), and pass it to the *_r functions.
+ * Passing NULL selects the calling thread's default generator.
+ *
+ * @code
+ * di_rng rng;
+ * di_rng_seed(&rng, 12345);
+ * di_int a = di_random_r(256, &rng);   // reproducible for a given seed
+ * di_int b = di_random(256);           // thread-local default generator
+ * di_release(&a);
+ * di_release(&b);
+ * @endcode
+ *
+ * A generator can instead be switched to an entropy source with
+ * di_rng_secure() (operating system CSPRNG) or di_rng_set_entropy()
+ * (caller-supplied, e.g. a hardware TRNG on a microcontroller). Use one
+ * of those for keys, nonces and blinding factors.
+ *
+ * @warning Seeded generators are not cryptographically secure
+ * @since 1.2.0
+ */
+typedef struct {
+    uint64_t s[4];           ///< xoshiro256** state (use di_rng_seed() to set)
+    bool (*entropy)(void* ctx, void* buf, size_t size); ///< Entropy source, or NULL
+    void* entropy_ctx;       ///< Context passed to the entropy source
+} di_rng;
+
+/**
+ * @brief Entropy source callback
+ * @param ctx Context pointer given to di_rng_set_entropy()
+ * @param buf Buffer to fill
+ * @param size Number of bytes to write
+ * @return true if all size bytes were written, false on failure
+ * @since 1.2.0
+ */
+typedef bool (*di_entropy_fn)(void* ctx, void* buf, size_t size);
+
+/**
+ * @brief Seed a random number generator
+ * @param rng Generator to seed (must not be NULL)
+ * @param seed Seed value; equal seeds produce equal sequences
+ * @since 1.2.0
+ *
+ * The 64-bit seed is expanded into the 256-bit xoshiro256** state with
+ * splitmix64, so any seed (including 0) is fine. Seeding detaches any
+ * entropy source.
+ */
+DI_DEF void di_rng_seed(di_rng* rng, uint64_t seed);
+
+/**
+ * @brief Switch a generator to the operating system's CSPRNG
+ * @param rng Generator to configure (must not be NULL)
+ * @return true if the platform has an OS entropy source, false otherwise
+ * @since 1.2.0
+ *
+ * Uses getrandom() on Linux and /dev/urandom on other Unix systems. On
+ * platforms without either, use di_rng_set_entropy() instead; the
+ * generator is left unchanged when false is returned.
+ *
+ * @code
+ * di_rng rng;
+ * if (!di_rng_secure(&rng)) abort();
+ * di_int key = di_random_r(256, &rng);
+ * @endcode
+ */
+DI_DEF bool di_rng_secure(di_rng* rng);
+
+/**
+ * @brief Attach a caller-supplied entropy source to a generator
+ * @param rng Generator to configure (must not be NULL)
+ * @param fn Entropy callback, or NULL to go back to the seeded stream
+ * @param ctx Context pointer passed to fn
+ * @since 1.2.0
+ *
+ * Every random byte drawn from rng then comes from fn, in as few calls as
+ * possible: a whole limb array or di_random_fill() buffer is requested at
+ * once.
+ */
+DI_DEF void di_rng_set_entropy(di_rng* rng, di_entropy_fn fn, void* ctx);
+
+/**
+ * @brief Advance a generator by 2^128 steps
+ * @param rng Generator to advance (must not be NULL)
+ * @since 1.2.0
+ *
+ * Gives non-overlapping streams for parallel work: copy a seeded
+ * generator and jump each copy a different number of times.
+ *
+ * @code
+ * di_rng workers[4];
+ * di_rng_seed(&workers[0], 42);
+ * for (int i = 1; i < 4; i++) {
+ *     workers[i] = workers[i - 1];
+ *     di_rng_jump(&workers[i]);
+ * }
+ * @endcode
+ */
+DI_DEF void di_rng_jump(di_rng* rng);
+
+/**
+ * @brief Fill a buffer with random bytes
+ * @param rng Generator to draw from, or NULL for the thread's default
+ * @param buf Buffer to fill (must not be NULL unless size is 0)
+ * @param size Number of bytes to write
+ * @return true on success, false if the generator's entropy source failed
+ * @since 1.2.0
+ *
+ * Writes 64 bits per generator step, so filling limb arrays or Monte
+ * Carlo sample buffers costs one step per 8 bytes. Generators with an
+ * entropy source pass the whole buffer to it.
+ */
+DI_DEF bool di_random_fill(di_rng* rng, void* buf, size_t size);
+
+/**
+ * @brief Get the calling thread's default random number generator
+ * @return Pointer to a thread-local generator, valid for the thread's lifetime
+ * @since 1.2.0
+ *
+ * The default generator is seeded lazily from its own address, so each
+ * thread gets a distinct stream. Seed it explicitly for reproducible runs.
+ * With DI_SECURE_RANDOM defined it reads the OS entropy source instead
+ * (see di_rng_secure()).
+ */
+DI_DEF di_rng* di_rng_default(void);
+
+/**
+ * @brief Generate random integer with specified bit length
+ * @param bits Number of bits for the random integer
+ * @return New di_int with random value, or NULL on failure
+ * @since 1.0.0
+ * 
+ * @warning Not cryptographically secure unless built with DI_SECURE_RANDOM
+ * @note Returns zero if bits is 0
+ * @note Draws from the calling thread's default generator
+ * @see di_random_r() for an explicit generator
+ */
+DI_DEF di_int di_random(size_t bits);
+
+/**
+ * @brief Generate random integer with specified bit length from a given generator
+ * @param bits Number of bits for the random integer
+ * @param rng Generator to draw from, or NULL for the thread's default
+ * @return New non-negative di_int below 2^bits, or NULL if the entropy
+ *         source failed
+ * @since 1.2.0
+ *
+ * @note Cryptographically secure when rng uses an entropy source
+ */
+DI_DEF di_int di_random_r(size_t bits, di_rng* rng);
+
+/**
+ * @brief Generate random integer in range [min, max)
+ * @param min Minimum value (inclusive, may be NULL)
+ * @param max Maximum value (exclusive, may be NULL)
+ * @return New di_int with random value in range, or NULL on failure
+ * @since 1.0.0
+ * 
+ * @warning Not cryptographically secure unless built with DI_SECURE_RANDOM
+ * @note Every value in range is equally likely (rejection sampling)
+ * @note Draws from the calling thread's default generator
+ * @see di_random_range_r() for an explicit generator
+ */
+DI_DEF di_int di_random_range(di_int min, di_int max);
+
+/**
+ * @brief Generate random integer in range [min, max) from a given generator
+ * @param min Minimum value (inclusive, must not be NULL)
+ * @param max Maximum value (exclusive, must not be NULL)
+ * @param rng Generator to draw from, or NULL for the thread's default
+ * @return New di_int with random value in range, or NULL if the entropy
+ *         source failed
+ * @since 1.2.0
+ *
+ * Draws bit_length(max - min - 1) random bits and retries while the
+ * value is out of range, so the result is uniform and at most half of
+ * the draws are rejected on average.
+ *
+ * @note Cryptographically secure when rng uses an entropy source
+ */
+DI_DEF di_int di_random_range_r(di_int min, di_int max, di_rng* rng);
+
+/**
+ * @brief Generate a random probable prime with an exact bit length
+ * @param bits Bit length of the result (at least 2)
+ * @param rng Generator to draw candidates from, or NULL for the thread's default
+ * @return New prime p with 2^(bits-1) <= p < 2^bits, or NULL if the entropy
+ *         source failed
+ * @since 1.2.0
+ *
+ * Each random candidate is followed by a window of odd successors that
+ * is sieved by the primes below 16384 in one pass; only survivors get
+ * Miller-Rabin rounds (base 2, then random bases). Candidates come from
+ * rng, so pass a generator from di_rng_secure() when generating keys.
+ *
+ * @code
+ * di_rng rng;
+ * di_rng_secure(&rng);
+ * di_int p = di_random_prime(1024, &rng);
+ * @endcode
+ */
+DI_DEF di_int di_random_prime(size_t bits, di_rng* rng);
+
+/**
+ * @brief Generate a random safe prime p = 2q + 1 with q prime
+ * @param bits Bit length of p (at least 3)
+ * @param rng Generator to draw candidates from, or NULL for the thread's default
+ * @return New safe prime with exactly bits bits, or NULL if the entropy
+ *         source failed
+ * @since 1.2.0
+ *
+ * The sieve rejects candidates where either p or q has a small factor,
+ * which removes most of the cost of searching for Diffie-Hellman groups.
+ * The result is always 3 mod 4.
+ */
+DI_DEF di_int di_random_safe_prime(size_t bits, di_rng* rng);
+
+/**
+ * @brief di_random_prime() searching with several threads
+ * @param bits Bit length of the result (at least 2)
+ * @param rng Generator to draw candidates from, or NULL for the calling thread's default
+ * @param threads Number of threads to search with, including the caller
+ * @return New prime with exactly bits bits, or NULL if the entropy source failed
+ * @since 1.2.0
+ *
+ * Workers take candidates from rng under a lock and the first prime found
+ * wins, so the result is not reproducible from a seed. Without DI_THREADS
+ * this runs on the calling thread only.
+ */
+DI_DEF di_int di_random_prime_mt(size_t bits, di_rng* rng, int threads);
+
+/**
+ * @brief di_random_safe_prime() searching with several threads
+ * @param bits Bit length of p (at least 3)
+ * @param rng Generator to draw candidates from, or NULL for the calling thread's default
+ * @param threads Number of threads to search with, including the caller
+ * @return New safe prime with exactly bits bits, or NULL if the entropy source failed
+ * @since 1.2.0
+ *
+ * @see di_random_prime_mt()
+ */
+DI_DEF di_int di_random_safe_prime_mt(size_t bits, di_rng* rng, int threads);
+
+/** @} */ // end of random_functions
+
+/**
+ * @defgroup threading Parallelism
+ * @brief Control over worker threads used inside library calls
+ * @{
+ */
+
+/**
+ * @brief Set how many threads large operations may use
+ * @param threads Thread count including the caller; values below 1 mean 1
+ * @since 1.2.0
+ *
+ * Work runs on a shared pool of threads - 1 workers that is started on
+ * first use; callers waiting for results run queued tasks too. di_mul()
+ * splits the longer operand across the pool once the shorter one reaches
+ * DI_MUL_THREAD_THRESHOLD limbs, and di_factorial(), di_product() and
+ * di_binomial() multiply product-tree subtrees in parallel. Smaller work
+ * always runs serially on the calling thread, so latency-sensitive
+ * callers are unaffected. The setting is process-wide and defaults to 1.
+ *
+ * @note Has no effect unless built with DI_THREADS
+ * @warning Changing the count stops the pool; do not call this while
+ *          other threads are inside the library
+ */
+DI_DEF void di_set_threads(int threads);
+
+/**
+ * @brief Get the thread count set by di_set_threads()
+ * @return Current thread count (always 1 without DI_THREADS)
+ * @since 1.2.0
+ */
+DI_DEF int di_get_threads(void);
+
+/** @} */ // end of threading
+
+/**
+ * @defgroup cpu_dispatch CPU Dispatch
+ * @brief Choice of limb kernels for the running CPU
+ *
+ * Carry chains, single-limb multiply and divide, basecase multiplication
+ * and the bitwise loops run through one table of kernels picked on first
+ * use: "ifma", "avx512" or "avx2" on x86, "neon" on AArch64, "wide"
+ * (pairs of 32-bit limbs in 64-bit words) on other 64-bit targets, and
+ * "scalar" everywhere. Setting the DI_CPU environment variable to one of
+ * these names before the first call selects that set instead, which is
+ * meant for benchmarking; all sets give identical results.
+ * @{
+ */
+
+/**
+ * @brief Name of the kernel set in use
+ * @return Static string such as "avx512" or "scalar"
+ * @since 1.2.0
+ */
+DI_DEF const char* di_get_cpu(void);
+
+/**
+ * @brief Switch to a named kernel set
+ * @param name Kernel set name, or NULL for the best one the CPU supports
+ * @return true on success; false if the set is unknown or the CPU (or
+ *         the build) cannot run it, leaving the current set in place
+ * @since 1.2.0
+ *
+ * @note The setting is process-wide and overrides DI_CPU
+ */
+DI_DEF bool di_set_cpu(const char* name);
+
+/** @} */ // end of cpu_dispatch
+
+/**
+ * @defgroup statistics Statistics
+ * @brief Allocation and operation counters (DI_STATS builds)
+ *
+ * With DI_STATS defined, every thread keeps its own counters of the
+ * allocator calls made for integers and of calls into the main
+ * operations; di_stats_get() adds them up. Without DI_STATS nothing is
+ * counted and the functions below report zeros.
+ * @{
+ */
+
+/** @brief Operations counted in di_stats.ops */
+typedef enum {
+    DI_STATS_ADD,           ///< di_add(), di_add_batch()
+    DI_STATS_SUB,           ///< di_sub()
+    DI_STATS_MUL,           ///< di_mul(), di_mul_batch()
+    DI_STATS_DIV,           ///< di_div()
+    DI_STATS_MOD,           ///< di_mod()
+    DI_STATS_MOD_POW,       ///< di_mod_pow()
+    DI_STATS_SHIFT,         ///< di_shift_left(), di_shift_right()
+    DI_STATS_BITWISE,       ///< di_and(), di_or(), di_xor(), di_not()
+    DI_STATS_TO_STRING,     ///< di_to_string()
+    DI_STATS_FROM_STRING,   ///< di_from_string()
+    DI_STATS_POW,           ///< di_pow()
+    DI_STATS_GCD,           ///< di_gcd(), di_lcm(), di_extended_gcd()
+    DI_STATS_SQRT,          ///< di_sqrt()
+    DI_STATS_PRODUCT,       ///< di_product()
+    DI_STATS_FACTORIAL,     ///< di_factorial(), di_binomial()
+    DI_STATS_PRIME,         ///< di_is_prime(), di_next_prime()
+    DI_STATS_RANDOM_PRIME,  ///< di_random_prime(), di_random_safe_prime() and the _mt forms
+    DI_STATS_EXPORT,        ///< di_export(), di_encode_varint(), di_encode_cbor(), di_encode_der()
+    DI_STATS_IMPORT,        ///< di_import(), di_decode_varint(), di_decode_cbor(), di_decode_der()
+    DI_STATS_BATCH,         ///< di_add_batch(), di_mul_batch(), di_cmp_batch() as whole calls
+    DI_STATS_VEC,           ///< di_vec_add(), di_vec_sub(), di_vec_mul_i32(), di_vec_cmp()
+    DI_STATS_OPS            ///< Number of counted operations
+} di_stats_op;
+
+/** @brief Counter snapshot filled in by di_stats_get() */
+typedef struct {
+    uint64_t allocs;        ///< DI_MALLOC() calls for integer headers and limbs
+    uint64_t frees;         ///< DI_FREE() calls for the same
+    uint64_t reallocs;      ///< Limb arrays grown in place or moved
+    uint64_t bytes;         ///< Bytes requested by those allocs and reallocs
+    uint64_t live_ints;     ///< Integers not yet released
+    uint64_t peak_ints;     ///< Most integers alive at once
+    uint64_t live_limbs;    ///< Limb capacity held by live integers
+    uint64_t peak_limbs;    ///< Most limb capacity held at once
+    struct {
+        uint64_t calls;     ///< Calls, including those the library makes itself
+        uint64_t limbs;     ///< Operand limbs passed in (result limbs for di_from_string(),
+                            ///< the decoders, di_factorial(), di_binomial() and the prime generators)
+    } ops[DI_STATS_OPS];
+} di_stats;
+
+/**
+ * @brief Read the counters, summed over all threads
+ * @param out Receives the counters (must not be NULL)
+ * @return true if built with DI_STATS; false (and all zeros) otherwise
+ * @since 1.2.0
+ *
+ * Counts include calls the library makes internally; di_mod(), for
+ * example, also counts a di_div(), a di_mul() and a di_sub().
+ *
+ * @code
+ * di_stats st;
+ * di_stats_get(&st);
+ * printf("%llu allocs, %llu muls\n", (unsigned long long)st.allocs,
+ *        (unsigned long long)st.ops[DI_STATS_MUL].calls);
+ * @endcode
+ *
+ * @note Peaks are tracked per thread and added up, so they are exact for
+ *       one thread and an upper bound when integers move between threads
+ */
+DI_DEF bool di_stats_get(di_stats* out);
+
+/**
+ * @brief Zero the counters
+ * @since 1.2.0
+ *
+ * Live counts are kept, since those integers still exist; peaks restart
+ * from them.
+ *
+ * @note Counts made by other threads while this runs may survive it
+ */
+DI_DEF void di_stats_reset(void);
+
+/**
+ * @brief Name of a counted operation
+ * @param op Operation index below DI_STATS_OPS
+ * @return Static string such as "mul", or "unknown"
+ * @since 1.2.0
+ */
+DI_DEF const char* di_stats_op_name(di_stats_op op);
+
+/** @} */ // end of statistics
+
+/**
+ * @defgroup tracing Tracing
+ * @brief Latency histograms per operation and operand size (DI_TRACE builds)
+ *
+ * The operations listed in di_stats_op are wrapped in two hooks in the
+ * implementation:
+ *
+ * @code
+ * DI_TRACE_BEGIN(op, a_limbs, b_limbs);   // on entry, after argument checks
+ * ...
+ * DI_TRACE_END();                         // just before returning
+ * @endcode
+ *
+ * Both run in the same scope, so BEGIN may declare a local that END reads.
+ * Define both before the implementation include to feed another profiler.
+ * Otherwise DI_TRACE selects the built-in recorder, which times each call
+ * with DI_TRACE_CLOCK() (nanoseconds, CLOCK_MONOTONIC by default) into a
+ * histogram for the operation and size bucket. With neither, the hooks
+ * expand to nothing.
+ *
+ * Size bucket k holds calls whose a_limbs + b_limbs has bit length k:
+ * bucket 0 is 0 limbs, bucket 1 is 1 limb, bucket 2 is 2-3 limbs and so
+ * on; the last bucket takes everything larger. For di_from_string() and
+ * the decoders the size is the input length in characters or bytes, for
+ * di_factorial() and di_binomial() it is n, and for the prime generators
+ * the requested size in limbs. Latency bins follow the same scheme in
+ * nanoseconds. Nested calls are timed too: a di_mod() also records the
+ * di_div(), di_mul() and di_sub() it makes.
+ *
+ * The rest of the API is not hooked. The _i32 forms and the batch
+ * varint codecs are recorded through the call they forward to, and the
+ * di_view functions are what the hooked wrappers call, so hooking them
+ * would record every call twice. Construction, conversion, comparison
+ * and accessors, di_fixed, di_num, di_random() and the column functions
+ * are either constant time or a single pass over the limbs, where a
+ * clock read would cost as much as the work it measures.
+ * @{
+ */
+
+#define DI_TRACE_SIZE_BUCKETS 24   ///< Operand size buckets (last: 2^22 limbs and up)
+#define DI_TRACE_LATENCY_BINS 32   ///< Latency bins (last: 2^30 ns and up)
+
+/** @brief Latency histogram filled in by di_trace_get() */
+typedef struct {
+    uint64_t count;                         ///< Calls recorded
+    uint64_t total_ns;                      ///< Sum of their latencies
+    uint64_t min_ns;                        ///< Fastest call (0 if none)
+    uint64_t max_ns;                        ///< Slowest call
+    uint64_t bins[DI_TRACE_LATENCY_BINS];   ///< Calls per latency bin
+} di_trace_hist;
+
+/**
+ * @brief Read one histogram, summed over all threads
+ * @param op Operation
+ * @param size_bucket Size bucket below DI_TRACE_SIZE_BUCKETS
+ * @param out Receives the histogram (must not be NULL)
+ * @return true if the built-in recorder is compiled in; false (and all
+ *         zeros) otherwise
+ * @since 1.2.0
+ */
+DI_DEF bool di_trace_get(di_stats_op op, int size_bucket, di_trace_hist* out);
+
+/**
+ * @brief Clear all histograms
+ * @since 1.2.0
+ *
+ * @note Calls recorded by other threads while this runs may survive it
+ */
+DI_DEF void di_trace_reset(void);
+
+/**
+ * @brief Line sink for di_trace_dump()
+ * @param ctx Context pointer given to di_trace_dump()
+ * @param line One line of text including its newline
+ */
+typedef void (*di_trace_write_fn)(void* ctx, const char* line);
+
+/**
+ * @brief Write every non-empty histogram as CSV
+ * @param write Receives each line, or NULL for stderr
+ * @param ctx Passed through to write
+ * @return true if the built-in recorder is compiled in; false (nothing
+ *         written) otherwise
+ * @since 1.2.0
+ *
+ * Columns are op, size_min, size_max, count, mean_ns, min_ns, p50_ns,
+ * p90_ns, p99_ns and max_ns. Percentiles are the upper edge of the bin
+ * they fall in, clamped to the observed range.
+ *
+ * @code
+ * static void to_file(void* ctx, const char* line) { fputs(line, (FILE*)ctx); }
+ * ...
+ * di_trace_dump(to_file, profile_file);
+ * @endcode
+ */
+DI_DEF bool di_trace_dump(di_trace_write_fn write, void* ctx);
+
+/** @} */ // end of tracing
+
+/**
+ * @defgroup batch_operations Batch Operations
+ * @brief Element-wise operations over arrays of integers
+ * @{
+ */
+
+/**
+ * @brief Add two arrays element-wise: out[i] = a[i] + b[i]
+ * @param out Receives n new integers (caller must release each one)
+ * @param a First operands (n non-NULL integers)
+ * @param b Second operands (n non-NULL integers)
+ * @param n Number of elements
+ * @since 1.2.0
+ *
+ * The n results share one slab of headers and one block of limbs, freed
+ * when the last of them is released; each result is still an ordinary
+ * di_int that can be retained, grown or released independently. With DI_THREADS and
+ * di_set_threads() above 1, large batches are split across the pool.
+ *
+ * @note out may be the same array as a or b; the handles it held are
+ *       overwritten, not released
+ *
+ * @code
+ * di_int sums[3];
+ * di_add_batch(sums, xs, ys, 3);
+ * // ...
+ * for (int i = 0; i < 3; i++) di_release(&sums[i]);
+ * @endcode
+ */
+DI_DEF void di_add_batch(di_int* out, const di_int* a, const di_int* b, size_t n);
+
+/**
+ * @brief Multiply two arrays element-wise: out[i] = a[i] * b[i]
+ * @param out Receives n new integers (caller must release each one)
+ * @param a First operands (n non-NULL integers)
+ * @param b Second operands (n non-NULL integers)
+ * @param n Number of elements
+ * @since 1.2.0
+ *
+ * Same allocation and threading behavior as di_add_batch().
+ */
+DI_DEF void di_mul_batch(di_int* out, const di_int* a, const di_int* b, size_t n);
+
+/**
+ * @brief Compare two arrays element-wise: out[i] = di_compare(a[i], b[i])
+ * @param out Receives n comparison results (-1, 0 or 1)
+ * @param a First operands (n non-NULL integers)
+ * @param b Second operands (n non-NULL integers)
+ * @param n Number of elements
+ * @since 1.2.0
+ */
+DI_DEF void di_cmp_batch(int* out, const di_int* a, const di_int* b, size_t n);
+
+/** @} */ // end of batch_operations
+
+/**
+ * @defgroup vectors Structure-of-Arrays Vectors
+ * @brief Packed arrays of small integers with SIMD-friendly kernels
+ * @{
+ */
+
+/**
+ * @brief Handle for a packed, immutable array of integers
+ *
+ * Values are grouped into blocks of DI_VEC_LANES. Within a block every
+ * value is stored in two's complement at the width of the block's widest
+ * value, limb-major: the first limbs of all lanes, then the second limbs,
+ * and so on. Element-wise kernels therefore run the same instructions on
+ * every lane and compile to SIMD code, with no per-value headers, pointers
+ * or sign branches. Best suited to millions of values a few limbs wide.
+ *
+ * @since 1.2.0
+ */
+typedef struct di_vec_internal* di_vec;
+
+/**
+ * @brief Pack an array of integers into a vector
+ * @param values Array of integers (none may be NULL)
+ * @param count Number of integers in values
+ * @return New vector (caller must free with di_vec_free())
+ * @since 1.2.0
+ *
+ * @code
+ * di_vec v = di_vec_from_ints(values, count);
+ * di_vec doubled = di_vec_add(v, v);
+ * di_int first = di_vec_get(doubled, 0);
+ * di_release(&first);
+ * di_vec_free(&doubled);
+ * di_vec_free(&v);
+ * @endcode
+ */
+DI_DEF di_vec di_vec_from_ints(const di_int* values, size_t count);
+
+/**
+ * @brief Get number of values in a vector
+ * @param vec Vector to query (must not be NULL)
+ * @return Number of values
+ * @since 1.2.0
+ */
+DI_DEF size_t di_vec_count(di_vec vec);
+
+/**
+ * @brief Unpack one value of a vector
+ * @param vec Vector to read (must not be NULL)
+ * @param index Value index (must be < di_vec_count())
+ * @return New integer (caller must release)
+ * @since 1.2.0
+ */
+DI_DEF di_int di_vec_get(di_vec vec, size_t index);
+
+/**
+ * @brief Add two vectors element-wise
+ * @param a First vector (must not be NULL)
+ * @param b Second vector (must not be NULL, same length as a)
+ * @return New vector of a[i] + b[i] (caller must free)
+ * @since 1.2.0
+ */
+DI_DEF di_vec di_vec_add(di_vec a, di_vec b);
+
+/**
+ * @brief Subtract two vectors element-wise
+ * @param a First vector (must not be NULL)
+ * @param b Second vector (must not be NULL, same length as a)
+ * @return New vector of a[i] - b[i] (caller must free)
+ * @since 1.2.0
+ */
+DI_DEF di_vec di_vec_sub(di_vec a, di_vec b);
+
+/**
+ * @brief Multiply every value of a vector by a scalar
+ * @param a Vector (must not be NULL)
+ * @param scalar Multiplier
+ * @return New vector of a[i] * scalar (caller must free)
+ * @since 1.2.0
+ */
+DI_DEF di_vec di_vec_mul_i32(di_vec a, int32_t scalar);
+
+/**
+ * @brief Compare two vectors element-wise
+ * @param out Receives di_vec_count(a) results (-1, 0 or 1)
+ * @param a First vector (must not be NULL)
+ * @param b Second vector (must not be NULL, same length as a)
+ * @since 1.2.0
+ */
+DI_DEF void di_vec_cmp(int* out, di_vec a, di_vec b);
+
+/**
+ * @brief Free a vector
+ * @param vec Pointer to vector handle (may be NULL or point to NULL)
+ * @since 1.2.0
+ *
+ * @note Always sets the handle to NULL
+ */
+DI_DEF void di_vec_free(di_vec* vec);
+
+/** @} */ // end of vectors
+
+/**
+ * @defgroup overflow_detection Overflow Detection Helpers
+ * @brief Fixed-size arithmetic that reports overflow instead of wrapping
+ *
+ * Every helper stores its result through the last argument and returns
+ * true when the exact result fits the type, false on overflow (the stored
+ * value is then unspecified). The result pointer must not be NULL; it is
+ * not checked, so that the helpers stay cheap enough for an interpreter's
+ * fast path. They are defined in this header rather than under
+ * DI_IMPLEMENTATION so that every caller can inline them; with GCC or
+ * Clang add, subtract, multiply and negate compile to the compiler's
+ * overflow builtins (one arithmetic instruction and a branch). Define
+ * DI_NO_OVERFLOW_BUILTINS to use the portable range checks instead.
+ *
+ * Names are di_<operation>_overflow_<type> for operation add, subtract,
+ * multiply, negate and shift_left, and type int16, uint16, int32, uint32,
+ * int64 and uint64.
+ * @{
+ */
+/**
+ * @brief Add two int16_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the sum fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_add_overflow_int16(int16_t a, int16_t b, int16_t* result);
+
+/**
+ * @brief Subtract two int16_t values with overflow detection
+ * @param a Minuend
+ * @param b Subtrahend
+ * @param result Pointer to store result
+ * @return true if the difference fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_subtract_overflow_int16(int16_t a, int16_t b, int16_t* result);
+
+/**
+ * @brief Multiply two int16_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the product fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_multiply_overflow_int16(int16_t a, int16_t b, int16_t* result);
+
+/**
+ * @brief Negate a int16_t value with overflow detection
+ * @param a Operand
+ * @param result Pointer to store -a
+ * @return true if -a fits (every value except INT16_MIN), false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_negate_overflow_int16(int16_t a, int16_t* result);
+
+/**
+ * @brief Shift a int16_t value left with overflow detection
+ * @param a Operand
+ * @param bits Shift count (any value)
+ * @param result Pointer to store a * 2^bits
+ * @return true if a * 2^bits fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_shift_left_overflow_int16(int16_t a, unsigned bits, int16_t* result);
+
+/**
+ * @brief Add two uint16_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the sum fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_add_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result);
+
+/**
+ * @brief Subtract two uint16_t values with overflow detection
+ * @param a Minuend
+ * @param b Subtrahend
+ * @param result Pointer to store result
+ * @return true if the difference fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_subtract_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result);
+
+/**
+ * @brief Multiply two uint16_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the product fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_multiply_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result);
+
+/**
+ * @brief Negate a uint16_t value with overflow detection
+ * @param a Operand
+ * @param result Pointer to store -a
+ * @return true if -a fits (only for 0), false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_negate_overflow_uint16(uint16_t a, uint16_t* result);
+
+/**
+ * @brief Shift a uint16_t value left with overflow detection
+ * @param a Operand
+ * @param bits Shift count (any value)
+ * @param result Pointer to store a * 2^bits
+ * @return true if a * 2^bits fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_shift_left_overflow_uint16(uint16_t a, unsigned bits, uint16_t* result);
+
+/**
+ * @brief Add two int32_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the sum fits, false on overflow
+ * @since 1.0.0
+ * 
+ * @code
+ * int32_t result;
+ * if (!di_add_overflow_int32(INT32_MAX, 1, &result)) {
+ *     // Overflow occurred, use big integer arithmetic
+ *     di_int a = di_from_int32(INT32_MAX);
+ *     di_int b = di_from_int32(1);
+ *     di_int sum = di_add(a, b);
+ *     // ... handle big integer result
+ * }
+ * @endcode
+ */
+DI_INLINE bool di_add_overflow_int32(int32_t a, int32_t b, int32_t* result);
+
+/**
+ * @brief Subtract two int32_t values with overflow detection
+ * @param a Minuend
+ * @param b Subtrahend
+ * @param result Pointer to store result
+ * @return true if the difference fits, false on overflow
+ * @since 1.0.0
+ */
+DI_INLINE bool di_subtract_overflow_int32(int32_t a, int32_t b, int32_t* result);
+
+/**
+ * @brief Multiply two int32_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the product fits, false on overflow
+ * @since 1.0.0
+ */
+DI_INLINE bool di_multiply_overflow_int32(int32_t a, int32_t b, int32_t* result);
+
+/**
+ * @brief Negate a int32_t value with overflow detection
+ * @param a Operand
+ * @param result Pointer to store -a
+ * @return true if -a fits (every value except INT32_MIN), false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_negate_overflow_int32(int32_t a, int32_t* result);
+
+/**
+ * @brief Shift a int32_t value left with overflow detection
+ * @param a Operand
+ * @param bits Shift count (any value)
+ * @param result Pointer to store a * 2^bits
+ * @return true if a * 2^bits fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_shift_left_overflow_int32(int32_t a, unsigned bits, int32_t* result);
+
+/**
+ * @brief Add two uint32_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the sum fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_add_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result);
+
+/**
+ * @brief Subtract two uint32_t values with overflow detection
+ * @param a Minuend
+ * @param b Subtrahend
+ * @param result Pointer to store result
+ * @return true if the difference fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_subtract_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result);
+
+/**
+ * @brief Multiply two uint32_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the product fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_multiply_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result);
+
+/**
+ * @brief Negate a uint32_t value with overflow detection
+ * @param a Operand
+ * @param result Pointer to store -a
+ * @return true if -a fits (only for 0), false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_negate_overflow_uint32(uint32_t a, uint32_t* result);
+
+/**
+ * @brief Shift a uint32_t value left with overflow detection
+ * @param a Operand
+ * @param bits Shift count (any value)
+ * @param result Pointer to store a * 2^bits
+ * @return true if a * 2^bits fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_shift_left_overflow_uint32(uint32_t a, unsigned bits, uint32_t* result);
+
+/**
+ * @brief Add two int64_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the sum fits, false on overflow
+ * @since 1.0.0
+ */
+DI_INLINE bool di_add_overflow_int64(int64_t a, int64_t b, int64_t* result);
+
+/**
+ * @brief Subtract two int64_t values with overflow detection
+ * @param a Minuend
+ * @param b Subtrahend
+ * @param result Pointer to store result
+ * @return true if the difference fits, false on overflow
+ * @since 1.0.0
+ */
+DI_INLINE bool di_subtract_overflow_int64(int64_t a, int64_t b, int64_t* result);
+
+/**
+ * @brief Multiply two int64_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the product fits, false on overflow
+ * @since 1.0.0
+ */
+DI_INLINE bool di_multiply_overflow_int64(int64_t a, int64_t b, int64_t* result);
+
+/**
+ * @brief Negate a int64_t value with overflow detection
+ * @param a Operand
+ * @param result Pointer to store -a
+ * @return true if -a fits (every value except INT64_MIN), false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_negate_overflow_int64(int64_t a, int64_t* result);
+
+/**
+ * @brief Shift a int64_t value left with overflow detection
+ * @param a Operand
+ * @param bits Shift count (any value)
+ * @param result Pointer to store a * 2^bits
+ * @return true if a * 2^bits fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_shift_left_overflow_int64(int64_t a, unsigned bits, int64_t* result);
+
+/**
+ * @brief Add two uint64_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the sum fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_add_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result);
+
+/**
+ * @brief Subtract two uint64_t values with overflow detection
+ * @param a Minuend
+ * @param b Subtrahend
+ * @param result Pointer to store result
+ * @return true if the difference fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_subtract_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result);
+
+/**
+ * @brief Multiply two uint64_t values with overflow detection
+ * @param a First operand
+ * @param b Second operand
+ * @param result Pointer to store result
+ * @return true if the product fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_multiply_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result);
+
+/**
+ * @brief Negate a uint64_t value with overflow detection
+ * @param a Operand
+ * @param result Pointer to store -a
+ * @return true if -a fits (only for 0), false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_negate_overflow_uint64(uint64_t a, uint64_t* result);
+
+/**
+ * @brief Shift a uint64_t value left with overflow detection
+ * @param a Operand
+ * @param bits Shift count (any value)
+ * @param result Pointer to store a * 2^bits
+ * @return true if a * 2^bits fits, false on overflow
+ * @since 1.2.0
+ */
+DI_INLINE bool di_shift_left_overflow_uint64(uint64_t a, unsigned bits, uint64_t* result);
+
+/** @} */ // end of overflow_detection
+
+// Overflow detection helpers (inline in every translation unit)
+
+#ifdef DI_HAS_OVERFLOW_BUILTINS
+DI_INLINE bool di_add_overflow_int16(int16_t a, int16_t b, int16_t* result) {
+    return !__builtin_add_overflow(a, b, result);
+}
+
+DI_INLINE bool di_subtract_overflow_int16(int16_t a, int16_t b, int16_t* result) {
+    return !__builtin_sub_overflow(a, b, result);
+}
+
+DI_INLINE bool di_multiply_overflow_int16(int16_t a, int16_t b, int16_t* result) {
+    return !__builtin_mul_overflow(a, b, result);
+}
+
+DI_INLINE bool di_negate_overflow_int16(int16_t a, int16_t* result) {
+    return !__builtin_sub_overflow((int16_t)0, a, result);
+}
+
+DI_INLINE bool di_add_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result) {
+    return !__builtin_add_overflow(a, b, result);
+}
+
+DI_INLINE bool di_subtract_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result) {
+    return !__builtin_sub_overflow(a, b, result);
+}
+
+DI_INLINE bool di_multiply_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result) {
+    return !__builtin_mul_overflow(a, b, result);
+}
+
+DI_INLINE bool di_negate_overflow_uint16(uint16_t a, uint16_t* result) {
+    return !__builtin_sub_overflow((uint16_t)0, a, result);
+}
+
+DI_INLINE bool di_add_overflow_int32(int32_t a, int32_t b, int32_t* result) {
+    return !__builtin_add_overflow(a, b, result);
+}
+
+DI_INLINE bool di_subtract_overflow_int32(int32_t a, int32_t b, int32_t* result) {
+    return !__builtin_sub_overflow(a, b, result);
+}
+
+DI_INLINE bool di_multiply_overflow_int32(int32_t a, int32_t b, int32_t* result) {
+    return !__builtin_mul_overflow(a, b, result);
+}
+
+DI_INLINE bool di_negate_overflow_int32(int32_t a, int32_t* result) {
+    return !__builtin_sub_overflow((int32_t)0, a, result);
+}
+
+DI_INLINE bool di_add_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result) {
+    return !__builtin_add_overflow(a, b, result);
+}
+
+DI_INLINE bool di_subtract_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result) {
+    return !__builtin_sub_overflow(a, b, result);
+}
+
+DI_INLINE bool di_multiply_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result) {
+    return !__builtin_mul_overflow(a, b, result);
+}
+
+DI_INLINE bool di_negate_overflow_uint32(uint32_t a, uint32_t* result) {
+    return !__builtin_sub_overflow((uint32_t)0, a, result);
+}
+
+DI_INLINE bool di_add_overflow_int64(int64_t a, int64_t b, int64_t* result) {
+    return !__builtin_add_overflow(a, b, result);
+}
+
+DI_INLINE bool di_subtract_overflow_int64(int64_t a, int64_t b, int64_t* result) {
+    return !__builtin_sub_overflow(a, b, result);
+}
+
+DI_INLINE bool di_multiply_overflow_int64(int64_t a, int64_t b, int64_t* result) {
+    return !__builtin_mul_overflow(a, b, result);
+}
+
+DI_INLINE bool di_negate_overflow_int64(int64_t a, int64_t* result) {
+    return !__builtin_sub_overflow((int64_t)0, a, result);
+}
+
+DI_INLINE bool di_add_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result) {
+    return !__builtin_add_overflow(a, b, result);
+}
+
+DI_INLINE bool di_subtract_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result) {
+    return !__builtin_sub_overflow(a, b, result);
+}
+
+DI_INLINE bool di_multiply_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result) {
+    return !__builtin_mul_overflow(a, b, result);
+}
+
+DI_INLINE bool di_negate_overflow_uint64(uint64_t a, uint64_t* result) {
+    return !__builtin_sub_overflow((uint64_t)0, a, result);
+}
+#else
+DI_INLINE bool di_add_overflow_int16(int16_t a, int16_t b, int16_t* result) {
+    int64_t sum = (int64_t)a + (int64_t)b;
+    *result = (int16_t)sum;
+    return sum >= INT16_MIN && sum <= INT16_MAX;
+}
+
+DI_INLINE bool di_subtract_overflow_int16(int16_t a, int16_t b, int16_t* result) {
+    int64_t diff = (int64_t)a - (int64_t)b;
+    *result = (int16_t)diff;
+    return diff >= INT16_MIN && diff <= INT16_MAX;
+}
+
+DI_INLINE bool di_multiply_overflow_int16(int16_t a, int16_t b, int16_t* result) {
+    int64_t prod = (int64_t)a * (int64_t)b;
+    *result = (int16_t)prod;
+    return prod >= INT16_MIN && prod <= INT16_MAX;
+}
+
+DI_INLINE bool di_negate_overflow_int16(int16_t a, int16_t* result) {
+    if (a == INT16_MIN) return false;
+    *result = (int16_t)-a;
+    return true;
+}
+
+DI_INLINE bool di_add_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result) {
+    int64_t sum = (int64_t)a + (int64_t)b;
+    *result = (uint16_t)sum;
+    return sum >= 0 && sum <= UINT16_MAX;
+}
+
+DI_INLINE bool di_subtract_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result) {
+    int64_t diff = (int64_t)a - (int64_t)b;
+    *result = (uint16_t)diff;
+    return diff >= 0 && diff <= UINT16_MAX;
+}
+
+DI_INLINE bool di_multiply_overflow_uint16(uint16_t a, uint16_t b, uint16_t* result) {
+    int64_t prod = (int64_t)a * (int64_t)b;
+    *result = (uint16_t)prod;
+    return prod >= 0 && prod <= UINT16_MAX;
+}
+
+DI_INLINE bool di_negate_overflow_uint16(uint16_t a, uint16_t* result) {
+    *result = (uint16_t)(0u - a);
+    return a == 0;
+}
+
+DI_INLINE bool di_add_overflow_int32(int32_t a, int32_t b, int32_t* result) {
+    int64_t sum = (int64_t)a + (int64_t)b;
+    *result = (int32_t)sum;
+    return sum >= INT32_MIN && sum <= INT32_MAX;
+}
+
+DI_INLINE bool di_subtract_overflow_int32(int32_t a, int32_t b, int32_t* result) {
+    int64_t diff = (int64_t)a - (int64_t)b;
+    *result = (int32_t)diff;
+    return diff >= INT32_MIN && diff <= INT32_MAX;
+}
+
+DI_INLINE bool di_multiply_overflow_int32(int32_t a, int32_t b, int32_t* result) {
+    int64_t prod = (int64_t)a * (int64_t)b;
+    *result = (int32_t)prod;
+    return prod >= INT32_MIN && prod <= INT32_MAX;
+}
+
+DI_INLINE bool di_negate_overflow_int32(int32_t a, int32_t* result) {
+    if (a == INT32_MIN) return false;
+    *result = (int32_t)-a;
+    return true;
+}
+
+DI_INLINE bool di_add_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result) {
+    *result = (uint32_t)(a + b);
+    return *result >= a;
+}
+
+DI_INLINE bool di_subtract_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result) {
+    *result = (uint32_t)(a - b);
+    return a >= b;
+}
+
+DI_INLINE bool di_multiply_overflow_uint32(uint32_t a, uint32_t b, uint32_t* result) {
+    *result = (uint32_t)(a * b);
+    return b == 0 || a <= UINT32_MAX / b;
+}
+
+DI_INLINE bool di_negate_overflow_uint32(uint32_t a, uint32_t* result) {
+    *result = (uint32_t)(0u - a);
+    return a == 0;
+}
+
+DI_INLINE bool di_add_overflow_int64(int64_t a, int64_t b, int64_t* result) {
+    if (b > 0 && a > INT64_MAX - b) return false;
+    if (b < 0 && a < INT64_MIN - b) return false;
+    *result = a + b;
+    return true;
+}
+
+DI_INLINE bool di_subtract_overflow_int64(int64_t a, int64_t b, int64_t* result) {
+    if (b < 0 && a > INT64_MAX + b) return false;
+    if (b > 0 && a < INT64_MIN + b) return false;
+    *result = a - b;
+    return true;
+}
+
+DI_INLINE bool di_multiply_overflow_int64(int64_t a, int64_t b, int64_t* result) {
+    if (a > 0) {
+        if (b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a) return false;
+    } else if (a < 0) {
+        if (b > 0 ? a < INT64_MIN / b : b < INT64_MAX / a) return false;
+    }
+    *result = a * b;
+    return true;
+}
+
+DI_INLINE bool di_negate_overflow_int64(int64_t a, int64_t* result) {
+    if (a == INT64_MIN) return false;
+    *result = (int64_t)-a;
+    return true;
+}
+
+DI_INLINE bool di_add_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result) {
+    *result = (uint64_t)(a + b);
+    return *result >= a;
+}
+
+DI_INLINE bool di_subtract_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result) {
+    *result = (uint64_t)(a - b);
+    return a >= b;
+}
+
+DI_INLINE bool di_multiply_overflow_uint64(uint64_t a, uint64_t b, uint64_t* result) {
+    *result = (uint64_t)(a * b);
+    return b == 0 || a <= UINT64_MAX / b;
+}
+
+DI_INLINE bool di_negate_overflow_uint64(uint64_t a, uint64_t* result) {
+    *result = (uint64_t)(0u - a);
+    return a == 0;
+}
+#endif
+
+// No builtin for shifts: a fits if it lies within the type's range shifted right
+DI_INLINE bool di_shift_left_overflow_int16(int16_t a, unsigned bits, int16_t* result) {
+    if (bits >= 16) {
+        *result = 0;
+        return a == 0;
+    }
+    if (a > (INT16_MAX >> bits) || a < -(INT16_MAX >> bits) - 1) return false;
+    *result = (int16_t)((uint16_t)a << bits);
+    return true;
+}
+
+DI_INLINE bool di_shift_left_overflow_uint16(uint16_t a, unsigned bits, uint16_t* result) {
+    if (bits >= 16) {
+        *result = 0;
+        return a == 0;
+    }
+    if (a > (UINT16_MAX >> bits)) return false;
+    *result = (uint16_t)(a << bits);
+    return true;
+}
+
+DI_INLINE bool di_shift_left_overflow_int32(int32_t a, unsigned bits, int32_t* result) {
+    if (bits >= 32) {
+        *result = 0;
+        return a == 0;
+    }
+    if (a > (INT32_MAX >> bits) || a < -(INT32_MAX >> bits) - 1) return false;
+    *result = (int32_t)((uint32_t)a << bits);
+    return true;
+}
+
+DI_INLINE bool di_shift_left_overflow_uint32(uint32_t a, unsigned bits, uint32_t* result) {
+    if (bits >= 32) {
+        *result = 0;
+        return a == 0;
+    }
+    if (a > (UINT32_MAX >> bits)) return false;
+    *result = (uint32_t)(a << bits);
+    return true;
+}
+
+DI_INLINE bool di_shift_left_overflow_int64(int64_t a, unsigned bits, int64_t* result) {
+    if (bits >= 64) {
+        *result = 0;
+        return a == 0;
+    }
+    if (a > (INT64_MAX >> bits) || a < -(INT64_MAX >> bits) - 1) return false;
+    *result = (int64_t)((uint64_t)a << bits);
+    return true;
+}
+
+DI_INLINE bool di_shift_left_overflow_uint64(uint64_t a, unsigned bits, uint64_t* result) {
+    if (bits >= 64) {
+        *result = 0;
+        return a == 0;
+    }
+    if (a > (UINT64_MAX >> bits)) return false;
+    *result = (uint64_t)(a << bits);
+    return true;
+}
+
+/**
+ * @defgroup hybrid_numbers Hybrid Numbers
+ * @brief Values that stay native int64_t until they overflow
+ *
+ * A di_num holds either an int64_t inline or a di_int. Arithmetic on two
+ * inline values runs inline through the overflow helpers; only when the
+ * result does not fit does it move to the heap. Results that fit int64_t
+ * are always returned inline, so a value that grows and shrinks again
+ * comes back to the fast path by itself. This is the representation a
+ * scripting-language runtime wants for its integer type.
+ *
+ * Operations do not consume their operands. Every di_num returned holds
+ * its own reference when it is big; release it with di_num_release(),
+ * which is a no-op for inline values.
+ *
+ * @code
+ * di_num x = di_num_from_int64(INT64_MAX);
+ * di_num y = di_num_add(x, di_num_from_int64(1));   // promoted: 2^63
+ * di_num z = di_num_sub(y, di_num_from_int64(2));   // demoted: INT64_MAX - 1
+ * // z.big == NULL
+ * di_num_release(&y);
+ * di_num_release(&z);
+ * @endcode
+ * @{
+ */
+
+/**
+ * @brief Integer stored inline when it fits int64_t, on the heap otherwise
+ * @since 1.2.0
+ *
+ * @note big is non-NULL only for values outside int64_t
+ */
+typedef struct {
+    di_int big;         ///< Heap value, or NULL when the value is in small
+    int64_t small;      ///< Value when big is NULL
+} di_num;
+
+/** @brief Operations of di_num_op_slow() */
+typedef enum {
+    DI_NUM_ADD,
+    DI_NUM_SUB,
+    DI_NUM_MUL,
+    DI_NUM_DIV,
+    DI_NUM_MOD
+} di_num_op;
+
+/**
+ * @brief Make an inline number
+ * @param value Value
+ * @return Number holding value (nothing to release)
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_from_int64(int64_t value);
+
+/**
+ * @brief Make a number from a big integer
+ * @param value Integer (must not be NULL; not consumed)
+ * @return Inline number if value fits int64_t, otherwise a new reference to value
+ * @since 1.2.0
+ */
+DI_DEF di_num di_num_from_int(di_int value);
+
+/**
+ * @brief Get a number as a big integer
+ * @param n Number
+ * @return New reference (caller must release)
+ * @since 1.2.0
+ */
+DI_DEF di_int di_num_to_int(di_num n);
+
+/**
+ * @brief Get a number as int64_t
+ * @param n Number
+ * @param result Receives the value
+ * @return true if n is inline, false if it does not fit
+ * @since 1.2.0
+ */
+DI_INLINE bool di_num_to_int64(di_num n, int64_t* result);
+
+/**
+ * @brief Take another reference to a number
+ * @param n Number
+ * @return n (with its reference count raised if it is big)
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_retain(di_num n);
+
+/**
+ * @brief Release a number and set it to inline zero
+ * @param n Number to release (may be NULL)
+ * @since 1.2.0
+ */
+DI_INLINE void di_num_release(di_num* n);
+
+/**
+ * @brief Add two numbers
+ * @param a First operand
+ * @param b Second operand
+ * @return a + b
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_add(di_num a, di_num b);
+
+/**
+ * @brief Subtract two numbers
+ * @param a Minuend
+ * @param b Subtrahend
+ * @return a - b
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_sub(di_num a, di_num b);
+
+/**
+ * @brief Multiply two numbers
+ * @param a First operand
+ * @param b Second operand
+ * @return a * b
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_mul(di_num a, di_num b);
+
+/**
+ * @brief Divide two numbers, rounding toward negative infinity like di_div()
+ * @param a Dividend
+ * @param b Divisor (must not be zero)
+ * @return floor(a / b)
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_div(di_num a, di_num b);
+
+/**
+ * @brief Remainder of floor division, with the divisor's sign like di_mod()
+ * @param a Dividend
+ * @param b Divisor (must not be zero)
+ * @return a - b * floor(a / b)
+ * @since 1.2.0
+ */
+DI_INLINE di_num di_num_mod(di_num a, di_num b);
+
+/**
+ * @brief Compare two numbers
+ * @param a First number
+ * @param b Second number
+ * @return -1 if a < b, 0 if equal, 1 if a > b
+ * @since 1.2.0
+ */
+DI_INLINE int di_num_cmp(di_num a, di_num b);
+
+/**
+ * @brief Convert a number to a string
+ * @param n Number
+ * @param base Base from 2 to 36
+ * @return New string (caller must free)
+ * @since 1.2.0
+ */
+DI_DEF char* di_num_to_string(di_num n, int base);
+
+/**
+ * @brief Arithmetic on numbers of any kind
+ * @param op Operation
+ * @param a First operand
+ * @param b Second operand
+ * @return Result, inline if it fits int64_t
+ * @since 1.2.0
+ *
+ * The out-of-line path behind di_num_add() and the others, taken when
+ * an operand is big or the inline result would overflow. Callers
+ * normally use those functions instead.
+ */
+DI_DEF di_num di_num_op_slow(di_num_op op, di_num a, di_num b);
+
+/**
+ * @brief Compare numbers when at least one is big
+ * @param a First number
+ * @param b Second number
+ * @return -1 if a < b, 0 if equal, 1 if a > b
+ * @since 1.2.0
+ */
+DI_DEF int di_num_cmp_slow(di_num a, di_num b);
+
+/** @} */ // end of hybrid_numbers
+
+// Hybrid number fast paths (inline in every translation unit)
+
+DI_INLINE di_num di_num_from_int64(int64_t value) {
+    di_num n = { NULL, value };
+    return n;
+}
+
+DI_INLINE bool di_num_to_int64(di_num n, int64_t* result) {
+    if (n.big) return false;
+    *result = n.small;
+    return true;
+}
+
+DI_INLINE di_num di_num_retain(di_num n) {
+    if (n.big) di_retain(n.big);
+    return n;
+}
+
+DI_INLINE void di_num_release(di_num* n) {
+    if (!n) return;
+    if (n->big) di_release(&n->big);
+    n->small = 0;
+}
+
+DI_INLINE di_num di_num_add(di_num a, di_num b) {
+    di_num r = { NULL, 0 };
+    if (!a.big && !b.big && di_add_overflow_int64(a.small, b.small, &r.small)) return r;
+    return di_num_op_slow(DI_NUM_ADD, a, b);
+}
+
+DI_INLINE di_num di_num_sub(di_num a, di_num b) {
+    di_num r = { NULL, 0 };
+    if (!a.big && !b.big && di_subtract_overflow_int64(a.small, b.small, &r.small)) return r;
+    return di_num_op_slow(DI_NUM_SUB, a, b);
+}
+
+DI_INLINE di_num di_num_mul(di_num a, di_num b) {
+    di_num r = { NULL, 0 };
+    if (!a.big && !b.big && di_multiply_overflow_int64(a.small, b.small, &r.small)) return r;
+    return di_num_op_slow(DI_NUM_MUL, a, b);
+}
+
+// Divisors 0 (asserts) and -1 (INT64_MIN / -1 overflows) take the slow path
+DI_INLINE di_num di_num_div(di_num a, di_num b) {
+    if (!a.big && !b.big && b.small != 0 && b.small != -1) {
+        int64_t q = a.small / b.small;
+        if (a.small % b.small != 0 && (a.small < 0) != (b.small < 0)) q--;
+        return di_num_from_int64(q);
+    }
+    return di_num_op_slow(DI_NUM_DIV, a, b);
+}
+
+DI_INLINE di_num di_num_mod(di_num a, di_num b) {
+    if (!a.big && !b.big && b.small != 0 && b.small != -1) {
+        int64_t r = a.small % b.small;
+        if (r != 0 && (r < 0) != (b.small < 0)) r += b.small;
+        return di_num_from_int64(r);
+    }
+    return di_num_op_slow(DI_NUM_MOD, a, b);
+}
+
+DI_INLINE int di_num_cmp(di_num a, di_num b) {
+    if (!a.big && !b.big) return (a.small > b.small) - (a.small < b.small);
+    return di_num_cmp_slow(a, b);
+}
 
 #ifdef DI_IMPLEMENTATION
 
-#include <stdlib.h>
-#include <string.h>
-#include <assert.h>
-#include <stdio.h>
-#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdio.h>
+#include <math.h>
+
+#if !defined(DI_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define DI_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && !defined(DI_NO_GETRANDOM)
+#define DI_HAS_GETRANDOM 1
+#include <errno.h>
+#include <sys/random.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define DI_HAS_URANDOM 1
+#endif
+
+#ifdef DI_THREADS
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#endif
+
+#if !defined(DI_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DI_SIMD_X86 1
+#include <immintrin.h>
+#elif !defined(DI_NO_SIMD) && defined(DI_NEON) && defined(__aarch64__) && defined(__ARM_NEON)
+#define DI_SIMD_NEON 1
+#include <arm_neon.h>
+#ifdef __linux__
+#define DI_HAS_AUXV 1
+#include <sys/auxv.h>
+#endif
+#endif
+
+#ifdef DI_TUNING
+// The tune program varies the crossovers at run time instead of
+// rebuilding for each candidate
+static size_t di_tune_karatsuba = DI_KARATSUBA_THRESHOLD;
+static size_t di_tune_ifma_mul = DI_IFMA_MUL_THRESHOLD;
+static size_t di_tune_ifma_karatsuba = DI_IFMA_KARATSUBA_THRESHOLD;
+static size_t di_tune_ifma_mont = DI_IFMA_MONT_THRESHOLD;
+#undef DI_KARATSUBA_THRESHOLD
+#undef DI_IFMA_MUL_THRESHOLD
+#undef DI_IFMA_KARATSUBA_THRESHOLD
+#undef DI_IFMA_MONT_THRESHOLD
+#define DI_KARATSUBA_THRESHOLD di_tune_karatsuba
+#define DI_IFMA_MUL_THRESHOLD di_tune_ifma_mul
+#define DI_IFMA_KARATSUBA_THRESHOLD di_tune_ifma_karatsuba
+#define DI_IFMA_MONT_THRESHOLD di_tune_ifma_mont
+#endif
+
+#ifdef DI_THREADSAFE
+#include <stdatomic.h>
+typedef atomic_size_t di_refcount_t;
+#else
+typedef size_t di_refcount_t;
+#endif
+
+/* Internal structure */
+struct di_int_internal {
+    di_refcount_t ref_count; // Reference count (atomic with DI_THREADSAFE)
+    di_limb_t* limbs;       // Array of limbs (little-endian)
+    size_t limb_count;      // Number of limbs used
+    size_t limb_capacity;   // Allocated capacity
+    bool is_negative;       // Sign flag
+    bool slab_limbs;        // Limbs live in the slab, not in their own block
+    struct di_slab* slab;   // Batch allocation holding this header, or NULL
+};
+
+// Shared storage for every result of a batch call: the result headers
+// follow this one and their limbs sit in one more block. Both are freed
+// with the last result.
+struct di_slab {
+    di_refcount_t live;     // Results not yet released
+    di_limb_t* limbs;
+    struct di_int_internal items[];
+};
+
+// Tracing hooks: user-supplied, the built-in recorder, or nothing
+#if defined(DI_TRACE_BEGIN) != defined(DI_TRACE_END)
+#error "DI_TRACE_BEGIN and DI_TRACE_END must be defined together"
+#endif
+#if !defined(DI_TRACE_BEGIN) && defined(DI_TRACE)
+#define DI_TRACE_DEFAULT 1
+#define DI_TRACE_BEGIN(op, a_limbs, b_limbs) \
+    di_trace_span di_trace_span_ = di_trace_begin((op), (uint64_t)(a_limbs) + (uint64_t)(b_limbs))
+#define DI_TRACE_END() di_trace_end(&di_trace_span_)
+#elif !defined(DI_TRACE_BEGIN)
+#define DI_TRACE_BEGIN(op, a_limbs, b_limbs) ((void)0)
+#define DI_TRACE_END() ((void)0)
+#endif
+
+// Statistics
+// Each thread counts into its own block, found through a thread-local
+// pointer and linked into a global list on first use; readers walk the
+// list. Owners update with plain relaxed loads and stores, so counting
+// costs no locked instructions. Blocks stay on the list, which keeps the
+// counts of threads that have exited; with POSIX threads a thread-exit
+// key destructor marks the block unowned and the next new thread claims
+// it and keeps counting on top, so the list grows only to the largest
+// number of threads alive at once. Tracing keeps its histograms the same
+// way.
+
+#if defined(DI_STATS) || defined(DI_TRACE_DEFAULT)
+#if defined(DI_THREADS) || defined(DI_THREADSAFE)
+#include <stdatomic.h>
+typedef _Atomic uint64_t di_stat_t;
+#define DI_STAT_LOAD(c) atomic_load_explicit(&(c), memory_order_relaxed)
+#define DI_STAT_STORE(c, v) atomic_store_explicit(&(c), (v), memory_order_relaxed)
+#else
+typedef uint64_t di_stat_t;
+#define DI_STAT_LOAD(c) (c)
+#define DI_STAT_STORE(c, v) ((c) = (v))
+#endif
+
+#if (defined(DI_THREADS) || defined(DI_THREADSAFE)) && (defined(__unix__) || defined(__APPLE__))
+#define DI_STAT_RECLAIM 1
+#include <pthread.h>
+#endif
+
+// Link at the start of every stats and trace block
+typedef struct di_stat_node {
+    struct di_stat_node* next;
+#ifdef DI_STAT_RECLAIM
+    atomic_bool owned;              // Held by a live thread
+    struct di_stat_node** mine;     // The owner's thread-local pointer to it
+#endif
+} di_stat_node;
+
+#if defined(DI_THREADS) || defined(DI_THREADSAFE)
+typedef di_stat_node* _Atomic di_stat_list;
+#else
+typedef di_stat_node* di_stat_list;
+#endif
+
+enum { DI_STAT_LIST_STATS, DI_STAT_LIST_TRACE, DI_STAT_LISTS };
+
+static di_stat_node* di_stat_first(di_stat_list* list) {
+#if defined(DI_THREADS) || defined(DI_THREADSAFE)
+    return atomic_load_explicit(list, memory_order_acquire);
+#else
+    return *list;
+#endif
+}
+
+#ifdef DI_STAT_RECLAIM
+static pthread_key_t di_stat_keys[DI_STAT_LISTS];
+static pthread_once_t di_stat_keys_once = PTHREAD_ONCE_INIT;
+
+// Runs as the owning thread exits; the counts stay in the block
+static void di_stat_thread_exit(void* node) {
+    di_stat_node* block = (di_stat_node*)node;
+    *block->mine = NULL;
+    atomic_store_explicit(&block->owned, false, memory_order_release);
+}
+
+static void di_stat_keys_create(void) {
+    for (int i = 0; i < DI_STAT_LISTS; i++) pthread_key_create(&di_stat_keys[i], di_stat_thread_exit);
+}
+
+// Take over a block whose owner has exited
+static bool di_stat_claim(di_stat_node* block) {
+    bool expected = false;
+    return !atomic_load_explicit(&block->owned, memory_order_relaxed) &&
+           atomic_compare_exchange_strong_explicit(&block->owned, &expected, true,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+#endif
+
+// First use on a thread: claim a block an exited thread left on list, or
+// link in a new one of size bytes set up by clear, and point the
+// thread-local mine at it
+static di_stat_node* di_stat_block_get(di_stat_list* list, int key, di_stat_node** mine,
+                                       size_t size, void (*clear)(di_stat_node*)) {
+    di_stat_node* block = NULL;
+#ifdef DI_STAT_RECLAIM
+    pthread_once(&di_stat_keys_once, di_stat_keys_create);
+    block = di_stat_first(list);
+    while (block && !di_stat_claim(block)) block = block->next;
+#endif
+    if (!block) {
+        block = (di_stat_node*)DI_MALLOC(size);
+        DI_ASSERT(block && "di_stat_block_get: allocation failed");
+        clear(block);
+#ifdef DI_STAT_RECLAIM
+        atomic_init(&block->owned, true);
+#endif
+#if defined(DI_THREADS) || defined(DI_THREADSAFE)
+        block->next = atomic_load_explicit(list, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(list, &block->next, block,
+                                                      memory_order_release, memory_order_relaxed)) {
+        }
+#else
+        block->next = *list;
+        *list = block;
+#endif
+    }
+#ifdef DI_STAT_RECLAIM
+    block->mine = mine;
+    pthread_setspecific(di_stat_keys[key], block);
+#else
+    (void)key;
+#endif
+    *mine = block;
+    return block;
+}
+#endif
+
+#ifdef DI_STATS
+enum {
+    DI_STAT_ALLOCS,
+    DI_STAT_FREES,
+    DI_STAT_REALLOCS,
+    DI_STAT_BYTES,
+    DI_STAT_LIVE_INTS,      // Signed: integers may be freed on another thread
+    DI_STAT_PEAK_INTS,
+    DI_STAT_LIVE_LIMBS,
+    DI_STAT_PEAK_LIMBS,
+    DI_STAT_OPS,            // Calls, then limbs, for each di_stats_op
+    DI_STAT_COUNT = DI_STAT_OPS + 2 * DI_STATS_OPS
+};
+
+typedef struct di_stats_block {
+    di_stat_node node;              // First, so a block and its node share an address
+    di_stat_t counters[DI_STAT_COUNT];
+} di_stats_block;
+
+static di_stat_list di_stats_blocks;
+static DI_THREAD_LOCAL di_stat_node* di_stats_mine;
+
+static void di_stats_clear(di_stat_node* node) {
+    di_stats_block* block = (di_stats_block*)node;
+    for (int i = 0; i < DI_STAT_COUNT; i++) DI_STAT_STORE(block->counters[i], 0);
+}
+
+static di_stats_block* di_stats_block_get(void) {
+    di_stat_node* block = di_stats_mine;
+    if (!block) {
+        block = di_stat_block_get(&di_stats_blocks, DI_STAT_LIST_STATS, &di_stats_mine,
+                                  sizeof(di_stats_block), di_stats_clear);
+    }
+    return (di_stats_block*)block;
+}
+
+static void di_stats_add(int counter, uint64_t n) {
+    di_stat_t* c = &di_stats_block_get()->counters[counter];
+    DI_STAT_STORE(*c, DI_STAT_LOAD(*c) + n);
+}
+
+// Live counters are two's complement; the peak follows the local maximum
+static void di_stats_live(int live, int peak, int64_t delta) {
+    di_stats_block* block = di_stats_block_get();
+    uint64_t value = DI_STAT_LOAD(block->counters[live]) + (uint64_t)delta;
+    DI_STAT_STORE(block->counters[live], value);
+    if ((int64_t)value > (int64_t)DI_STAT_LOAD(block->counters[peak])) {
+        DI_STAT_STORE(block->counters[peak], value);
+    }
+}
+
+static void di_stats_alloc(size_t mallocs, size_t bytes, size_t ints, size_t limbs) {
+    di_stats_add(DI_STAT_ALLOCS, mallocs);
+    di_stats_add(DI_STAT_BYTES, bytes);
+    if (ints) di_stats_live(DI_STAT_LIVE_INTS, DI_STAT_PEAK_INTS, (int64_t)ints);
+    if (limbs) di_stats_live(DI_STAT_LIVE_LIMBS, DI_STAT_PEAK_LIMBS, (int64_t)limbs);
+}
+
+static void di_stats_count_op(di_stats_op op, size_t limbs) {
+    di_stats_block* block = di_stats_block_get();
+    di_stat_t* c = &block->counters[DI_STAT_OPS + 2 * (int)op];
+    DI_STAT_STORE(c[0], DI_STAT_LOAD(c[0]) + 1);
+    DI_STAT_STORE(c[1], DI_STAT_LOAD(c[1]) + limbs);
+}
+
+#define DI_STATS_ALLOC(mallocs, bytes, ints, limbs) di_stats_alloc((mallocs), (bytes), (ints), (limbs))
+#define DI_STATS_REALLOC(bytes, limbs)                                             \
+    (di_stats_add(DI_STAT_REALLOCS, 1), di_stats_add(DI_STAT_BYTES, (bytes)),     \
+     di_stats_live(DI_STAT_LIVE_LIMBS, DI_STAT_PEAK_LIMBS, (int64_t)(limbs)))
+#define DI_STATS_FREE(frees, limbs)                                               \
+    (di_stats_add(DI_STAT_FREES, (frees)),                                        \
+     di_stats_live(DI_STAT_LIVE_INTS, DI_STAT_PEAK_INTS, -1),                     \
+     di_stats_live(DI_STAT_LIVE_LIMBS, DI_STAT_PEAK_LIMBS, -(int64_t)(limbs)))
+#define DI_STATS_FREE_SLAB() di_stats_add(DI_STAT_FREES, 2)
+#define DI_STATS_OP(op, limbs) di_stats_count_op((op), (limbs))
+#else
+#define DI_STATS_ALLOC(mallocs, bytes, ints, limbs) ((void)0)
+#define DI_STATS_REALLOC(bytes, limbs) ((void)0)
+#define DI_STATS_FREE(frees, limbs) ((void)0)
+#define DI_STATS_FREE_SLAB() ((void)0)
+#define DI_STATS_OP(op, limbs) ((void)0)
+#endif
+
+DI_IMPL bool di_stats_get(di_stats* out) {
+    DI_ASSERT(out && "di_stats_get: output cannot be NULL");
+    memset(out, 0, sizeof(*out));
+#ifdef DI_STATS
+    uint64_t sum[DI_STAT_COUNT] = { 0 };
+    for (di_stat_node* node = di_stat_first(&di_stats_blocks); node; node = node->next) {
+        di_stats_block* block = (di_stats_block*)node;
+        for (int i = 0; i < DI_STAT_COUNT; i++) sum[i] += DI_STAT_LOAD(block->counters[i]);
+    }
+    out->allocs = sum[DI_STAT_ALLOCS];
+    out->frees = sum[DI_STAT_FREES];
+    out->reallocs = sum[DI_STAT_REALLOCS];
+    out->bytes = sum[DI_STAT_BYTES];
+    out->live_ints = sum[DI_STAT_LIVE_INTS];
+    out->peak_ints = sum[DI_STAT_PEAK_INTS];
+    out->live_limbs = sum[DI_STAT_LIVE_LIMBS];
+    out->peak_limbs = sum[DI_STAT_PEAK_LIMBS];
+    for (int op = 0; op < DI_STATS_OPS; op++) {
+        out->ops[op].calls = sum[DI_STAT_OPS + 2 * op];
+        out->ops[op].limbs = sum[DI_STAT_OPS + 2 * op + 1];
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+DI_IMPL void di_stats_reset(void) {
+#ifdef DI_STATS
+    for (di_stat_node* node = di_stat_first(&di_stats_blocks); node; node = node->next) {
+        di_stats_block* block = (di_stats_block*)node;
+        for (int i = 0; i < DI_STAT_COUNT; i++) {
+            if (i == DI_STAT_LIVE_INTS || i == DI_STAT_LIVE_LIMBS) continue;
+            DI_STAT_STORE(block->counters[i], 0);
+        }
+        // A thread that only freed has a negative live count; its peak stays 0
+        uint64_t ints = DI_STAT_LOAD(block->counters[DI_STAT_LIVE_INTS]);
+        uint64_t limbs = DI_STAT_LOAD(block->counters[DI_STAT_LIVE_LIMBS]);
+        DI_STAT_STORE(block->counters[DI_STAT_PEAK_INTS], (int64_t)ints > 0 ? ints : 0);
+        DI_STAT_STORE(block->counters[DI_STAT_PEAK_LIMBS], (int64_t)limbs > 0 ? limbs : 0);
+    }
+#endif
+}
+
+DI_IMPL const char* di_stats_op_name(di_stats_op op) {
+    static const char* const names[DI_STATS_OPS] = {
+        "add", "sub", "mul", "div", "mod", "mod_pow", "shift", "bitwise", "to_string", "from_string",
+        "pow", "gcd", "sqrt", "product", "factorial", "prime", "random_prime", "export", "import",
+        "batch", "vec"
+    };
+    return (unsigned)op < DI_STATS_OPS ? names[op] : "unknown";
+}
+
+// Tracing
+#ifdef DI_TRACE_DEFAULT
+#include <time.h>
+
+#ifndef DI_TRACE_CLOCK
+#define DI_TRACE_CLOCK() di_trace_clock()
+static uint64_t di_trace_clock(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+typedef struct {
+    di_stat_t count;
+    di_stat_t total_ns;
+    di_stat_t min_ns;               // UINT64_MAX until the first call
+    di_stat_t max_ns;
+    di_stat_t bins[DI_TRACE_LATENCY_BINS];
+} di_trace_cell;
+
+typedef struct di_trace_block {
+    di_stat_node node;              // First, so a block and its node share an address
+    di_trace_cell cells[DI_STATS_OPS][DI_TRACE_SIZE_BUCKETS];
+} di_trace_block;
+
+typedef struct {
+    di_trace_cell* cell;
+    uint64_t start;
+} di_trace_span;
+
+static di_stat_list di_trace_blocks;
+static DI_THREAD_LOCAL di_stat_node* di_trace_mine;
+
+static void di_trace_clear(di_stat_node* node) {
+    di_trace_block* block = (di_trace_block*)node;
+    for (int op = 0; op < DI_STATS_OPS; op++) {
+        for (int size = 0; size < DI_TRACE_SIZE_BUCKETS; size++) {
+            di_trace_cell* cell = &block->cells[op][size];
+            DI_STAT_STORE(cell->count, 0);
+            DI_STAT_STORE(cell->total_ns, 0);
+            DI_STAT_STORE(cell->min_ns, UINT64_MAX);
+            DI_STAT_STORE(cell->max_ns, 0);
+            for (int bin = 0; bin < DI_TRACE_LATENCY_BINS; bin++) DI_STAT_STORE(cell->bins[bin], 0);
+        }
+    }
+}
+
+static di_trace_block* di_trace_block_get(void) {
+    di_stat_node* block = di_trace_mine;
+    if (!block) {
+        block = di_stat_block_get(&di_trace_blocks, DI_STAT_LIST_TRACE, &di_trace_mine,
+                                  sizeof(di_trace_block), di_trace_clear);
+    }
+    return (di_trace_block*)block;
+}
+
+// Bit length of value, capped to the last bucket
+static int di_trace_bucket(uint64_t value, int buckets) {
+    int bits = 0;
+    while (value && bits < buckets - 1) {
+        value >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+static di_trace_span di_trace_begin(di_stats_op op, uint64_t limbs) {
+    di_trace_span span;
+    span.cell = &di_trace_block_get()->cells[op][di_trace_bucket(limbs, DI_TRACE_SIZE_BUCKETS)];
+    span.start = DI_TRACE_CLOCK();
+    return span;
+}
+
+static void di_trace_end(const di_trace_span* span) {
+    uint64_t ns = DI_TRACE_CLOCK() - span->start;
+    di_trace_cell* cell = span->cell;
+    di_stat_t* bin = &cell->bins[di_trace_bucket(ns, DI_TRACE_LATENCY_BINS)];
+    DI_STAT_STORE(cell->count, DI_STAT_LOAD(cell->count) + 1);
+    DI_STAT_STORE(cell->total_ns, DI_STAT_LOAD(cell->total_ns) + ns);
+    if (ns < DI_STAT_LOAD(cell->min_ns)) DI_STAT_STORE(cell->min_ns, ns);
+    if (ns > DI_STAT_LOAD(cell->max_ns)) DI_STAT_STORE(cell->max_ns, ns);
+    DI_STAT_STORE(*bin, DI_STAT_LOAD(*bin) + 1);
+}
+
+// Upper edge of the bin holding the q-th fraction of the calls
+static uint64_t di_trace_percentile(const di_trace_hist* hist, double q) {
+    uint64_t rank = (uint64_t)((double)hist->count * q + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    int bin = 0;
+    for (; bin < DI_TRACE_LATENCY_BINS - 1; bin++) {
+        seen += hist->bins[bin];
+        if (seen >= rank) break;
+    }
+    uint64_t edge = bin == 0 ? 0 : ((uint64_t)1 << bin) - 1;
+    if (edge > hist->max_ns) edge = hist->max_ns;
+    if (edge < hist->min_ns) edge = hist->min_ns;
+    return edge;
+}
+
+static void di_trace_write_stderr(void* ctx, const char* line) {
+    (void)ctx;
+    fputs(line, stderr);
+}
+#endif
+
+DI_IMPL bool di_trace_get(di_stats_op op, int size_bucket, di_trace_hist* out) {
+    DI_ASSERT(out && "di_trace_get: output cannot be NULL");
+    DI_ASSERT((unsigned)op < DI_STATS_OPS && "di_trace_get: invalid operation");
+    DI_ASSERT(size_bucket >= 0 && size_bucket < DI_TRACE_SIZE_BUCKETS && "di_trace_get: invalid size bucket");
+    memset(out, 0, sizeof(*out));
+#ifdef DI_TRACE_DEFAULT
+    uint64_t min_ns = UINT64_MAX;
+    for (di_stat_node* node = di_stat_first(&di_trace_blocks); node; node = node->next) {
+        di_trace_cell* cell = &((di_trace_block*)node)->cells[op][size_bucket];
+        out->count += DI_STAT_LOAD(cell->count);
+        out->total_ns += DI_STAT_LOAD(cell->total_ns);
+        uint64_t lo = DI_STAT_LOAD(cell->min_ns);
+        uint64_t hi = DI_STAT_LOAD(cell->max_ns);
+        if (lo < min_ns) min_ns = lo;
+        if (hi > out->max_ns) out->max_ns = hi;
+        for (int bin = 0; bin < DI_TRACE_LATENCY_BINS; bin++) out->bins[bin] += DI_STAT_LOAD(cell->bins[bin]);
+    }
+    out->min_ns = out->count ? min_ns : 0;
+    return true;
+#else
+    (void)op;
+    (void)size_bucket;
+    return false;
+#endif
+}
+
+DI_IMPL void di_trace_reset(void) {
+#ifdef DI_TRACE_DEFAULT
+    for (di_stat_node* node = di_stat_first(&di_trace_blocks); node; node = node->next) {
+        di_trace_clear(node);
+    }
+#endif
+}
+
+DI_IMPL bool di_trace_dump(di_trace_write_fn write, void* ctx) {
+#ifdef DI_TRACE_DEFAULT
+    if (!write) write = di_trace_write_stderr;
+    write(ctx, "op,size_min,size_max,count,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+    for (int op = 0; op < DI_STATS_OPS; op++) {
+        for (int size = 0; size < DI_TRACE_SIZE_BUCKETS; size++) {
+            di_trace_hist hist;
+            di_trace_get((di_stats_op)op, size, &hist);
+            if (hist.count == 0) continue;
+            uint64_t size_min = size == 0 ? 0 : (uint64_t)1 << (size - 1);
+            char size_max[24] = "";
+            if (size < DI_TRACE_SIZE_BUCKETS - 1) {
+                snprintf(size_max, sizeof(size_max), "%llu",
+                         (unsigned long long)(size == 0 ? 0 : ((uint64_t)1 << size) - 1));
+            }
+            char line[256];
+            snprintf(line, sizeof(line), "%s,%llu,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+                     di_stats_op_name((di_stats_op)op), (unsigned long long)size_min, size_max,
+                     (unsigned long long)hist.count, (unsigned long long)(hist.total_ns / hist.count),
+                     (unsigned long long)hist.min_ns,
+                     (unsigned long long)di_trace_percentile(&hist, 0.50),
+                     (unsigned long long)di_trace_percentile(&hist, 0.90),
+                     (unsigned long long)di_trace_percentile(&hist, 0.99),
+                     (unsigned long long)hist.max_ns);
+            write(ctx, line);
+        }
+    }
+    return true;
+#else
+    (void)write;
+    (void)ctx;
+    return false;
+#endif
+}
+
+/* Internal function declarations */
+static void di_resize_internal(struct di_int_internal* big, size_t new_capacity);
+static uint64_t di_splitmix64(uint64_t* state);
+
+/* Internal helper functions */
+
+static struct di_int_internal* di_alloc(size_t initial_capacity) {
+    struct di_int_internal* big = (struct di_int_internal*)DI_MALLOC(sizeof(struct di_int_internal));
+    DI_ASSERT(big && "di_alloc: memory allocation failed");
+
+#ifdef DI_THREADSAFE
+    atomic_init(&big->ref_count, 1);
+#else
+    big->ref_count = 1;
+#endif
+    big->limb_count = 0;
+    big->limb_capacity = initial_capacity;
+    big->is_negative = false;
+    big->slab_limbs = false;
+    big->slab = NULL;
+
+    if (initial_capacity > 0) {
+        big->limbs = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * initial_capacity);
+        DI_ASSERT(big->limbs && "di_alloc: limb array allocation failed");
+        memset(big->limbs, 0, sizeof(di_limb_t) * initial_capacity);
+    } else {
+        big->limbs = NULL;
+    }
+    DI_STATS_ALLOC(initial_capacity > 0 ? 2 : 1,
+                   sizeof(struct di_int_internal) + sizeof(di_limb_t) * initial_capacity, 1, initial_capacity);
+    
+    return big;
+}
+
+static void di_normalize(struct di_int_internal* big) {
+    // Remove leading zeros
+    while (big->limb_count > 0 && big->limbs[big->limb_count - 1] == 0) {
+        big->limb_count--;
+    }
+    
+    // Zero should not be negative
+    if (big->limb_count == 0) {
+        big->is_negative = false;
+    }
+}
+
+DI_IMPL bool di_reserve(di_int big, size_t capacity) {
+    DI_ASSERT(big && "di_reserve: operand cannot be NULL");
+
+    di_resize_internal(big, capacity);
+    return true;
+}
+
+static void di_resize_internal(struct di_int_internal* big, size_t new_capacity) {
+    if (new_capacity <= big->limb_capacity) return;
+
+    di_limb_t* new_limbs;
+    if (big->slab_limbs) {
+        // Slab limbs cannot be reallocated; move them to their own block
+        new_limbs = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * new_capacity);
+        DI_ASSERT(new_limbs && "di_resize_internal: reallocation failed");
+        memcpy(new_limbs, big->limbs, sizeof(di_limb_t) * big->limb_capacity);
+        big->slab_limbs = false;
+        DI_STATS_ALLOC(1, sizeof(di_limb_t) * new_capacity, 0, new_capacity - big->limb_capacity);
+    } else {
+        new_limbs = (di_limb_t*)DI_REALLOC(big->limbs, sizeof(di_limb_t) * new_capacity);
+        DI_ASSERT(new_limbs && "di_resize_internal: reallocation failed");
+        DI_STATS_REALLOC(sizeof(di_limb_t) * new_capacity, new_capacity - big->limb_capacity);
+    }
+
+    // Zero out new limbs
+    memset(new_limbs + big->limb_capacity, 0, sizeof(di_limb_t) * (new_capacity - big->limb_capacity));
+
+    big->limbs = new_limbs;
+    big->limb_capacity = new_capacity;
+}
+
+/* Creation functions */
+
+// Limbs needed for any 64-bit value
+#define DI_INT64_LIMBS (64 / DI_LIMB_BITS)
+
+// Build an integer from a 64-bit magnitude, one limb at a time
+static di_int di_from_magnitude64(uint64_t magnitude, bool is_negative) {
+    size_t limb_count = 0;
+    for (uint64_t rest = magnitude; rest; rest >>= DI_LIMB_BITS) limb_count++;
+    struct di_int_internal* big = di_alloc(limb_count > 0 ? limb_count : 1);
+    for (size_t i = 0; i < limb_count; i++) {
+        big->limbs[i] = (di_limb_t)magnitude;
+        magnitude >>= DI_LIMB_BITS;
+    }
+    big->limb_count = limb_count;
+    big->is_negative = is_negative && limb_count > 0;
+    return big;
+}
+
+DI_IMPL di_int di_from_int32(int32_t value) {
+    // Negate in unsigned arithmetic so INT32_MIN needs no special case
+    uint32_t magnitude = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+    return di_from_magnitude64(magnitude, value < 0);
+}
+
+DI_IMPL di_int di_from_int64(int64_t value) {
+    // Negate in unsigned arithmetic so INT64_MIN needs no special case
+    uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    return di_from_magnitude64(magnitude, value < 0);
+}
+
+DI_IMPL di_int di_from_uint32(uint32_t value) {
+    return di_from_magnitude64(value, false);
+}
+
+DI_IMPL di_int di_from_uint64(uint64_t value) {
+    return di_from_magnitude64(value, false);
+}
+
+DI_IMPL di_int di_zero(void) {
+    return di_from_int32(0);
+}
+
+DI_IMPL di_int di_one(void) {
+    return di_from_int32(1);
+}
+
+DI_IMPL di_int di_copy(di_int big) {
+    DI_ASSERT(big && "di_copy: operand cannot be NULL");
+
+    struct di_int_internal* copy = di_alloc(big->limb_capacity);
+    
+    copy->limb_count = big->limb_count;
+    copy->is_negative = big->is_negative;
+    if (big->limb_count > 0) {
+        memcpy(copy->limbs, big->limbs, sizeof(di_limb_t) * big->limb_count);
+    }
+    
+    return copy;
+}
+
+static di_int di_from_string_internal(const char* str, int base) {
+    // Skip whitespace
+    while (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r') str++;
+    DI_ASSERT(*str != '\0' && "di_from_string: empty string");
+    
+    // Check for sign
+    bool is_negative = false;
+    if (*str == '-') {
+        is_negative = true;
+        str++;
+    } else if (*str == '+') {
+        str++;
+    }
+    
+    // Skip leading zeros
+    while (*str == '0') str++;
+    if (*str == '\0') return di_zero();
+    
+    // Count valid digits to estimate capacity
+    const char* p = str;
+    size_t digit_count = 0;
+    while (*p) {
+        char c = *p;
+        int digit_val;
+        if (c >= '0' && c <= '9') {
+            digit_val = c - '0';
+        } else if (c >= 'a' && c <= 'z') {
+            digit_val = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'Z') {
+            digit_val = c - 'A' + 10;
+        } else {
+            break; // Invalid character
+        }
+        
+        if (digit_val >= base) break; // Invalid digit for this base
+        digit_count++;
+        p++;
+    }
+    
+    if (digit_count == 0) return NULL;
+    
+    // Estimate capacity: log2(base^n) = n * log2(base) 
+    // Rough estimate: each decimal digit needs ~3.32 bits, so use digit_count limbs
+    size_t capacity = (digit_count + 7) / 8 + 1; // Conservative estimate
+    if (capacity < 1) capacity = 1;
+    
+    struct di_int_internal* result = di_alloc(capacity);
+    DI_ASSERT(result && "di_from_string: allocation failed");
+    
+    // Convert digit by digit using Horner's method: result = result * base + digit
+    di_int base_big = di_from_int32(base);
+    DI_ASSERT(base_big && "di_from_string: base allocation failed");
+    
+    p = str;
+    for (size_t i = 0; i < digit_count; i++) {
+        char c = *p++;
+        int digit_val;
+        if (c >= '0' && c <= '9') {
+            digit_val = c - '0';
+        } else if (c >= 'a' && c <= 'z') {
+            digit_val = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'Z') {
+            digit_val = c - 'A' + 10;
+        } else {
+            break;
+        }
+        
+        // result = result * base + digit
+        di_int temp = di_mul(result, base_big);
+        DI_ASSERT(temp && "di_from_string: multiplication allocation failed");
+        
+        di_int digit_big = di_from_int32(digit_val);
+        DI_ASSERT(digit_big && "di_from_string: digit allocation failed");
+        
+        di_int new_result = di_add(temp, digit_big);
+        di_release(&temp);
+        di_release(&digit_big);
+        
+        DI_ASSERT(new_result && "di_from_string: addition allocation failed");
+        
+        di_release((di_int*)&result);
+        result = new_result;
+    }
+    
+    di_release(&base_big);
+    
+    // Set sign
+    if (is_negative && result->limb_count > 0) {
+        result->is_negative = true;
+    }
+    
+    return result;
+}
+
+DI_IMPL di_int di_from_string(const char* str, int base) {
+    DI_ASSERT(str && "di_from_string: string cannot be NULL");
+    DI_ASSERT(base >= 2 && base <= 36 && "di_from_string: invalid base");
+    DI_TRACE_BEGIN(DI_STATS_FROM_STRING, strlen(str), 0);
+    di_int result = di_from_string_internal(str, base);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_FROM_STRING, result ? result->limb_count : 0);
+    return result;
+}
+
+/* Reference counting */
+
+DI_IMPL di_int di_retain(di_int big) {
+    DI_ASSERT(big && "di_retain: operand cannot be NULL");
+#ifdef DI_THREADSAFE
+    // No fast path here: other threads may retain through a borrowed handle
+    atomic_fetch_add_explicit(&big->ref_count, 1, memory_order_relaxed);
+#else
+    big->ref_count++;
+#endif
+    return big;
+}
+
+// Drop one reference, returning true when it was the last one
+static bool di_refcount_drop(di_refcount_t* count) {
+#ifdef DI_THREADSAFE
+    // Releasing the last reference means no other thread may still use the
+    // object, so a count of 1 proves it is unshared and the RMW can be skipped
+    if (atomic_load_explicit(count, memory_order_acquire) == 1) {
+        return true;
+    }
+    if (atomic_fetch_sub_explicit(count, 1, memory_order_release) == 1) {
+        atomic_thread_fence(memory_order_acquire);
+        return true;
+    }
+    return false;
+#else
+    return --*count == 0;
+#endif
+}
+
+DI_IMPL void di_release(di_int* big) {
+    if (!big || !*big) return;
+    
+    struct di_int_internal* b = *big;
+    if (di_refcount_drop(&b->ref_count)) {
+        DI_STATS_FREE((b->limbs && !b->slab_limbs) + !b->slab, b->limb_capacity);
+        if (b->limbs && !b->slab_limbs) {
+            DI_FREE(b->limbs);
+        }
+        if (!b->slab) {
+            DI_FREE(b);
+        } else if (di_refcount_drop(&b->slab->live)) {
+            DI_STATS_FREE_SLAB();
+            DI_FREE(b->slab->limbs);
+            DI_FREE(b->slab);
+        }
+    }
+    *big = NULL;
+}
+
+DI_IMPL size_t di_ref_count(di_int big) {
+    DI_ASSERT(big && "di_ref_count: operand cannot be NULL");
+#ifdef DI_THREADSAFE
+    return atomic_load_explicit(&big->ref_count, memory_order_relaxed);
+#else
+    return big->ref_count;
+#endif
+}
+
+/* Read-only views */
+
+DI_IMPL di_view di_view_of(di_int big) {
+    DI_ASSERT(big && "di_view_of: operand cannot be NULL");
+    di_view view = { big->limbs, big->limb_count, big->is_negative && big->limb_count > 0 };
+    return view;
+}
+
+DI_IMPL di_view di_view_from_limbs(const di_limb_t* limbs, size_t limb_count, bool is_negative) {
+    DI_ASSERT((limbs || limb_count == 0) && "di_view_from_limbs: limbs cannot be NULL");
+
+    // Trim leading zeros without touching the data
+    while (limb_count > 0 && limbs[limb_count - 1] == 0) {
+        limb_count--;
+    }
+    di_view view = { limbs, limb_count, is_negative && limb_count > 0 };
+    return view;
+}
+
+DI_IMPL di_int di_from_view(di_view view) {
+    struct di_int_internal* result = di_alloc(view.limb_count > 0 ? view.limb_count : 1);
+    if (view.limb_count > 0) {
+        memcpy(result->limbs, view.limbs, sizeof(di_limb_t) * view.limb_count);
+    }
+    result->limb_count = view.limb_count;
+    result->is_negative = view.is_negative;
+    di_normalize(result);
+    return result;
+}
+
+/* Comparison functions */
+
+DI_IMPL int di_compare(di_int a, di_int b) {
+    DI_ASSERT(a && "di_compare: first operand cannot be NULL");
+    DI_ASSERT(b && "di_compare: second operand cannot be NULL");
+    return di_view_compare(di_view_of(a), di_view_of(b));
+}
+
+DI_IMPL int di_view_compare(di_view a, di_view b) {
+    // Compare signs
+    if (a.is_negative != b.is_negative) {
+        return a.is_negative ? -1 : 1;
+    }
+    
+    // Same sign, compare magnitudes
+    if (a.limb_count != b.limb_count) {
+        int mag_cmp = (a.limb_count > b.limb_count) ? 1 : -1;
+        return a.is_negative ? -mag_cmp : mag_cmp;
+    }
+    
+    // Same number of limbs, compare from most significant
+    for (size_t i = a.limb_count; i > 0; i--) {
+        if (a.limbs[i-1] > b.limbs[i-1]) {
+            return a.is_negative ? -1 : 1;
+        }
+        if (a.limbs[i-1] < b.limbs[i-1]) {
+            return a.is_negative ? 1 : -1;
+        }
+    }
+    
+    return 0;  // Equal
+}
+
+DI_IMPL bool di_eq(di_int a, di_int b) {
+    return di_compare(a, b) == 0;
+}
+
+DI_IMPL bool di_lt(di_int a, di_int b) {
+    return di_compare(a, b) < 0;
+}
+
+DI_IMPL bool di_le(di_int a, di_int b) {
+    return di_compare(a, b) <= 0;
+}
+
+DI_IMPL bool di_gt(di_int a, di_int b) {
+    return di_compare(a, b) > 0;
+}
+
+DI_IMPL bool di_ge(di_int a, di_int b) {
+    return di_compare(a, b) >= 0;
+}
+
+DI_IMPL bool di_is_zero(di_int big) {
+    DI_ASSERT(big && "di_is_zero: operand cannot be NULL");
+    return big->limb_count == 0;
+}
+
+DI_IMPL bool di_is_negative(di_int big) {
+    DI_ASSERT(big && "di_is_negative: operand cannot be NULL");
+    return big->is_negative && big->limb_count > 0;
+}
+
+DI_IMPL bool di_is_positive(di_int big) {
+    DI_ASSERT(big && "di_is_positive: operand cannot be NULL");
+    return !big->is_negative && big->limb_count > 0;
+}
+
+DI_IMPL bool di_is_one(di_int big) {
+    DI_ASSERT(big && "di_is_one: operand cannot be NULL");
+    if (big->is_negative || big->limb_count != 1) {
+        return false;
+    }
+    return big->limbs[0] == 1;
+}
+
+/* Conversion functions */
+
+// Read the magnitude of big if it fits in 64 bits
+static bool di_to_magnitude64(di_int big, uint64_t* magnitude) {
+    if (big->limb_count > DI_INT64_LIMBS) return false;
+    uint64_t value = 0;
+    for (size_t i = big->limb_count; i > 0; i--) {
+        value = (value << DI_LIMB_BITS) | big->limbs[i - 1];
+    }
+    *magnitude = value;
+    return true;
+}
+
+DI_IMPL bool di_to_int32(di_int big, int32_t* result) {
+    DI_ASSERT(big && "di_to_int32: integer cannot be NULL");
+    DI_ASSERT(result && "di_to_int32: result pointer cannot be NULL");
+    
+    uint64_t val;
+    if (!di_to_magnitude64(big, &val)) return false;
+    
+    if (big->is_negative) {
+        if (val > (uint64_t)INT32_MAX + 1) return false;
+        *result = (int32_t)((uint32_t)0 - (uint32_t)val);
+    } else {
+        if (val > INT32_MAX) return false;
+        *result = (int32_t)val;
+    }
+    
+    return true;
+}
+
+DI_IMPL bool di_to_int64(di_int big, int64_t* result) {
+    DI_ASSERT(big && "di_to_int64: integer cannot be NULL");
+    DI_ASSERT(result && "di_to_int64: result pointer cannot be NULL");
+    
+    uint64_t val;
+    if (!di_to_magnitude64(big, &val)) return false;
+    
+    if (big->is_negative) {
+        if (val > (uint64_t)INT64_MAX + 1) return false;
+        if (val == (uint64_t)INT64_MAX + 1) {
+            *result = INT64_MIN;
+        } else {
+            *result = -(int64_t)val;
+        }
+    } else {
+        if (val > INT64_MAX) return false;
+        *result = (int64_t)val;
+    }
+    
+    return true;
+}
+
+DI_IMPL bool di_to_uint32(di_int big, uint32_t* result) {
+    DI_ASSERT(big && "di_to_uint32: integer cannot be NULL");
+    DI_ASSERT(result && "di_to_uint32: result pointer cannot be NULL");
+    
+    // Negative numbers cannot be converted to unsigned
+    if (big->is_negative) return false;
+    
+    uint64_t val;
+    if (!di_to_magnitude64(big, &val) || val > UINT32_MAX) return false;
+    *result = (uint32_t)val;
+    return true;
+}
+
+DI_IMPL bool di_to_uint64(di_int big, uint64_t* result) {
+    DI_ASSERT(big && "di_to_uint64: integer cannot be NULL");
+    DI_ASSERT(result && "di_to_uint64: result pointer cannot be NULL");
+    
+    // Negative numbers cannot be converted to unsigned
+    if (big->is_negative) return false;
+    
+    return di_to_magnitude64(big, result);
+}
+
+DI_IMPL double di_to_double(di_int big) {
+    DI_ASSERT(big && "di_to_double: operand cannot be NULL");
+    if (big->limb_count == 0) return 0.0;
+    
+    double result = 0.0;
+    double base = 1.0;
+    
+    for (size_t i = 0; i < big->limb_count; i++) {
+        result += big->limbs[i] * base;
+        base *= (double)(DI_LIMB_MAX + 1ULL);
+    }
+    
+    return big->is_negative ? -result : result;
+}
+
+// Limb kernels
+// Hot loops call through a table of function pointers, chosen once per
+// process for the running CPU (di_kernels_get(), overridable with the
+// DI_CPU environment variable or di_set_cpu()). Every set computes the
+// same results; they differ only in speed.
+//   add_n/sub_n    r = a +/- b over n limbs, returning the carry/borrow
+//   mul_1          r = a * b over n limbs, returning the high limb
+//   addmul_1       r += a * b over n limbs, returning the high limb
+//   divrem_1       q = a / d over n limbs (q may be a), returning a % d
+//   mul_basecase   r[0..an + bn) = a * b for an >= bn, no overlap
+// The bitwise members are described with their kernels.
+
+typedef struct {
+    const char* name;
+    di_limb_t (*add_n)(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n);
+    di_limb_t (*sub_n)(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n);
+    di_limb_t (*mul_1)(di_limb_t* r, const di_limb_t* a, size_t n, di_limb_t b);
+    di_limb_t (*addmul_1)(di_limb_t* r, const di_limb_t* a, size_t n, di_limb_t b);
+    di_limb_t (*divrem_1)(di_limb_t* q, const di_limb_t* a, size_t n, di_limb_t d);
+    void (*mul_basecase)(di_limb_t* r, const di_limb_t* a, size_t an, const di_limb_t* b, size_t bn);
+    bool ifma;              // IFMA Montgomery kernel and later Karatsuba switch
+    void (*and_n)(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n);
+    void (*or_n)(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n);
+    void (*xor_n)(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n);
+    void (*not_n)(di_limb_t* r, const di_limb_t* a, size_t n);
+    di_limb_t (*shl_n)(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift);
+    void (*shr_n)(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift);
+} di_kernels;
+
+static const di_kernels* di_kernels_get(void);
+
+static di_limb_t di_add_n_scalar(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    di_dlimb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += (di_dlimb_t)a[i] + b[i];
+        r[i] = (di_limb_t)carry;
+        carry >>= DI_LIMB_BITS;
+    }
+    return (di_limb_t)carry;
+}
+
+static di_limb_t di_sub_n_scalar(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    di_limb_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        di_dlimb_t diff = (di_dlimb_t)a[i] - b[i] - borrow;
+        r[i] = (di_limb_t)diff;
+        borrow = (di_limb_t)((diff >> DI_LIMB_BITS) & 1);
+    }
+    return borrow;
+}
+
+static di_limb_t di_mul_1_scalar(di_limb_t* r, const di_limb_t* a, size_t n, di_limb_t b) {
+    di_dlimb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += (di_dlimb_t)a[i] * b;
+        r[i] = (di_limb_t)carry;
+        carry >>= DI_LIMB_BITS;
+    }
+    return (di_limb_t)carry;
+}
+
+static di_limb_t di_addmul_1_scalar(di_limb_t* r, const di_limb_t* a, size_t n, di_limb_t b) {
+    di_dlimb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += (di_dlimb_t)a[i] * b + r[i];
+        r[i] = (di_limb_t)carry;
+        carry >>= DI_LIMB_BITS;
+    }
+    return (di_limb_t)carry;
+}
+
+static di_limb_t di_divrem_1_scalar(di_limb_t* q, const di_limb_t* a, size_t n, di_limb_t d) {
+    di_dlimb_t rem = 0;
+    for (size_t i = n; i-- > 0;) {
+        di_dlimb_t cur = (rem << DI_LIMB_BITS) | a[i];
+        q[i] = (di_limb_t)(cur / d);
+        rem = cur % d;
+    }
+    return (di_limb_t)rem;
+}
+
+static void di_mul_basecase_scalar(di_limb_t* r, const di_limb_t* a, size_t an, const di_limb_t* b, size_t bn) {
+    r[an] = di_mul_1_scalar(r, a, an, b[0]);
+    for (size_t i = 1; i < bn; i++) {
+        r[i + an] = b[i] ? di_addmul_1_scalar(r + i, a, an, b[i]) : 0;
+    }
+}
+
+#if DI_LIMB_BITS == 32 && defined(__SIZEOF_INT128__)
+// Wide kernels: pairs of 32-bit limbs as one 64-bit word, with 128-bit
+// intermediates, halving the carry chain. Any 64-bit target qualifies.
+#define DI_WIDE_KERNELS 1
+
+__extension__ typedef unsigned __int128 di_qlimb_t;
+
+// Limb i of a pair is always the low half
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define DI_PAIR_ORDER(x) ((x) << 32 | (x) >> 32)
+#else
+#define DI_PAIR_ORDER(x) (x)
+#endif
+
+static uint64_t di_load_pair(const di_limb_t* p) {
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    return DI_PAIR_ORDER(x);
+}
+
+static void di_store_pair(di_limb_t* p, uint64_t x) {
+    x = DI_PAIR_ORDER(x);
+    memcpy(p, &x, sizeof(x));
+}
+
+static di_limb_t di_add_n_wide(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    di_qlimb_t carry = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        carry += (di_qlimb_t)di_load_pair(a + i) + di_load_pair(b + i);
+        di_store_pair(r + i, (uint64_t)carry);
+        carry >>= 64;
+    }
+    di_dlimb_t tail = (di_dlimb_t)carry;
+    if (i < n) {
+        tail += (di_dlimb_t)a[i] + b[i];
+        r[i] = (di_limb_t)tail;
+        tail >>= DI_LIMB_BITS;
+    }
+    return (di_limb_t)tail;
+}
+
+static di_limb_t di_sub_n_wide(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        di_qlimb_t diff = (di_qlimb_t)di_load_pair(a + i) - di_load_pair(b + i) - borrow;
+        di_store_pair(r + i, (uint64_t)diff);
+        borrow = (uint64_t)(diff >> 64) & 1;
+    }
+    if (i < n) {
+        di_dlimb_t diff = (di_dlimb_t)a[i] - b[i] - borrow;
+        r[i] = (di_limb_t)diff;
+        borrow = (diff >> DI_LIMB_BITS) & 1;
+    }
+    return (di_limb_t)borrow;
+}
+
+static di_limb_t di_mul_1_wide(di_limb_t* r, const di_limb_t* a, size_t n, di_limb_t b) {
+    di_qlimb_t carry = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        carry += (di_qlimb_t)di_load_pair(a + i) * b;
+        di_store_pair(r + i, (uint64_t)carry);
+        carry >>= 64;
+    }
+    di_dlimb_t tail = (di_dlimb_t)carry;
+    if (i < n) {
+        tail += (di_dlimb_t)a[i] * b;
+        r[i] = (di_limb_t)tail;
+        tail >>= DI_LIMB_BITS;
+    }
+    return (di_limb_t)tail;
+}
+
+static di_limb_t di_addmul_1_wide(di_limb_t* r, const di_limb_t* a, size_t n, di_limb_t b) {
+    di_qlimb_t carry = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        carry += (di_qlimb_t)di_load_pair(a + i) * b + di_load_pair(r + i);
+        di_store_pair(r + i, (uint64_t)carry);
+        carry >>= 64;
+    }
+    di_dlimb_t tail = (di_dlimb_t)carry;
+    if (i < n) {
+        tail += (di_dlimb_t)a[i] * b + r[i];
+        r[i] = (di_limb_t)tail;
+        tail >>= DI_LIMB_BITS;
+    }
+    return (di_limb_t)tail;
+}
+
+static void di_mul_basecase_wide(di_limb_t* r, const di_limb_t* a, size_t an, const di_limb_t* b, size_t bn) {
+    r[an] = di_mul_1_wide(r, a, an, b[0]);
+    for (size_t i = 1; i < bn; i++) {
+        r[i + an] = b[i] ? di_addmul_1_wide(r + i, a, an, b[i]) : 0;
+    }
+}
+#endif
+
+/* Helper function to compare magnitudes (ignoring sign) */
+static int di_compare_magnitude(di_view a, di_view b) {
+    if (a.limb_count > b.limb_count) return 1;
+    if (a.limb_count < b.limb_count) return -1;
+    
+    // Same number of limbs - compare from most significant
+    for (size_t i = a.limb_count; i > 0; i--) {
+        size_t idx = i - 1;
+        if (a.limbs[idx] > b.limbs[idx]) return 1;
+        if (a.limbs[idx] < b.limbs[idx]) return -1;
+    }
+    
+    return 0; // Equal magnitudes
+}
+
+/* Basic arithmetic implementations */
+
+DI_IMPL di_int di_add(di_int a, di_int b) {
+    DI_ASSERT(a != NULL && "di_add: first operand cannot be NULL");
+    DI_ASSERT(b != NULL && "di_add: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_ADD, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_ADD, a->limb_count, b->limb_count);
+    di_int result = di_view_add(di_view_of(a), di_view_of(b));
+    DI_TRACE_END();
+    return result;
+}
+
+// Write a + b into result, which needs max(a, b) + 1 limbs of capacity
+static void di_add_into(struct di_int_internal* result, di_view a, di_view b) {
+    const di_kernels* kernels = di_kernels_get();
+
+    // Simple implementation for same-sign addition
+    if (a.is_negative == b.is_negative) {
+        result->is_negative = a.is_negative;
+        
+        di_view longer = a.limb_count >= b.limb_count ? a : b;
+        di_view shorter = a.limb_count >= b.limb_count ? b : a;
+        di_limb_t carry = kernels->add_n(result->limbs, longer.limbs, shorter.limbs, shorter.limb_count);
+        for (size_t i = shorter.limb_count; i < longer.limb_count; i++) {
+            di_limb_t limb = (di_limb_t)(longer.limbs[i] + carry);
+            carry = (di_limb_t)(carry && limb == 0);
+            result->limbs[i] = limb;
+        }
+        
+        result->limbs[longer.limb_count] = carry;
+        result->limb_count = longer.limb_count + (carry ? 1 : 0);
+        
+        di_normalize(result);
+        return;
+    }
+    
+    // Different signs - subtract magnitudes
+    // First determine which has larger magnitude
+    int cmp = di_compare_magnitude(a, b);
+    
+    di_view larger = (cmp >= 0) ? a : b;
+    di_view smaller = (cmp >= 0) ? b : a;
+    
+    // Result takes sign of the larger magnitude operand
+    // If a has larger magnitude: result = a - b (sign of a)
+    // If b has larger magnitude: result = -(b - a) = b - a with opposite sign
+    bool result_negative = (cmp >= 0) ? a.is_negative : b.is_negative;
+    
+    // Subtract smaller magnitude from larger magnitude
+    result->is_negative = result_negative;
+    result->limb_count = larger.limb_count;
+    
+    di_limb_t borrow = kernels->sub_n(result->limbs, larger.limbs, smaller.limbs, smaller.limb_count);
+    for (size_t i = smaller.limb_count; i < larger.limb_count; i++) {
+        di_limb_t limb = larger.limbs[i];
+        result->limbs[i] = (di_limb_t)(limb - borrow);
+        borrow = (di_limb_t)(borrow && limb == 0);
+    }
+    
+    di_normalize(result);
+}
+
+DI_IMPL di_int di_view_add(di_view a, di_view b) {
+    struct di_int_internal* result = di_alloc(
+        (a.limb_count > b.limb_count ? a.limb_count : b.limb_count) + 1
+    );
+    di_add_into(result, a, b);
+    return result;
+}
+
+DI_IMPL di_int di_add_i32(di_int a, int32_t b) {
+    DI_ASSERT(a && "di_add_i32: operand cannot be NULL");
+    
+    // Convert int32 to big integer and use regular addition
+    di_int b_big = di_from_int32(b);
+    DI_ASSERT(b_big && "di_add_i32: allocation failed");
+    
+    di_int result = di_add(a, b_big);
+    di_release(&b_big);
+    return result;
+}
+
+DI_IMPL di_int di_sub(di_int a, di_int b) {
+    DI_ASSERT(a != NULL && "di_sub: first operand cannot be NULL");
+    DI_ASSERT(b != NULL && "di_sub: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_SUB, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_SUB, a->limb_count, b->limb_count);
+    di_int result = di_view_sub(di_view_of(a), di_view_of(b));
+    DI_TRACE_END();
+    return result;
+}
+
+DI_IMPL di_int di_view_sub(di_view a, di_view b) {
+    // a - b = a + (-b), flipping the sign of the view instead of copying b
+    b.is_negative = !b.is_negative && b.limb_count > 0;
+    return di_view_add(a, b);
+}
+
+DI_IMPL di_int di_sub_i32(di_int a, int32_t b) {
+    DI_ASSERT(a && "di_sub_i32: operand cannot be NULL");
+    
+    // Convert int32 to big integer and use regular subtraction
+    di_int b_big = di_from_int32(b);
+    DI_ASSERT(b_big && "di_sub_i32: allocation failed");
+    
+    di_int result = di_sub(a, b_big);
+    di_release(&b_big);
+    return result;
+}
+
+DI_IMPL di_int di_negate(di_int a) {
+    DI_ASSERT(a && "di_negate: operand cannot be NULL");
+    
+    di_int result = di_copy(a);
+    if (result && result->limb_count > 0) {
+        result->is_negative = !result->is_negative;
+    }
+    return result;
+}
+
+/* String conversion implementation */
+DI_IMPL char* di_to_string(di_int big, int base) {
+    DI_ASSERT(big && "di_to_string: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_TO_STRING, big->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_TO_STRING, big->limb_count, 0);
+    char* result = di_view_to_string(di_view_of(big), base);
+    DI_TRACE_END();
+    return result;
+}
+
+DI_IMPL char* di_view_to_string(di_view big, int base) {
+    DI_ASSERT(base >= 2 && base <= 36 && "di_to_string: invalid base");
+    
+    if (big.limb_count == 0) {
+        char* str = (char*)DI_MALLOC(2);
+        DI_ASSERT(str && "di_to_string: allocation failed for zero string");
+        str[0] = '0';
+        str[1] = '\0';
+        return str;
+    }
+    
+    // Simple implementation for base 10
+    if (base == 10) {
+        // Proper arbitrary precision decimal conversion using efficient modular arithmetic
+        size_t max_digits = big.limb_count * 10 + 10;
+        char* buffer = (char*)DI_MALLOC(max_digits);
+        DI_ASSERT(buffer && "di_to_string: buffer allocation failed");
+        
+        // Make a working copy
+        di_int work = di_from_view(big);
+
+        char* digits = (char*)DI_MALLOC(max_digits);
+        DI_ASSERT(digits && "di_to_string: digits allocation failed");
+        
+        size_t digit_count = 0;
+        
+        // Handle zero case
+        if (di_is_zero(work)) {
+            buffer[0] = '0';
+            buffer[1] = '\0';
+            DI_FREE(digits);
+            di_release(&work);
+            return buffer;
+        }
+        
+        // Extract digits using limb-level division by 10 (much more efficient than di_div)
+        while (!di_is_zero(work)) {
+            // Divide by 10 using limb arithmetic
+            di_dlimb_t remainder = 0;
+            for (int i = (int)work->limb_count - 1; i >= 0; i--) {
+                di_dlimb_t temp = remainder * ((di_dlimb_t)DI_LIMB_MAX + 1) + work->limbs[i];
+                work->limbs[i] = (di_limb_t)(temp / 10);
+                remainder = temp % 10;
+            }
+            
+            // Store the digit
+            digits[digit_count++] = '0' + (char)remainder;
+            
+            // Remove leading zeros
+            while (work->limb_count > 0 && work->limbs[work->limb_count - 1] == 0) {
+                work->limb_count--;
+            }
+        }
+        
+        // Build result string (digits are in reverse order)
+        size_t pos = 0;
+        if (big.is_negative) {
+            buffer[pos++] = '-';
+        }
+        
+        for (size_t i = digit_count; i > 0; i--) {
+            buffer[pos++] = digits[i - 1];
+        }
+        buffer[pos] = '\0';
+        
+        DI_FREE(digits);
+        di_release(&work);
+        
+        return buffer;
+    }
+    
+    return NULL;
+}
+
+// Hybrid numbers
+// Inline operands are viewed through limbs on the stack, so the slow path
+// allocates only for a result that does not fit int64_t (and for division,
+// which has no view form).
+
+static di_view di_num_view(const di_num* n, di_limb_t* limbs) {
+    if (n->big) return di_view_of(n->big);
+    uint64_t magnitude = n->small < 0 ? (uint64_t)0 - (uint64_t)n->small : (uint64_t)n->small;
+    for (int i = 0; i < DI_INT64_LIMBS; i++) {
+        limbs[i] = (di_limb_t)magnitude;
+        magnitude >>= DI_LIMB_BITS;
+    }
+    return di_view_from_limbs(limbs, DI_INT64_LIMBS, n->small < 0);
+}
+
+// Takes over the reference to big and demotes it when it fits
+static di_num di_num_wrap(di_int big) {
+    di_num n = { NULL, 0 };
+    if (di_to_int64(big, &n.small)) {
+        di_release(&big);
+    } else {
+        n.big = big;
+    }
+    return n;
+}
+
+DI_IMPL di_num di_num_from_int(di_int value) {
+    DI_ASSERT(value && "di_num_from_int: value cannot be NULL");
+    di_num n = { NULL, 0 };
+    if (!di_to_int64(value, &n.small)) n.big = di_retain(value);
+    return n;
+}
+
+DI_IMPL di_int di_num_to_int(di_num n) {
+    return n.big ? di_retain(n.big) : di_from_int64(n.small);
+}
+
+DI_IMPL di_num di_num_op_slow(di_num_op op, di_num a, di_num b) {
+    di_limb_t a_limbs[DI_INT64_LIMBS], b_limbs[DI_INT64_LIMBS];
+    di_view va = di_num_view(&a, a_limbs);
+    di_view vb = di_num_view(&b, b_limbs);
+    switch (op) {
+    case DI_NUM_ADD:
+        return di_num_wrap(di_view_add(va, vb));
+    case DI_NUM_SUB:
+        return di_num_wrap(di_view_sub(va, vb));
+    case DI_NUM_MUL:
+        return di_num_wrap(di_view_mul(va, vb));
+    case DI_NUM_DIV:
+    case DI_NUM_MOD:
+        break;
+    }
+    DI_ASSERT(vb.limb_count > 0 && "di_num_op_slow: division by zero");
+
+    // x / -1 only overflows for INT64_MIN, and x % -1 is always 0
+    di_num r = { NULL, 0 };
+    if (!a.big && !b.big && b.small == -1) {
+        if (op == DI_NUM_MOD || di_negate_overflow_int64(a.small, &r.small)) return r;
+    }
+    di_int x = di_num_to_int(a);
+    di_int y = di_num_to_int(b);
+    di_int result = op == DI_NUM_DIV ? di_div(x, y) : di_mod(x, y);
+    di_release(&x);
+    di_release(&y);
+    return di_num_wrap(result);
+}
+
+DI_IMPL int di_num_cmp_slow(di_num a, di_num b) {
+    di_limb_t a_limbs[DI_INT64_LIMBS], b_limbs[DI_INT64_LIMBS];
+    return di_view_compare(di_num_view(&a, a_limbs), di_num_view(&b, b_limbs));
+}
+
+DI_IMPL char* di_num_to_string(di_num n, int base) {
+    di_limb_t limbs[DI_INT64_LIMBS];
+    return di_view_to_string(di_num_view(&n, limbs), base);
+}
+
+// Fork-join task pool
+// di_task_spawn() queues work that may run on another thread and
+// di_task_wait() blocks until all of a group's tasks are done, running
+// queued tasks itself in the meantime. Each worker owns a deque: it pops
+// its newest task and, when empty, steals the oldest task of another
+// deque. Threads outside the pool share one extra deque. Without
+// DI_THREADS, or with di_set_threads(1), spawned tasks run immediately.
+
+typedef struct di_task_group di_task_group;
+
+#ifdef DI_THREADS
+typedef struct {
+    void (*fn)(void*);
+    void* arg;
+    di_task_group* group;
+} di_task;
+
+typedef struct {
+    pthread_mutex_t lock;
+    di_task* items;          // Ring buffer indexed by head/tail modulo cap
+    size_t head;             // Oldest task (stolen by other threads)
+    size_t tail;             // One past the newest task (popped by the owner)
+    size_t cap;
+} di_deque;
+
+typedef struct {
+    int workers;             // Pool threads; callers help while waiting
+    di_deque* deques;        // workers + 1, the last shared by outside threads
+    pthread_t* threads;
+    int started;             // Entries of threads that were created
+    pthread_mutex_t idle_lock;
+    pthread_cond_t idle_cond;
+    atomic_size_t queued;    // Tasks sitting in deques
+    atomic_bool stop;
+} di_pool;
+
+// Published with release order once the pool is ready; the lock only
+// serializes creation and shutdown
+static di_pool* _Atomic di_pool_instance = NULL;
+static pthread_mutex_t di_pool_init_lock = PTHREAD_MUTEX_INITIALIZER;
+static DI_THREAD_LOCAL int di_pool_self = -1;
+#endif
+
+struct di_task_group {
+#ifdef DI_THREADS
+    di_pool* pool;
+    atomic_size_t pending;
+#else
+    int unused;
+#endif
+};
+
+#ifdef DI_THREADS
+static atomic_int di_thread_count = 1;
+
+static void di_deque_push(di_deque* dq, di_task task) {
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail - dq->head == dq->cap) {
+        size_t cap = dq->cap ? dq->cap * 2 : 64;
+        di_task* items = (di_task*)DI_MALLOC(sizeof(di_task) * cap);
+        DI_ASSERT(items && "di_task_spawn: allocation failed");
+        for (size_t i = dq->head; i != dq->tail; i++) {
+            items[i % cap] = dq->items[i % dq->cap];
+        }
+        DI_FREE(dq->items);
+        dq->items = items;
+        dq->cap = cap;
+    }
+    dq->items[dq->tail++ % dq->cap] = task;
+    pthread_mutex_unlock(&dq->lock);
+}
+
+static bool di_deque_take(di_deque* dq, di_task* task, bool newest) {
+    bool found = false;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->tail != dq->head) {
+        *task = newest ? dq->items[--dq->tail % dq->cap] : dq->items[dq->head++ % dq->cap];
+        found = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+// Run one queued task, preferring our own deque; false if none was found
+static bool di_pool_run_one(di_pool* pool) {
+    int own = di_pool_self >= 0 ? di_pool_self : pool->workers;
+    int count = pool->workers + 1;
+    di_task task;
+    bool found = di_deque_take(&pool->deques[own], &task, true);
+    for (int i = 1; !found && i < count; i++) {
+        found = di_deque_take(&pool->deques[(own + i) % count], &task, false);
+    }
+    if (!found) return false;
+
+    atomic_fetch_sub_explicit(&pool->queued, 1, memory_order_relaxed);
+    task.fn(task.arg);
+    atomic_fetch_sub_explicit(&task.group->pending, 1, memory_order_release);
+    return true;
+}
+
+static void* di_pool_worker(void* arg) {
+    di_pool* pool = atomic_load_explicit(&di_pool_instance, memory_order_acquire);
+    di_pool_self = (int)(intptr_t)arg;
+    while (!atomic_load(&pool->stop)) {
+        if (di_pool_run_one(pool)) continue;
+        pthread_mutex_lock(&pool->idle_lock);
+        while (atomic_load(&pool->queued) == 0 && !atomic_load(&pool->stop)) {
+            pthread_cond_wait(&pool->idle_cond, &pool->idle_lock);
+        }
+        pthread_mutex_unlock(&pool->idle_lock);
+    }
+    return NULL;
+}
+
+// The shared pool, started on first use with di_get_threads() - 1 workers
+static di_pool* di_pool_get(void) {
+    int threads = atomic_load_explicit(&di_thread_count, memory_order_relaxed);
+    if (threads <= 1) return NULL;
+
+    di_pool* pool = atomic_load_explicit(&di_pool_instance, memory_order_acquire);
+    if (pool) return pool;
+
+    pthread_mutex_lock(&di_pool_init_lock);
+    pool = atomic_load_explicit(&di_pool_instance, memory_order_relaxed);
+    if (!pool) {
+        pool = (di_pool*)DI_MALLOC(sizeof(di_pool));
+        DI_ASSERT(pool && "di_pool_get: allocation failed");
+        pool->workers = threads - 1;
+        pool->deques = (di_deque*)DI_MALLOC(sizeof(di_deque) * (size_t)threads);
+        pool->threads = (pthread_t*)DI_MALLOC(sizeof(pthread_t) * (size_t)pool->workers);
+        DI_ASSERT(pool->deques && pool->threads && "di_pool_get: allocation failed");
+        for (int i = 0; i < threads; i++) {
+            pthread_mutex_init(&pool->deques[i].lock, NULL);
+            pool->deques[i].items = NULL;
+            pool->deques[i].head = pool->deques[i].tail = pool->deques[i].cap = 0;
+        }
+        pthread_mutex_init(&pool->idle_lock, NULL);
+        pthread_cond_init(&pool->idle_cond, NULL);
+        atomic_init(&pool->queued, 0);
+        atomic_init(&pool->stop, false);
+        pool->started = 0;
+        atomic_store_explicit(&di_pool_instance, pool, memory_order_release);
+
+        // A worker that fails to start is just missing; waiting callers
+        // still run every task
+        for (int i = 0; i < pool->workers; i++) {
+            if (pthread_create(&pool->threads[pool->started], NULL, di_pool_worker, (void*)(intptr_t)i) == 0) {
+                pool->started++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&di_pool_init_lock);
+    return pool;
+}
+
+static void di_pool_shutdown(void) {
+    pthread_mutex_lock(&di_pool_init_lock);
+    di_pool* pool = atomic_load_explicit(&di_pool_instance, memory_order_relaxed);
+    if (pool) {
+        pthread_mutex_lock(&pool->idle_lock);
+        atomic_store(&pool->stop, true);
+        pthread_cond_broadcast(&pool->idle_cond);
+        pthread_mutex_unlock(&pool->idle_lock);
+        for (int i = 0; i < pool->started; i++) {
+            pthread_join(pool->threads[i], NULL);
+        }
+        for (int i = 0; i <= pool->workers; i++) {
+            pthread_mutex_destroy(&pool->deques[i].lock);
+            DI_FREE(pool->deques[i].items);
+        }
+        pthread_mutex_destroy(&pool->idle_lock);
+        pthread_cond_destroy(&pool->idle_cond);
+        DI_FREE(pool->deques);
+        DI_FREE(pool->threads);
+        DI_FREE(pool);
+        atomic_store_explicit(&di_pool_instance, NULL, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&di_pool_init_lock);
+}
+#endif
+
+static void di_task_group_init(di_task_group* group) {
+#ifdef DI_THREADS
+    group->pool = di_pool_get();
+    atomic_init(&group->pending, 0);
+#else
+    (void)group;
+#endif
+}
+
+static void di_task_spawn(di_task_group* group, void (*fn)(void*), void* arg) {
+#ifdef DI_THREADS
+    di_pool* pool = group->pool;
+    if (pool) {
+        di_task task = { fn, arg, group };
+        atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+        di_deque_push(&pool->deques[di_pool_self >= 0 ? di_pool_self : pool->workers], task);
+        atomic_fetch_add_explicit(&pool->queued, 1, memory_order_relaxed);
+        pthread_mutex_lock(&pool->idle_lock);
+        pthread_cond_signal(&pool->idle_cond);
+        pthread_mutex_unlock(&pool->idle_lock);
+        return;
+    }
+#else
+    (void)group;
+#endif
+    fn(arg);
+}
+
+static void di_task_wait(di_task_group* group) {
+#ifdef DI_THREADS
+    di_pool* pool = group->pool;
+    if (!pool) return;
+    // Help out instead of blocking; our tasks may be anywhere in the pool
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+        if (!di_pool_run_one(pool)) sched_yield();
+    }
+#else
+    (void)group;
+#endif
+}
+
+// AVX-512 IFMA kernels
+// vpmadd52luq/vpmadd52huq multiply eight pairs of 52-bit digits and add
+// the low or high 52 bits of each 104-bit product to 64-bit lanes. These
+// kernels convert 32-bit limbs to radix 2^52 and let the lanes soak up
+// carries (12 spare bits cover DI_IFMA_MAX_DIGITS rows), normalizing once
+// at the end. Chosen at run time when the CPU reports avx512ifma.
+
+#if defined(DI_SIMD_X86) && DI_LIMB_BITS == 32
+#define DI_HAS_IFMA 1
+#define DI_TARGET_IFMA __attribute__((target("avx512f,avx512ifma")))
+#define DI_DIGIT_MASK ((UINT64_C(1) << 52) - 1)
+#define DI_IFMA_MAX_DIGITS 1024
+
+static bool di_ifma_supported(void) {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+}
+
+static size_t di_digits52(size_t limbs) {
+    return (limbs * 32 + 51) / 52;
+}
+
+static uint64_t di_limb_at(const di_limb_t* a, size_t an, size_t i) {
+    return i < an ? a[i] : 0;
+}
+
+// d[0..digits) = a in radix 2^52, zero-filled past the top of a
+static void di_to_digits52(uint64_t* d, size_t digits, const di_limb_t* a, size_t an) {
+    for (size_t i = 0; i < digits; i++) {
+        size_t bit = i * 52;
+        size_t limb = bit / 32;
+        unsigned shift = (unsigned)(bit % 32);
+        uint64_t v = (di_limb_at(a, an, limb) | di_limb_at(a, an, limb + 1) << 32) >> shift;
+        if (shift > 12) v |= di_limb_at(a, an, limb + 2) << (64 - shift);
+        d[i] = v & DI_DIGIT_MASK;
+    }
+}
+
+// r[0..rn) = low rn limbs of normalized digits d[0..digits)
+static void di_from_digits52(di_limb_t* r, size_t rn, const uint64_t* d, size_t digits) {
+    for (size_t i = 0; i < rn; i++) {
+        size_t bit = i * 32;
+        size_t digit = bit / 52;
+        unsigned shift = (unsigned)(bit % 52);
+        uint64_t v = digit < digits ? d[digit] >> shift : 0;
+        if (shift > 20 && digit + 1 < digits) v |= d[digit + 1] << (52 - shift);
+        r[i] = (di_limb_t)v;
+    }
+}
+
+// Propagate lane overflow so every digit is below 2^52
+static void di_digits52_normalize(uint64_t* d, size_t digits) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < digits; i++) {
+        uint64_t v = d[i] + carry;
+        d[i] = v & DI_DIGIT_MASK;
+        carry = v >> 52;
+    }
+}
+
+// r[0..an + bn) = a * b, an >= bn, bn digits <= DI_IFMA_MAX_DIGITS.
+// Product scanning: each group of eight output digits is summed in two
+// registers over the rows that reach it, then stored once.
+static DI_TARGET_IFMA void di_limbs_mul_ifma(di_limb_t* r, const di_limb_t* a, size_t an,
+                                             const di_limb_t* b, size_t bn) {
+    size_t ad = di_digits52(an), bd = di_digits52(bn);
+    size_t out = (ad + bd + 7) & ~(size_t)7;
+    // a is read at offsets down to -(bd + 1) and up to out + 7
+    size_t front = bd + 8;
+    uint64_t* block = (uint64_t*)DI_MALLOC(sizeof(uint64_t) * (front + out + 8 + bd + out));
+    DI_ASSERT(block && "di_limbs_mul_ifma: allocation failed");
+    uint64_t* ap = block + front;
+    uint64_t* bp = ap + out + 8;
+    uint64_t* acc = bp + bd;
+    memset(block, 0, sizeof(uint64_t) * front);
+    di_to_digits52(ap, out + 8, a, an);
+    di_to_digits52(bp, bd, b, bn);
+
+    for (size_t p = 0; p < out; p += 8) {
+        __m512i lo = _mm512_setzero_si512();
+        __m512i hi = _mm512_setzero_si512();
+        size_t j_end = p + 8 < bd ? p + 8 : bd;
+        size_t j_start = p > ad ? p - ad : 0;
+        for (size_t j = j_start; j < j_end; j++) {
+            __m512i bj = _mm512_set1_epi64((long long)bp[j]);
+            lo = _mm512_madd52lo_epu64(lo, _mm512_loadu_si512((const void*)(ap + p - j)), bj);
+            hi = _mm512_madd52hi_epu64(hi, _mm512_loadu_si512((const void*)(ap + p - j - 1)), bj);
+        }
+        _mm512_storeu_si512((void*)(acc + p), _mm512_add_epi64(lo, hi));
+    }
+    // GCC does not always emit vzeroupper before calls out of a target()
+    // function; dirty upper halves slow down the SSE code that runs next
+    _mm256_zeroupper();
+
+    di_digits52_normalize(acc, out);
+    di_from_digits52(r, an + bn, acc, out);
+    DI_FREE(block);
+}
+
+#endif
+
+// Limb-array multiplication kernels
+// di_limbs_mul writes all an + bn limbs of r, which must not overlap a or b.
+// Operands at least DI_KARATSUBA_THRESHOLD limbs long use Karatsuba;
+// a much longer operand is cut into pieces the size of the shorter one.
+
+static int di_limbs_cmp(const di_limb_t* a, const di_limb_t* b, size_t len) {
+    for (size_t i = len; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static di_limb_t di_limbs_sub(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t len) {
+    return di_kernels_get()->sub_n(r, a, b, len);
+}
+
+// r[0..rn) += a[0..an), an <= rn; returns the carry out of r
+static di_limb_t di_limbs_add_to(di_limb_t* r, size_t rn, const di_limb_t* a, size_t an) {
+    di_limb_t carry = di_kernels_get()->add_n(r, r, a, an);
+    for (size_t i = an; carry && i < rn; i++) {
+        r[i]++;
+        carry = r[i] == 0;
+    }
+    return carry;
+}
+
+// r[0..rn) -= a[0..an), an <= rn, result known to be non-negative
+static void di_limbs_sub_from(di_limb_t* r, size_t rn, const di_limb_t* a, size_t an) {
+    di_limb_t borrow = di_limbs_sub(r, r, a, an);
+    for (size_t i = an; borrow && i < rn; i++) {
+        borrow = r[i] == 0;
+        r[i]--;
+    }
+}
+
+static void di_limbs_mul(di_limb_t* r, const di_limb_t* a, size_t an, const di_limb_t* b, size_t bn) {
+    if (an < bn) {
+        const di_limb_t* t = a; a = b; b = t;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    // The IFMA basecase outruns Karatsuba far longer than the scalar one
+    const di_kernels* kernels = di_kernels_get();
+    size_t threshold = kernels->ifma && bn >= DI_IFMA_MUL_THRESHOLD ? DI_IFMA_KARATSUBA_THRESHOLD
+                                                                    : DI_KARATSUBA_THRESHOLD;
+    // Below 4 limbs the (m + 1)-limb middle product would not shrink
+    if (bn < threshold || bn < 4) {
+        kernels->mul_basecase(r, a, an, b, bn);
+        return;
+    }
+
+    size_t m = (an + 1) / 2;
+    if (bn <= m) {
+        // Unbalanced: multiply bn-limb slices of a by b and accumulate
+        di_limb_t* tmp = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * 2 * bn);
+        DI_ASSERT(tmp && "di_limbs_mul: allocation failed");
+        memset(r, 0, sizeof(di_limb_t) * (an + bn));
+        for (size_t off = 0; off < an; off += bn) {
+            size_t len = an - off < bn ? an - off : bn;
+            di_limbs_mul(tmp, a + off, len, b, bn);
+            di_limbs_add_to(r + off, an + bn - off, tmp, len + bn);
+        }
+        DI_FREE(tmp);
+        return;
+    }
+
+    // a = a1*B^m + a0, b = b1*B^m + b0, with a0 and b0 m limbs long:
+    // a*b = z2*B^2m + (z1 - z2 - z0)*B^m + z0, z1 = (a0 + a1)(b0 + b1)
+    size_t a1n = an - m, b1n = bn - m;
+    di_limb_t* sa = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * (4 * m + 4));
+    DI_ASSERT(sa && "di_limbs_mul: allocation failed");
+    di_limb_t* sb = sa + m + 1;
+    di_limb_t* z1 = sb + m + 1;
+
+    memcpy(sa, a, sizeof(di_limb_t) * m);
+    sa[m] = di_limbs_add_to(sa, m, a + m, a1n);
+    memcpy(sb, b, sizeof(di_limb_t) * m);
+    sb[m] = di_limbs_add_to(sb, m, b + m, b1n);
+
+    di_limbs_mul(r, a, m, b, m);
+    di_limbs_mul(r + 2 * m, a + m, a1n, b + m, b1n);
+    di_limbs_mul(z1, sa, m + 1, sb, m + 1);
+    di_limbs_sub_from(z1, 2 * m + 2, r, 2 * m);
+    di_limbs_sub_from(z1, 2 * m + 2, r + 2 * m, a1n + b1n);
+
+    // The middle term fits in an + bn - m limbs; anything above is zero
+    size_t z1n = 2 * m + 2;
+    if (z1n > an + bn - m) z1n = an + bn - m;
+    di_limbs_add_to(r + m, an + bn - m, z1, z1n);
+    DI_FREE(sa);
+}
+
+typedef struct {
+    di_limb_t* r;
+    const di_limb_t* a;
+    size_t an;
+    const di_limb_t* b;
+    size_t bn;
+} di_mul_task;
+
+static void di_mul_task_run(void* arg) {
+    di_mul_task* task = (di_mul_task*)arg;
+    di_limbs_mul(task->r, task->a, task->an, task->b, task->bn);
+}
+
+// Split the longer operand into one slice per thread, multiply the slices
+// as pool tasks into private buffers, then add them up on this thread
+static void di_limbs_mul_threaded(di_limb_t* r, const di_limb_t* a, size_t an, const di_limb_t* b, size_t bn) {
+    if (an < bn) {
+        const di_limb_t* t = a; a = b; b = t;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    size_t tasks = (size_t)di_get_threads();
+    if (tasks > an / DI_KARATSUBA_THRESHOLD) tasks = an / DI_KARATSUBA_THRESHOLD;
+    if (tasks <= 1 || bn < DI_MUL_THREAD_THRESHOLD) {
+        di_limbs_mul(r, a, an, b, bn);
+        return;
+    }
+
+    size_t chunk = (an + tasks - 1) / tasks;
+    tasks = (an + chunk - 1) / chunk;
+    di_mul_task* work = (di_mul_task*)DI_MALLOC(sizeof(di_mul_task) * tasks);
+    di_limb_t* partial = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * (an + tasks * bn));
+    DI_ASSERT(work && partial && "di_mul: allocation failed");
+    // Cleared so compilers that cannot prove tasks >= 2 here see no
+    // uninitialized read of work[0]
+    memset(work, 0, sizeof(di_mul_task) * tasks);
+
+    di_limb_t* out = partial;
+    for (size_t i = 0; i < tasks; i++) {
+        work[i].a = a + i * chunk;
+        work[i].an = i + 1 < tasks ? chunk : an - i * chunk;
+        work[i].b = b;
+        work[i].bn = bn;
+        work[i].r = out;
+        out += work[i].an + bn;
+    }
+
+    di_task_group group;
+    di_task_group_init(&group);
+    for (size_t i = 1; i < tasks; i++) {
+        di_task_spawn(&group, di_mul_task_run, &work[i]);
+    }
+    di_mul_task_run(&work[0]);
+    di_task_wait(&group);
+
+    memset(r, 0, sizeof(di_limb_t) * (an + bn));
+    for (size_t i = 0; i < tasks; i++) {
+        di_limbs_add_to(r + i * chunk, an + bn - i * chunk, work[i].r, work[i].an + bn);
+    }
+
+    DI_FREE(partial);
+    DI_FREE(work);
+}
+
+DI_IMPL void di_set_threads(int threads) {
+#ifdef DI_THREADS
+    if (threads < 1) threads = 1;
+    // Restart the pool at its new size on next use
+    if (atomic_exchange(&di_thread_count, threads) != threads) di_pool_shutdown();
+#else
+    (void)threads;
+#endif
+}
+
+DI_IMPL int di_get_threads(void) {
+#ifdef DI_THREADS
+    return atomic_load_explicit(&di_thread_count, memory_order_relaxed);
+#else
+    return 1;
+#endif
+}
+
+// Big integer multiplication - use the original working approach for single limb case, full algorithm for multi-limb
+DI_IMPL di_int di_mul(di_int a, di_int b) {
+    DI_ASSERT(a != NULL && "di_mul: first operand cannot be NULL");
+    DI_ASSERT(b != NULL && "di_mul: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_MUL, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_MUL, a->limb_count, b->limb_count);
+    di_int result = di_view_mul(di_view_of(a), di_view_of(b));
+    DI_TRACE_END();
+    return result;
+}
+
+// Write a * b into result, which needs a + b limbs of capacity (at least 1)
+static void di_mul_into(struct di_int_internal* result, di_view a, di_view b) {
+    // Handle zero cases
+    if (a.limb_count == 0 || b.limb_count == 0) {
+        result->limb_count = 0;
+        result->is_negative = false;
+        return;
+    }
+    
+    result->is_negative = (a.is_negative != b.is_negative);
+
+    // For single limb x single limb, use direct double-limb multiplication (exact)
+    if (a.limb_count == 1 && b.limb_count == 1) {
+        di_dlimb_t product = (di_dlimb_t)a.limbs[0] * (di_dlimb_t)b.limbs[0];
+        result->limbs[0] = (di_limb_t)(product & DI_LIMB_MAX);
+        result->limbs[1] = (di_limb_t)(product >> DI_LIMB_BITS);
+        result->limb_count = 2;
+        di_normalize(result);
+        return;
+    }
+    
+    // Multi-limb: Karatsuba above the threshold, threaded for huge operands
+    result->limb_count = a.limb_count + b.limb_count;
+    di_limbs_mul_threaded(result->limbs, a.limbs, a.limb_count, b.limbs, b.limb_count);
+    di_normalize(result);
+}
+
+DI_IMPL di_int di_view_mul(di_view a, di_view b) {
+    size_t capacity = a.limb_count + b.limb_count;
+    struct di_int_internal* result = di_alloc(capacity > 0 ? capacity : 1);
+    di_mul_into(result, a, b);
+    return result;
+}
+
+// Big integer multiplication by int32
+DI_IMPL di_int di_mul_i32(di_int a, int32_t b) {
+    DI_ASSERT(a && "di_mul_i32: operand cannot be NULL");
+    
+    di_int b_big = di_from_int32(b);
+    di_int result = di_mul(a, b_big);
+    di_release(&b_big);
+    return result;
+}
+
+// Fixed-capacity integers
+// Results are built in scratch limbs on the stack and copied into the
+// destination only when they fit, so a failed operation leaves it (and any
+// aliased operand) untouched. Only kernels that never allocate are used:
+// mul_basecase and di_limbs_mul are avoided because they may.
+
+// Copy a normalized magnitude into r if it fits
+static bool di_fixed_store(di_fixed* r, const di_limb_t* limbs, size_t limb_count, bool is_negative) {
+    if (limb_count > r->capacity) return false;
+    if (limb_count > 0) memmove(r->limbs, limbs, sizeof(di_limb_t) * limb_count);
+    r->limb_count = limb_count;
+    r->is_negative = limb_count > 0 && is_negative;
+    return true;
+}
+
+// Value of a digit character in base, or -1
+static int di_fixed_digit(char c, int base) {
+    int digit;
+    if (c >= '0' && c <= '9') {
+        digit = c - '0';
+    } else if (c >= 'a' && c <= 'z') {
+        digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'Z') {
+        digit = c - 'A' + 10;
+    } else {
+        return -1;
+    }
+    return digit < base ? digit : -1;
+}
+
+DI_IMPL void di_fixed_init(di_fixed* x, di_limb_t* limbs, size_t capacity) {
+    DI_ASSERT(x && limbs && "di_fixed_init: arguments cannot be NULL");
+    DI_ASSERT(capacity > 0 && capacity <= DI_FIXED_MAX_LIMBS && "di_fixed_init: invalid capacity");
+    x->limbs = limbs;
+    x->limb_count = 0;
+    x->capacity = capacity;
+    x->is_negative = false;
+}
+
+DI_IMPL bool di_fixed_set_int64(di_fixed* r, int64_t value) {
+    DI_ASSERT(r && "di_fixed_set_int64: destination cannot be NULL");
+    di_limb_t limbs[DI_INT64_LIMBS];
+    uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    size_t limb_count = 0;
+    while (magnitude) {
+        limbs[limb_count++] = (di_limb_t)magnitude;
+        magnitude >>= DI_LIMB_BITS;
+    }
+    return di_fixed_store(r, limbs, limb_count, value < 0);
+}
+
+DI_IMPL bool di_fixed_to_int64(const di_fixed* x, int64_t* result) {
+    DI_ASSERT(x && result && "di_fixed_to_int64: arguments cannot be NULL");
+    if (x->limb_count > DI_INT64_LIMBS) return false;
+
+    uint64_t magnitude = 0;
+    for (size_t i = x->limb_count; i > 0; i--) {
+        magnitude = (magnitude << DI_LIMB_BITS) | x->limbs[i - 1];
+    }
+
+    if (x->is_negative) {
+        if (magnitude > (uint64_t)INT64_MAX + 1) return false;
+        *result = magnitude == (uint64_t)INT64_MAX + 1 ? INT64_MIN : -(int64_t)magnitude;
+    } else {
+        if (magnitude > INT64_MAX) return false;
+        *result = (int64_t)magnitude;
+    }
+    return true;
+}
+
+DI_IMPL bool di_fixed_set_view(di_fixed* r, di_view view) {
+    DI_ASSERT(r && "di_fixed_set_view: destination cannot be NULL");
+    return di_fixed_store(r, view.limbs, view.limb_count, view.is_negative);
+}
+
+DI_IMPL di_view di_fixed_view(const di_fixed* x) {
+    DI_ASSERT(x && "di_fixed_view: integer cannot be NULL");
+    return di_view_from_limbs(x->limbs, x->limb_count, x->is_negative);
+}
+
+DI_IMPL int di_fixed_compare(const di_fixed* a, const di_fixed* b) {
+    DI_ASSERT(a && b && "di_fixed_compare: operands cannot be NULL");
+    return di_view_compare(di_fixed_view(a), di_fixed_view(b));
+}
+
+// r = a + b with b's sign optionally flipped
+static bool di_fixed_add_signed(di_fixed* r, const di_fixed* a, const di_fixed* b, bool negate_b) {
+    di_limb_t scratch[DI_FIXED_MAX_LIMBS + 1];
+    struct di_int_internal sum = { 0 };
+    sum.limbs = scratch;
+    sum.limb_capacity = DI_FIXED_MAX_LIMBS + 1;
+
+    di_view bv = di_fixed_view(b);
+    if (bv.limb_count > 0) bv.is_negative = bv.is_negative != negate_b;
+    di_add_into(&sum, di_fixed_view(a), bv);
+    return di_fixed_store(r, sum.limbs, sum.limb_count, sum.is_negative);
+}
+
+DI_IMPL bool di_fixed_add(di_fixed* r, const di_fixed* a, const di_fixed* b) {
+    DI_ASSERT(r && a && b && "di_fixed_add: arguments cannot be NULL");
+    return di_fixed_add_signed(r, a, b, false);
+}
+
+DI_IMPL bool di_fixed_sub(di_fixed* r, const di_fixed* a, const di_fixed* b) {
+    DI_ASSERT(r && a && b && "di_fixed_sub: arguments cannot be NULL");
+    return di_fixed_add_signed(r, a, b, true);
+}
+
+DI_IMPL bool di_fixed_mul(di_fixed* r, const di_fixed* a, const di_fixed* b) {
+    DI_ASSERT(r && a && b && "di_fixed_mul: arguments cannot be NULL");
+    if (a->limb_count == 0 || b->limb_count == 0) return di_fixed_store(r, NULL, 0, false);
+
+    // The product needs an + bn or an + bn - 1 limbs
+    if (a->limb_count + b->limb_count - 1 > r->capacity) return false;
+
+    const di_kernels* kernels = di_kernels_get();
+    di_limb_t scratch[2 * DI_FIXED_MAX_LIMBS];
+    size_t an = a->limb_count;
+    size_t bn = b->limb_count;
+    scratch[an] = kernels->mul_1(scratch, a->limbs, an, b->limbs[0]);
+    for (size_t i = 1; i < bn; i++) {
+        scratch[an + i] = kernels->addmul_1(scratch + i, a->limbs, an, b->limbs[i]);
+    }
+
+    size_t limb_count = an + bn;
+    while (limb_count > 0 && scratch[limb_count - 1] == 0) limb_count--;
+    return di_fixed_store(r, scratch, limb_count, a->is_negative != b->is_negative);
+}
+
+DI_IMPL bool di_fixed_shift_left(di_fixed* r, const di_fixed* a, size_t bits) {
+    DI_ASSERT(r && a && "di_fixed_shift_left: arguments cannot be NULL");
+    if (a->limb_count == 0) return di_fixed_store(r, NULL, 0, false);
+
+    size_t limb_shift = bits / DI_LIMB_BITS;
+    unsigned bit_shift = (unsigned)(bits % DI_LIMB_BITS);
+    if (limb_shift >= r->capacity || a->limb_count > r->capacity - limb_shift) return false;
+
+    di_limb_t scratch[DI_FIXED_MAX_LIMBS + 1];
+    size_t limb_count = a->limb_count + limb_shift;
+    memset(scratch, 0, sizeof(di_limb_t) * limb_shift);
+    if (bit_shift == 0) {
+        memcpy(scratch + limb_shift, a->limbs, sizeof(di_limb_t) * a->limb_count);
+    } else {
+        di_limb_t high = di_kernels_get()->shl_n(scratch + limb_shift, a->limbs, a->limb_count, bit_shift);
+        if (high) scratch[limb_count++] = high;
+    }
+    return di_fixed_store(r, scratch, limb_count, a->is_negative);
+}
+
+DI_IMPL bool di_fixed_shift_right(di_fixed* r, const di_fixed* a, size_t bits) {
+    DI_ASSERT(r && a && "di_fixed_shift_right: arguments cannot be NULL");
+    size_t limb_shift = bits / DI_LIMB_BITS;
+    unsigned bit_shift = (unsigned)(bits % DI_LIMB_BITS);
+    if (limb_shift >= a->limb_count) return di_fixed_store(r, NULL, 0, false);
+
+    di_limb_t scratch[DI_FIXED_MAX_LIMBS];
+    size_t limb_count = a->limb_count - limb_shift;
+    if (bit_shift == 0) {
+        memcpy(scratch, a->limbs + limb_shift, sizeof(di_limb_t) * limb_count);
+    } else {
+        di_kernels_get()->shr_n(scratch, a->limbs + limb_shift, limb_count, bit_shift);
+        if (scratch[limb_count - 1] == 0) limb_count--;
+    }
+    return di_fixed_store(r, scratch, limb_count, a->is_negative);
+}
+
+DI_IMPL bool di_fixed_from_string(di_fixed* r, const char* str, int base) {
+    DI_ASSERT(r && str && "di_fixed_from_string: arguments cannot be NULL");
+    DI_ASSERT(base >= 2 && base <= 36 && "di_fixed_from_string: invalid base");
+
+    while (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r') str++;
+    bool is_negative = *str == '-';
+    if (*str == '-' || *str == '+') str++;
+    if (di_fixed_digit(*str, base) < 0) return false;
+
+    // Horner's method: value = value * base + digit, one limb of headroom
+    const di_kernels* kernels = di_kernels_get();
+    di_limb_t value[DI_FIXED_MAX_LIMBS + 1];
+    di_limb_t next[DI_FIXED_MAX_LIMBS + 1];
+    size_t limb_count = 0;
+    int digit;
+    for (; (digit = di_fixed_digit(*str, base)) >= 0; str++) {
+        di_limb_t carry = kernels->mul_1(next, value, limb_count, (di_limb_t)base);
+        for (size_t i = 0; i < limb_count; i++) {
+            di_limb_t limb = (di_limb_t)(next[i] + (di_limb_t)digit);
+            digit = limb < next[i];
+            value[i] = limb;
+        }
+        carry = (di_limb_t)(carry + (di_limb_t)digit);
+        if (carry) {
+            if (limb_count == r->capacity) return false;
+            value[limb_count++] = carry;
+        }
+    }
+    return di_fixed_store(r, value, limb_count, is_negative);
+}
+
+DI_IMPL bool di_fixed_to_string(const di_fixed* x, int base, char* buf, size_t size) {
+    DI_ASSERT(x && buf && "di_fixed_to_string: arguments cannot be NULL");
+    DI_ASSERT(base >= 2 && base <= 36 && "di_fixed_to_string: invalid base");
+
+    // Digits come out least significant first, written from the end of buf
+    const di_kernels* kernels = di_kernels_get();
+    di_limb_t work[DI_FIXED_MAX_LIMBS];
+    size_t limb_count = x->limb_count;
+    if (limb_count > 0) memcpy(work, x->limbs, sizeof(di_limb_t) * limb_count);
+
+    size_t pos = size;
+    if (pos == 0) return false;
+    buf[--pos] = '\0';
+    do {
+        if (pos == 0) return false;
+        di_limb_t digit = limb_count ? kernels->divrem_1(work, work, limb_count, (di_limb_t)base) : 0;
+        buf[--pos] = "0123456789abcdefghijklmnopqrstuvwxyz"[digit];
+        while (limb_count > 0 && work[limb_count - 1] == 0) limb_count--;
+    } while (limb_count > 0);
+    if (x->is_negative) {
+        if (pos == 0) return false;
+        buf[--pos] = '-';
+    }
+
+    memmove(buf, buf + pos, size - pos);
+    return true;
+}
+
+// Batch operations
+// Results of one di_add_batch()/di_mul_batch() call share one slab of
+// headers and one block of limbs.
+// The element range is cut into pool tasks of about DI_BATCH_TASK_LIMBS
+// limb operations each; every task writes disjoint results.
+
+typedef enum {
+    DI_BATCH_ADD,
+    DI_BATCH_MUL,
+    DI_BATCH_CMP
+} di_batch_op;
+
+typedef struct {
+    di_batch_op op;
+    struct di_int_internal* results; // Slab results (add, mul)
+    int* cmp;                        // Comparison results (cmp)
+    const di_int* a;
+    const di_int* b;
+    size_t begin;
+    size_t end;
+} di_batch_job;
+
+static size_t di_batch_capacity(di_batch_op op, size_t an, size_t bn) {
+    if (op == DI_BATCH_ADD) return (an > bn ? an : bn) + 1;
+    return an + bn > 0 ? an + bn : 1;
+}
+
+// Rough limb-operation count, used only to size tasks
+static size_t di_batch_work(di_batch_op op, size_t an, size_t bn) {
+    if (op == DI_BATCH_MUL) return an * bn + 1;
+    return (an > bn ? an : bn) + 1;
+}
+
+static void di_batch_job_run(void* arg) {
+    di_batch_job* job = (di_batch_job*)arg;
+    for (size_t i = job->begin; i < job->end; i++) {
+        di_view a = di_view_of(job->a[i]);
+        di_view b = di_view_of(job->b[i]);
+        switch (job->op) {
+            case DI_BATCH_ADD: di_add_into(&job->results[i], a, b); break;
+            case DI_BATCH_MUL: di_mul_into(&job->results[i], a, b); break;
+            case DI_BATCH_CMP: job->cmp[i] = di_view_compare(a, b); break;
+        }
+    }
+}
 
-/* Internal structure */
-struct di_int_internal {
-    size_t ref_count;       // Reference count
-    di_limb_t* limbs;       // Array of limbs (little-endian)
-    size_t limb_count;      // Number of limbs used
-    size_t limb_capacity;   // Allocated capacity
-    bool is_negative;       // Sign flag
-};
+static void di_batch_run(di_batch_job whole, size_t total_work) {
+    if (di_get_threads() <= 1 || total_work < 2 * DI_BATCH_TASK_LIMBS) {
+        di_batch_job_run(&whole);
+        return;
+    }
 
-/* Internal function declarations */
-static void di_resize_internal(struct di_int_internal* big, size_t new_capacity);
+    // A job closes once it reaches DI_BATCH_TASK_LIMBS, bounding the count
+    size_t max_jobs = total_work / DI_BATCH_TASK_LIMBS + 1;
+    di_batch_job* jobs = (di_batch_job*)DI_MALLOC(sizeof(di_batch_job) * max_jobs);
+    DI_ASSERT(jobs && "di_batch_run: allocation failed");
+
+    di_task_group group;
+    di_task_group_init(&group);
+    size_t count = 0, work = 0;
+    jobs[0] = whole;
+    for (size_t i = whole.begin; i < whole.end; i++) {
+        work += di_batch_work(whole.op, whole.a[i]->limb_count, whole.b[i]->limb_count);
+        if (work >= DI_BATCH_TASK_LIMBS || i + 1 == whole.end) {
+            jobs[count].end = i + 1;
+            di_task_spawn(&group, di_batch_job_run, &jobs[count]);
+            count++;
+            if (i + 1 < whole.end) {
+                jobs[count] = whole;
+                jobs[count].begin = i + 1;
+            }
+            work = 0;
+        }
+    }
+    di_task_wait(&group);
+    DI_FREE(jobs);
+}
+
+static void di_batch_arith(di_batch_op op, di_int* out, const di_int* a, const di_int* b, size_t n) {
+    struct di_slab* slab = (struct di_slab*)DI_MALLOC(sizeof(struct di_slab) +
+        sizeof(struct di_int_internal) * n);
+    DI_ASSERT(slab && "di_batch: allocation failed");
+#ifdef DI_THREADSAFE
+    atomic_init(&slab->live, n);
+#else
+    slab->live = n;
+#endif
+
+    // Size every result while its operands are being read anyway, so the
+    // limb pointers can be handed out by a sequential walk of the slab
+    size_t total_limbs = 0, total_work = 0;
+    for (size_t i = 0; i < n; i++) {
+        struct di_int_internal* r = &slab->items[i];
+#ifdef DI_THREADSAFE
+        atomic_init(&r->ref_count, 1);
+#else
+        r->ref_count = 1;
+#endif
+        r->limb_count = 0;
+        r->limb_capacity = di_batch_capacity(op, a[i]->limb_count, b[i]->limb_count);
+        r->is_negative = false;
+        r->slab_limbs = true;
+        r->slab = slab;
+        total_limbs += r->limb_capacity;
+        total_work += di_batch_work(op, a[i]->limb_count, b[i]->limb_count);
+    }
+
+    slab->limbs = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * total_limbs);
+    DI_ASSERT(slab->limbs && "di_batch: allocation failed");
+    di_limb_t* limbs = slab->limbs;
+    for (size_t i = 0; i < n; i++) {
+        slab->items[i].limbs = limbs;
+        limbs += slab->items[i].limb_capacity;
+    }
+    DI_STATS_ALLOC(2, sizeof(struct di_slab) + sizeof(struct di_int_internal) * n +
+                   sizeof(di_limb_t) * total_limbs, n, total_limbs);
+
+    di_batch_job whole = { op, slab->items, NULL, a, b, 0, n };
+    di_batch_run(whole, total_work);
+
+    // Written last so out may be the same array as a or b
+    for (size_t i = 0; i < n; i++) {
+        out[i] = &slab->items[i];
+    }
+}
+
+// Total limbs of count integers
+static size_t di_ints_limbs(const di_int* values, size_t count) {
+    size_t limbs = 0;
+    for (size_t i = 0; i < count; i++) limbs += values[i]->limb_count;
+    return limbs;
+}
+
+DI_IMPL void di_add_batch(di_int* out, const di_int* a, const di_int* b, size_t n) {
+    if (n == 0) return;
+    DI_ASSERT(out && a && b && "di_add_batch: arrays cannot be NULL");
+    for (size_t i = 0; i < n; i++) {
+        DI_ASSERT(a[i] && b[i] && "di_add_batch: operand cannot be NULL");
+        DI_STATS_OP(DI_STATS_ADD, a[i]->limb_count + b[i]->limb_count);
+    }
+    DI_STATS_OP(DI_STATS_BATCH, di_ints_limbs(a, n) + di_ints_limbs(b, n));
+    DI_TRACE_BEGIN(DI_STATS_BATCH, di_ints_limbs(a, n), di_ints_limbs(b, n));
+    di_batch_arith(DI_BATCH_ADD, out, a, b, n);
+    DI_TRACE_END();
+}
+
+DI_IMPL void di_mul_batch(di_int* out, const di_int* a, const di_int* b, size_t n) {
+    if (n == 0) return;
+    DI_ASSERT(out && a && b && "di_mul_batch: arrays cannot be NULL");
+    for (size_t i = 0; i < n; i++) {
+        DI_ASSERT(a[i] && b[i] && "di_mul_batch: operand cannot be NULL");
+        DI_STATS_OP(DI_STATS_MUL, a[i]->limb_count + b[i]->limb_count);
+    }
+    DI_STATS_OP(DI_STATS_BATCH, di_ints_limbs(a, n) + di_ints_limbs(b, n));
+    DI_TRACE_BEGIN(DI_STATS_BATCH, di_ints_limbs(a, n), di_ints_limbs(b, n));
+    di_batch_arith(DI_BATCH_MUL, out, a, b, n);
+    DI_TRACE_END();
+}
+
+DI_IMPL void di_cmp_batch(int* out, const di_int* a, const di_int* b, size_t n) {
+    if (n == 0) return;
+    DI_ASSERT(out && a && b && "di_cmp_batch: arrays cannot be NULL");
+    size_t total_work = 0;
+    for (size_t i = 0; i < n; i++) {
+        DI_ASSERT(a[i] && b[i] && "di_cmp_batch: operand cannot be NULL");
+        total_work += di_batch_work(DI_BATCH_CMP, a[i]->limb_count, b[i]->limb_count);
+    }
+    DI_STATS_OP(DI_STATS_BATCH, di_ints_limbs(a, n) + di_ints_limbs(b, n));
+    DI_TRACE_BEGIN(DI_STATS_BATCH, di_ints_limbs(a, n), di_ints_limbs(b, n));
+    di_batch_job whole = { DI_BATCH_CMP, NULL, out, a, b, 0, n };
+    di_batch_run(whole, total_work);
+    DI_TRACE_END();
+}
+
+// Big integer division - returns quotient
+static di_int di_div_internal(di_int a, di_int b) {
+    // Special cases
+    if (di_is_zero(a)) return di_zero();
+    if (di_eq(a, b)) return di_one();
+    
+    // Compare absolute values
+    di_int abs_a = di_abs(a);
+    di_int abs_b = di_abs(b);
+    
+    if (di_lt(abs_a, abs_b)) {
+        di_release(&abs_a);
+        di_release(&abs_b);
+        // Floor division: a nonzero fraction below zero rounds down to -1
+        return a->is_negative != b->is_negative ? di_from_int32(-1) : di_zero();
+    }
+    
+    // Proper long division algorithm for efficiency
+    size_t dividend_limbs = abs_a->limb_count;
+    size_t divisor_limbs = abs_b->limb_count;
+    
+    // For single limb divisor, use optimized single-limb division
+    if (divisor_limbs == 1) {
+        di_limb_t divisor_limb = abs_b->limbs[0];
+        struct di_int_internal* quotient = di_alloc(dividend_limbs);
+        if (!quotient) {
+            di_release(&abs_a);
+            di_release(&abs_b);
+            return NULL;
+        }
+        
+        quotient->limb_count = dividend_limbs;
+        di_limb_t remainder = di_kernels_get()->divrem_1(quotient->limbs, abs_a->limbs,
+                                                         dividend_limbs, divisor_limb);
+        
+        di_normalize(quotient);
+        
+        // Set result sign and apply floor division semantics
+        bool result_negative = (a->is_negative != b->is_negative);
+        
+        // For floor division: if result would be negative and there's a remainder,
+        // we need to add 1 to the quotient magnitude (going more negative)
+        if (result_negative && remainder > 0 && quotient->limb_count > 0) {
+            // Add 1 to quotient magnitude for floor division
+            di_int one = di_one();
+            di_int adjusted_quotient = di_add(quotient, one);
+            di_release(&quotient);
+            di_release(&one);
+            quotient = adjusted_quotient;
+            quotient->is_negative = true;
+        } else if (result_negative && quotient->limb_count > 0) {
+            quotient->is_negative = true;
+        }
+        
+        di_release(&abs_a);
+        di_release(&abs_b);
+        return quotient;
+    }
+    
+    // For multi-limb division, fall back to binary long division (more efficient than repeated subtraction)
+    di_int quotient = di_zero();
+    di_int remainder = di_zero();
+    
+    // Process bits from most significant to least significant
+    for (int limb_idx = (int)dividend_limbs - 1; limb_idx >= 0; limb_idx--) {
+        for (int bit = DI_LIMB_BITS - 1; bit >= 0; bit--) {
+            // Shift remainder left by 1
+            di_int temp_remainder = di_shift_left(remainder, 1);
+            di_release(&remainder);
+            remainder = temp_remainder;
+            
+            // Add current bit of dividend to remainder
+            if (abs_a->limbs[limb_idx] & ((di_limb_t)1 << bit)) {
+                di_int temp = di_add_i32(remainder, 1);
+                di_release(&remainder);
+                remainder = temp;
+            }
+            
+            // Shift quotient left by 1
+            di_int temp_quotient = di_shift_left(quotient, 1);
+            di_release(&quotient);
+            quotient = temp_quotient;
+            
+            // If remainder >= divisor, subtract divisor and set bit in quotient
+            if (di_ge(remainder, abs_b)) {
+                di_int temp_remainder = di_sub(remainder, abs_b);
+                di_int temp_quotient = di_add_i32(quotient, 1);
+                di_release(&remainder);
+                di_release(&quotient);
+                remainder = temp_remainder;
+                quotient = temp_quotient;
+            }
+            
+            if (!remainder || !quotient) {
+                di_release(&abs_a);
+                di_release(&abs_b);
+                di_release(&remainder);
+                di_release(&quotient);
+                return NULL;
+            }
+        }
+    }
+    
+    // Implement floor division (Python-style)
+    bool result_negative = (a->is_negative != b->is_negative);
+    
+    // For floor division: if result would be negative and there's a remainder,
+    // we need to add 1 to the magnitude of the quotient (since we're going more negative)
+    if (result_negative && !di_is_zero(remainder) && quotient->limb_count > 0) {
+        // Add 1 to quotient magnitude for floor division
+        di_int one = di_one();
+        di_int adjusted_quotient = di_add(quotient, one);
+        di_release(&quotient);
+        di_release(&one);
+        quotient = adjusted_quotient;
+    }
+    
+    // Set the sign
+    if (result_negative && quotient->limb_count > 0) {
+        quotient->is_negative = true;
+    }
+    
+    di_release(&abs_a);
+    di_release(&abs_b);
+    di_release(&remainder);
+    
+    return quotient;
+}
+
+DI_IMPL di_int di_div(di_int a, di_int b) {
+    DI_ASSERT(a != NULL && "di_div: dividend cannot be NULL");
+    DI_ASSERT(b != NULL && "di_div: divisor cannot be NULL");
+    DI_ASSERT(!di_is_zero(b) && "di_div: division by zero");
+    DI_STATS_OP(DI_STATS_DIV, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_DIV, a->limb_count, b->limb_count);
+    di_int result = di_div_internal(a, b);
+    DI_TRACE_END();
+    return result;
+}
+
+// Big integer modulo - proper arbitrary precision implementation
+static di_int di_mod_internal(di_int a, di_int b) {
+    // Special cases
+    if (di_is_zero(a)) return di_zero(); // 0 % b = 0
+    if (di_eq(a, b)) return di_zero();   // a % a = 0
+    
+    // For floor modulo: remainder = a - (floor(a/b) * b)
+    // This ensures the remainder has the same sign as the divisor
+    di_int quotient = di_div(a, b);  // Use floor division
+    di_int product = di_mul(quotient, b);
+    di_int remainder = di_sub(a, product);
+    
+    di_release(&quotient);
+    di_release(&product);
+    
+    return remainder;
+}
+
+DI_IMPL di_int di_mod(di_int a, di_int b) {
+    DI_ASSERT(a != NULL && "di_mod: dividend cannot be NULL");
+    DI_ASSERT(b != NULL && "di_mod: divisor cannot be NULL");
+    DI_ASSERT(!di_is_zero(b) && "di_mod: modulo by zero");
+    DI_STATS_OP(DI_STATS_MOD, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_MOD, a->limb_count, b->limb_count);
+    di_int result = di_mod_internal(a, b);
+    DI_TRACE_END();
+    return result;
+}
+
+// Big integer absolute value
+DI_IMPL di_int di_abs(di_int a) {
+    DI_ASSERT(a && "di_abs: operand cannot be NULL");
+    
+    // If already positive or zero, just return a copy
+    if (!a->is_negative) {
+        return di_copy(a);
+    }
+    
+    // Create a positive copy of the negative number
+    di_int result = di_copy(a);
+    if (result && result->limb_count > 0) {
+        result->is_negative = false;
+    }
+    return result;
+}
+
+// Bitwise and shift kernels
+// Each operation has a portable loop and, where the compiler can target
+// them, AVX2, AVX-512 and NEON versions that process whole vectors and
+// leave the last few limbs to the portable loop; the kernel sets below
+// bundle them with the arithmetic loops. Binary operations cover the
+// common prefix of two operands only. Shifts take 0 < shift < DI_LIMB_BITS:
+// shl_n returns the bits shifted out of a[n - 1], shr_n treats the limb
+// above a[n - 1] as zero. Vector shifts are built for 32-bit limbs only.
+
+static void di_and_n_scalar(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) r[i] = a[i] & b[i];
+}
+
+static void di_or_n_scalar(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) r[i] = a[i] | b[i];
+}
+
+static void di_xor_n_scalar(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) r[i] = a[i] ^ b[i];
+}
+
+static void di_not_n_scalar(di_limb_t* r, const di_limb_t* a, size_t n) {
+    for (size_t i = 0; i < n; i++) r[i] = (di_limb_t)~a[i];
+}
+
+// r[i] for i in [from, to), from >= 1
+static void di_shl_range(di_limb_t* r, const di_limb_t* a, size_t from, size_t to, unsigned shift) {
+    for (size_t i = from; i < to; i++) {
+        r[i] = (di_limb_t)(a[i] << shift) | (di_limb_t)(a[i - 1] >> (DI_LIMB_BITS - shift));
+    }
+}
+
+// r[i] for i in [from, n)
+static void di_shr_range(di_limb_t* r, const di_limb_t* a, size_t from, size_t n, unsigned shift) {
+    for (size_t i = from; i + 1 < n; i++) {
+        r[i] = (di_limb_t)(a[i] >> shift) | (di_limb_t)(a[i + 1] << (DI_LIMB_BITS - shift));
+    }
+    if (from < n) r[n - 1] = (di_limb_t)(a[n - 1] >> shift);
+}
+
+static di_limb_t di_shl_n_scalar(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    r[0] = (di_limb_t)(a[0] << shift);
+    di_shl_range(r, a, 1, n, shift);
+    return (di_limb_t)(a[n - 1] >> (DI_LIMB_BITS - shift));
+}
+
+static void di_shr_n_scalar(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    di_shr_range(r, a, 0, n, shift);
+}
+
+#ifdef DI_SIMD_X86
+#define DI_TARGET_AVX2 __attribute__((target("avx2")))
+#define DI_TARGET_AVX512 __attribute__((target("avx512f")))
+#define DI_V256_LIMBS (32 / sizeof(di_limb_t))
+#define DI_V512_LIMBS (64 / sizeof(di_limb_t))
+
+#define DI_AVX2_BINOP(name, op, tail)                                                   \
+    static DI_TARGET_AVX2 void name(di_limb_t* r, const di_limb_t* a,                   \
+                                    const di_limb_t* b, size_t n) {                     \
+        size_t i = 0;                                                                   \
+        for (; i + DI_V256_LIMBS <= n; i += DI_V256_LIMBS) {                            \
+            __m256i x = _mm256_loadu_si256((const __m256i*)(const void*)(a + i));       \
+            __m256i y = _mm256_loadu_si256((const __m256i*)(const void*)(b + i));       \
+            _mm256_storeu_si256((__m256i*)(void*)(r + i), op(x, y));                    \
+        }                                                                               \
+        tail(r + i, a + i, b + i, n - i);                                               \
+    }
+
+#define DI_AVX512_BINOP(name, op, tail)                                                 \
+    static DI_TARGET_AVX512 void name(di_limb_t* r, const di_limb_t* a,                 \
+                                      const di_limb_t* b, size_t n) {                   \
+        size_t i = 0;                                                                   \
+        for (; i + DI_V512_LIMBS <= n; i += DI_V512_LIMBS) {                            \
+            __m512i x = _mm512_loadu_si512((const void*)(a + i));                       \
+            __m512i y = _mm512_loadu_si512((const void*)(b + i));                       \
+            _mm512_storeu_si512((void*)(r + i), op(x, y));                              \
+        }                                                                               \
+        tail(r + i, a + i, b + i, n - i);                                               \
+    }
+
+DI_AVX2_BINOP(di_and_n_avx2, _mm256_and_si256, di_and_n_scalar)
+DI_AVX2_BINOP(di_or_n_avx2, _mm256_or_si256, di_or_n_scalar)
+DI_AVX2_BINOP(di_xor_n_avx2, _mm256_xor_si256, di_xor_n_scalar)
+DI_AVX512_BINOP(di_and_n_avx512, _mm512_and_si512, di_and_n_scalar)
+DI_AVX512_BINOP(di_or_n_avx512, _mm512_or_si512, di_or_n_scalar)
+DI_AVX512_BINOP(di_xor_n_avx512, _mm512_xor_si512, di_xor_n_scalar)
+
+static DI_TARGET_AVX2 void di_not_n_avx2(di_limb_t* r, const di_limb_t* a, size_t n) {
+    __m256i ones = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + DI_V256_LIMBS <= n; i += DI_V256_LIMBS) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(const void*)(a + i));
+        _mm256_storeu_si256((__m256i*)(void*)(r + i), _mm256_xor_si256(x, ones));
+    }
+    di_not_n_scalar(r + i, a + i, n - i);
+}
+
+static DI_TARGET_AVX512 void di_not_n_avx512(di_limb_t* r, const di_limb_t* a, size_t n) {
+    __m512i ones = _mm512_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + DI_V512_LIMBS <= n; i += DI_V512_LIMBS) {
+        __m512i x = _mm512_loadu_si512((const void*)(a + i));
+        _mm512_storeu_si512((void*)(r + i), _mm512_xor_si512(x, ones));
+    }
+    di_not_n_scalar(r + i, a + i, n - i);
+}
+
+#if DI_LIMB_BITS == 32
+// Each output limb combines a[i] and its lower (left shift) or upper
+// (right shift) neighbour, read with a second unaligned load
+static DI_TARGET_AVX2 di_limb_t di_shl_n_avx2(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    __m128i left = _mm_cvtsi32_si128((int)shift);
+    __m128i right = _mm_cvtsi32_si128((int)(DI_LIMB_BITS - shift));
+    r[0] = a[0] << shift;
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        __m256i cur = _mm256_loadu_si256((const __m256i*)(const void*)(a + i));
+        __m256i low = _mm256_loadu_si256((const __m256i*)(const void*)(a + i - 1));
+        _mm256_storeu_si256((__m256i*)(void*)(r + i),
+                            _mm256_or_si256(_mm256_sll_epi32(cur, left), _mm256_srl_epi32(low, right)));
+    }
+    di_shl_range(r, a, i, n, shift);
+    return a[n - 1] >> (DI_LIMB_BITS - shift);
+}
+
+static DI_TARGET_AVX2 void di_shr_n_avx2(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    __m128i right = _mm_cvtsi32_si128((int)shift);
+    __m128i left = _mm_cvtsi32_si128((int)(DI_LIMB_BITS - shift));
+    size_t i = 0;
+    for (; i + 8 < n; i += 8) {
+        __m256i cur = _mm256_loadu_si256((const __m256i*)(const void*)(a + i));
+        __m256i high = _mm256_loadu_si256((const __m256i*)(const void*)(a + i + 1));
+        _mm256_storeu_si256((__m256i*)(void*)(r + i),
+                            _mm256_or_si256(_mm256_srl_epi32(cur, right), _mm256_sll_epi32(high, left)));
+    }
+    _mm256_zeroupper();     // Not emitted before the tail call
+    di_shr_range(r, a, i, n, shift);
+}
+
+static DI_TARGET_AVX512 di_limb_t di_shl_n_avx512(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    __m128i left = _mm_cvtsi32_si128((int)shift);
+    __m128i right = _mm_cvtsi32_si128((int)(DI_LIMB_BITS - shift));
+    r[0] = a[0] << shift;
+    size_t i = 1;
+    for (; i + 16 <= n; i += 16) {
+        __m512i cur = _mm512_loadu_si512((const void*)(a + i));
+        __m512i low = _mm512_loadu_si512((const void*)(a + i - 1));
+        _mm512_storeu_si512((void*)(r + i),
+                            _mm512_or_si512(_mm512_sll_epi32(cur, left), _mm512_srl_epi32(low, right)));
+    }
+    di_shl_range(r, a, i, n, shift);
+    return a[n - 1] >> (DI_LIMB_BITS - shift);
+}
 
-/* Internal helper functions */
+static DI_TARGET_AVX512 void di_shr_n_avx512(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    __m128i right = _mm_cvtsi32_si128((int)shift);
+    __m128i left = _mm_cvtsi32_si128((int)(DI_LIMB_BITS - shift));
+    size_t i = 0;
+    for (; i + 16 < n; i += 16) {
+        __m512i cur = _mm512_loadu_si512((const void*)(a + i));
+        __m512i high = _mm512_loadu_si512((const void*)(a + i + 1));
+        _mm512_storeu_si512((void*)(r + i),
+                            _mm512_or_si512(_mm512_srl_epi32(cur, right), _mm512_sll_epi32(high, left)));
+    }
+    _mm256_zeroupper();     // Not emitted before the tail call
+    di_shr_range(r, a, i, n, shift);
+}
+#else
+#define di_shl_n_avx2 di_shl_n_scalar
+#define di_shr_n_avx2 di_shr_n_scalar
+#define di_shl_n_avx512 di_shl_n_scalar
+#define di_shr_n_avx512 di_shr_n_scalar
+#endif
 
-static struct di_int_internal* di_alloc(size_t initial_capacity) {
-    struct di_int_internal* big = (struct di_int_internal*)DI_MALLOC(sizeof(struct di_int_internal));
-    DI_ASSERT(big && "di_alloc: memory allocation failed");
+#endif // DI_SIMD_X86
+
+#ifdef DI_SIMD_NEON
+// NEON is part of AArch64, so no runtime check is needed
+#define DI_V128_LIMBS (16 / sizeof(di_limb_t))
+
+#define DI_NEON_BINOP(name, op, tail)                                                   \
+    static void name(di_limb_t* r, const di_limb_t* a, const di_limb_t* b, size_t n) {  \
+        size_t i = 0;                                                                   \
+        for (; i + DI_V128_LIMBS <= n; i += DI_V128_LIMBS) {                            \
+            uint8x16_t x = vld1q_u8((const uint8_t*)(a + i));                           \
+            uint8x16_t y = vld1q_u8((const uint8_t*)(b + i));                           \
+            vst1q_u8((uint8_t*)(r + i), op(x, y));                                      \
+        }                                                                               \
+        tail(r + i, a + i, b + i, n - i);                                               \
+    }
 
-    big->ref_count = 1;
-    big->limb_count = 0;
-    big->limb_capacity = initial_capacity;
-    big->is_negative = false;
+DI_NEON_BINOP(di_and_n_neon, vandq_u8, di_and_n_scalar)
+DI_NEON_BINOP(di_or_n_neon, vorrq_u8, di_or_n_scalar)
+DI_NEON_BINOP(di_xor_n_neon, veorq_u8, di_xor_n_scalar)
 
-    if (initial_capacity > 0) {
-        big->limbs = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * initial_capacity);
-        DI_ASSERT(big->limbs && "di_alloc: limb array allocation failed");
-        memset(big->limbs, 0, sizeof(di_limb_t) * initial_capacity);
-    } else {
-        big->limbs = NULL;
+static void di_not_n_neon(di_limb_t* r, const di_limb_t* a, size_t n) {
+    size_t i = 0;
+    for (; i + DI_V128_LIMBS <= n; i += DI_V128_LIMBS) {
+        vst1q_u8((uint8_t*)(r + i), vmvnq_u8(vld1q_u8((const uint8_t*)(a + i))));
     }
-    
-    return big;
+    di_not_n_scalar(r + i, a + i, n - i);
 }
 
-static void di_normalize(struct di_int_internal* big) {
-    // Remove leading zeros
-    while (big->limb_count > 0 && big->limbs[big->limb_count - 1] == 0) {
-        big->limb_count--;
+#if DI_LIMB_BITS == 32
+// vshlq_u32 shifts right for negative counts
+static di_limb_t di_shl_n_neon(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    int32x4_t left = vdupq_n_s32((int32_t)shift);
+    int32x4_t right = vdupq_n_s32(-(int32_t)(DI_LIMB_BITS - shift));
+    r[0] = a[0] << shift;
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t cur = vld1q_u32(a + i);
+        uint32x4_t low = vld1q_u32(a + i - 1);
+        vst1q_u32(r + i, vorrq_u32(vshlq_u32(cur, left), vshlq_u32(low, right)));
     }
-    
-    // Zero should not be negative
-    if (big->limb_count == 0) {
-        big->is_negative = false;
+    di_shl_range(r, a, i, n, shift);
+    return a[n - 1] >> (DI_LIMB_BITS - shift);
+}
+
+static void di_shr_n_neon(di_limb_t* r, const di_limb_t* a, size_t n, unsigned shift) {
+    int32x4_t right = vdupq_n_s32(-(int32_t)shift);
+    int32x4_t left = vdupq_n_s32((int32_t)(DI_LIMB_BITS - shift));
+    size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        uint32x4_t cur = vld1q_u32(a + i);
+        uint32x4_t high = vld1q_u32(a + i + 1);
+        vst1q_u32(r + i, vorrq_u32(vshlq_u32(cur, right), vshlq_u32(high, left)));
     }
+    di_shr_range(r, a, i, n, shift);
 }
+#else
+#define di_shl_n_neon di_shl_n_scalar
+#define di_shr_n_neon di_shr_n_scalar
+#endif
+#endif // DI_SIMD_NEON
+
+// Kernel sets
+// Each set pairs the widest arithmetic loops the target compiles with one
+// family of bitwise kernels. di_kernels_get() picks the first supported
+// set in di_kernel_sets on first use, unless DI_CPU names another.
+
+#ifdef DI_WIDE_KERNELS
+#define DI_ARITH_KERNELS(suffix)                                                        \
+    .add_n = di_add_n_wide, .sub_n = di_sub_n_wide, .mul_1 = di_mul_1_wide,             \
+    .addmul_1 = di_addmul_1_wide, .divrem_1 = di_divrem_1_scalar,                       \
+    .mul_basecase = di_mul_basecase_##suffix
+#define di_mul_basecase_fast di_mul_basecase_wide
+#else
+#define DI_ARITH_KERNELS(suffix)                                                        \
+    .add_n = di_add_n_scalar, .sub_n = di_sub_n_scalar, .mul_1 = di_mul_1_scalar,       \
+    .addmul_1 = di_addmul_1_scalar, .divrem_1 = di_divrem_1_scalar,                     \
+    .mul_basecase = di_mul_basecase_##suffix
+#define di_mul_basecase_fast di_mul_basecase_scalar
+#endif
 
-DI_IMPL bool di_reserve(di_int big, size_t capacity) {
-    DI_ASSERT(big && "di_reserve: operand cannot be NULL");
+#define DI_BIT_KERNELS(suffix)                                                          \
+    .and_n = di_and_n_##suffix, .or_n = di_or_n_##suffix, .xor_n = di_xor_n_##suffix,   \
+    .not_n = di_not_n_##suffix, .shl_n = di_shl_n_##suffix, .shr_n = di_shr_n_##suffix
 
-    di_resize_internal(big, capacity);
-    return true;
-}
+static const di_kernels di_kernels_scalar = {
+    .name = "scalar",
+    .add_n = di_add_n_scalar, .sub_n = di_sub_n_scalar, .mul_1 = di_mul_1_scalar,
+    .addmul_1 = di_addmul_1_scalar, .divrem_1 = di_divrem_1_scalar,
+    .mul_basecase = di_mul_basecase_scalar,
+    DI_BIT_KERNELS(scalar)
+};
 
-static void di_resize_internal(struct di_int_internal* big, size_t new_capacity) {
-    if (new_capacity <= big->limb_capacity) return;
+#ifdef DI_WIDE_KERNELS
+static const di_kernels di_kernels_wide = {
+    .name = "wide", DI_ARITH_KERNELS(fast), DI_BIT_KERNELS(scalar)
+};
+#endif
 
-    di_limb_t* new_limbs = (di_limb_t*)DI_REALLOC(big->limbs, sizeof(di_limb_t) * new_capacity);
-    DI_ASSERT(new_limbs && "di_resize_internal: reallocation failed");
+#ifdef DI_SIMD_X86
+static const di_kernels di_kernels_avx2 = {
+    .name = "avx2", DI_ARITH_KERNELS(fast), DI_BIT_KERNELS(avx2)
+};
 
-    // Zero out new limbs
-    memset(new_limbs + big->limb_capacity, 0, sizeof(di_limb_t) * (new_capacity - big->limb_capacity));
+static const di_kernels di_kernels_avx512 = {
+    .name = "avx512", DI_ARITH_KERNELS(fast), DI_BIT_KERNELS(avx512)
+};
+#endif
 
-    big->limbs = new_limbs;
-    big->limb_capacity = new_capacity;
+#ifdef DI_HAS_IFMA
+// Short operands and very long rows keep the non-IFMA loop
+static void di_mul_basecase_ifma(di_limb_t* r, const di_limb_t* a, size_t an, const di_limb_t* b, size_t bn) {
+    if (bn >= DI_IFMA_MUL_THRESHOLD && di_digits52(bn) <= DI_IFMA_MAX_DIGITS) {
+        di_limbs_mul_ifma(r, a, an, b, bn);
+    } else {
+        di_mul_basecase_fast(r, a, an, b, bn);
+    }
 }
 
-/* Creation functions */
+static const di_kernels di_kernels_ifma = {
+    .name = "ifma", DI_ARITH_KERNELS(ifma), .ifma = true, DI_BIT_KERNELS(avx512)
+};
+#endif
 
-DI_IMPL di_int di_from_int32(int32_t value) {
-    struct di_int_internal* big = di_alloc(1);
-    DI_ASSERT(big && "di_from_int32: allocation failed");
-    
-    if (value < 0) {
-        big->is_negative = true;
-        // Handle INT32_MIN carefully
-        if (value == INT32_MIN) {
-            big->limbs[0] = (di_limb_t)INT32_MAX + 1;
-        } else {
-            big->limbs[0] = (di_limb_t)(-value);
+#ifdef DI_SIMD_NEON
+static const di_kernels di_kernels_neon = {
+    .name = "neon", DI_ARITH_KERNELS(fast), DI_BIT_KERNELS(neon)
+};
+#endif
+
+// Best first
+static const di_kernels* const di_kernel_sets[] = {
+#ifdef DI_HAS_IFMA
+    &di_kernels_ifma,
+#endif
+#ifdef DI_SIMD_X86
+    &di_kernels_avx512,
+    &di_kernels_avx2,
+#endif
+#ifdef DI_SIMD_NEON
+    &di_kernels_neon,
+#endif
+#ifdef DI_WIDE_KERNELS
+    &di_kernels_wide,
+#endif
+    &di_kernels_scalar
+};
+
+static bool di_kernels_supported(const di_kernels* kernels) {
+#ifdef DI_HAS_IFMA
+    if (kernels == &di_kernels_ifma) return di_ifma_supported();
+#endif
+#ifdef DI_SIMD_X86
+    if (kernels == &di_kernels_avx512) return __builtin_cpu_supports("avx512f");
+    if (kernels == &di_kernels_avx2) return __builtin_cpu_supports("avx2");
+#endif
+#if defined(DI_SIMD_NEON) && defined(DI_HAS_AUXV)
+    if (kernels == &di_kernels_neon) return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#endif
+    (void)kernels;
+    return true;
+}
+
+// The named set if it exists and the CPU runs it; the best one for NULL
+static const di_kernels* di_kernels_find(const char* name) {
+    for (size_t i = 0; i < sizeof(di_kernel_sets) / sizeof(di_kernel_sets[0]); i++) {
+        const di_kernels* kernels = di_kernel_sets[i];
+        if ((!name || strcmp(name, kernels->name) == 0) && di_kernels_supported(kernels)) {
+            return kernels;
         }
-    } else {
-        big->limbs[0] = (di_limb_t)value;
     }
-    big->limb_count = (value != 0) ? 1 : 0;
-    
-    return big;
+    return NULL;
 }
 
-DI_IMPL di_int di_from_int64(int64_t value) {
-    struct di_int_internal* big = di_alloc(2);
-    DI_ASSERT(big && "di_from_int64: allocation failed");
-    
-    if (value < 0) {
-        big->is_negative = true;
-        // Handle INT64_MIN carefully
-        if (value == INT64_MIN) {
-            uint64_t uval = (uint64_t)INT64_MAX + 1;
-            big->limbs[0] = (di_limb_t)(uval & DI_LIMB_MAX);
-            big->limbs[1] = (di_limb_t)(uval >> DI_LIMB_BITS);
-        } else {
-            uint64_t uval = (uint64_t)(-value);
-            big->limbs[0] = (di_limb_t)(uval & DI_LIMB_MAX);
-            big->limbs[1] = (di_limb_t)(uval >> DI_LIMB_BITS);
-        }
-    } else {
-        uint64_t uval = (uint64_t)value;
-        big->limbs[0] = (di_limb_t)(uval & DI_LIMB_MAX);
-        big->limbs[1] = (di_limb_t)(uval >> DI_LIMB_BITS);
+// The tables are constant, so the pointer needs no ordering, only atomicity
+#if defined(DI_THREADS) || defined(DI_THREADSAFE)
+static const di_kernels* _Atomic di_active_kernels;
+#define DI_KERNELS_LOAD() atomic_load_explicit(&di_active_kernels, memory_order_relaxed)
+#define DI_KERNELS_STORE(k) atomic_store_explicit(&di_active_kernels, (k), memory_order_relaxed)
+#else
+static const di_kernels* di_active_kernels;
+#define DI_KERNELS_LOAD() di_active_kernels
+#define DI_KERNELS_STORE(k) (di_active_kernels = (k))
+#endif
+
+static const di_kernels* di_kernels_get(void) {
+    const di_kernels* kernels = DI_KERNELS_LOAD();
+    if (!kernels) {
+        const char* name = getenv("DI_CPU");
+        if (name && *name) kernels = di_kernels_find(name);
+        if (!kernels) kernels = di_kernels_find(NULL);
+        DI_KERNELS_STORE(kernels);
     }
-    
-    big->limb_count = 2;
-    di_normalize(big);
-    
-    return big;
+    return kernels;
 }
 
-DI_IMPL di_int di_from_uint32(uint32_t value) {
-    struct di_int_internal* big = di_alloc(1);
-    DI_ASSERT(big && "di_from_uint32: allocation failed");
-    
-    big->limbs[0] = value;
-    big->limb_count = (value != 0) ? 1 : 0;
-    big->is_negative = false;
-    
-    return big;
+DI_IMPL const char* di_get_cpu(void) {
+    return di_kernels_get()->name;
 }
 
-DI_IMPL di_int di_from_uint64(uint64_t value) {
-    struct di_int_internal* big = di_alloc(2);
-    DI_ASSERT(big && "di_from_uint64: allocation failed");
+DI_IMPL bool di_set_cpu(const char* name) {
+    const di_kernels* kernels = di_kernels_find(name);
+    if (!kernels) return false;
+    DI_KERNELS_STORE(kernels);
+    return true;
+}
+
+// Bitwise operations
+// Operands are treated as magnitudes; limbs past the shorter one are zero
+DI_IMPL di_int di_and(di_int a, di_int b) {
+    DI_ASSERT(a && "di_and: first operand cannot be NULL");
+    DI_ASSERT(b && "di_and: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_BITWISE, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_BITWISE, a->limb_count, b->limb_count);
     
-    big->limbs[0] = (di_limb_t)(value & DI_LIMB_MAX);
-    big->limbs[1] = (di_limb_t)(value >> DI_LIMB_BITS);
-    big->limb_count = 2;
-    big->is_negative = false;
-    di_normalize(big);
+    size_t min_limbs = (a->limb_count < b->limb_count) ? a->limb_count : b->limb_count;
+    struct di_int_internal* result = di_alloc(min_limbs > 0 ? min_limbs : 1);
+    di_kernels_get()->and_n(result->limbs, a->limbs, b->limbs, min_limbs);
+    result->limb_count = min_limbs;
     
-    return big;
+    // Result is positive (bitwise operations on magnitudes)
+    di_normalize(result);
+    DI_TRACE_END();
+    return result;
 }
 
-DI_IMPL di_int di_zero(void) {
-    return di_from_int32(0);
+// OR and XOR share the prefix kernel; the longer operand's tail is copied
+static di_int di_or_xor(di_int a, di_int b, bool exclusive) {
+    if (a->limb_count < b->limb_count) {
+        di_int t = a; a = b; b = t;
+    }
+    struct di_int_internal* result = di_alloc(a->limb_count > 0 ? a->limb_count : 1);
+    const di_kernels* kernels = di_kernels_get();
+    (exclusive ? kernels->xor_n : kernels->or_n)(result->limbs, a->limbs, b->limbs, b->limb_count);
+    if (a->limb_count > b->limb_count) {
+        memcpy(result->limbs + b->limb_count, a->limbs + b->limb_count,
+               sizeof(di_limb_t) * (a->limb_count - b->limb_count));
+    }
+    result->limb_count = a->limb_count;
+    
+    // Result is positive (bitwise operations on magnitudes)
+    di_normalize(result);
+    return result;
 }
 
-DI_IMPL di_int di_one(void) {
-    return di_from_int32(1);
+DI_IMPL di_int di_or(di_int a, di_int b) {
+    DI_ASSERT(a && "di_or: first operand cannot be NULL");
+    DI_ASSERT(b && "di_or: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_BITWISE, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_BITWISE, a->limb_count, b->limb_count);
+    di_int result = di_or_xor(a, b, false);
+    DI_TRACE_END();
+    return result;
 }
 
-DI_IMPL di_int di_copy(di_int big) {
-    DI_ASSERT(big && "di_copy: operand cannot be NULL");
+DI_IMPL di_int di_xor(di_int a, di_int b) {
+    DI_ASSERT(a && "di_xor: first operand cannot be NULL");
+    DI_ASSERT(b && "di_xor: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_BITWISE, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_BITWISE, a->limb_count, b->limb_count);
+    di_int result = di_or_xor(a, b, true);
+    DI_TRACE_END();
+    return result;
+}
 
-    struct di_int_internal* copy = di_alloc(big->limb_capacity);
+DI_IMPL di_int di_not(di_int a) {
+    DI_ASSERT(a && "di_not: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_BITWISE, a->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_BITWISE, a->limb_count, 0);
     
-    copy->limb_count = big->limb_count;
-    copy->is_negative = big->is_negative;
-    if (big->limb_count > 0) {
-        memcpy(copy->limbs, big->limbs, sizeof(di_limb_t) * big->limb_count);
-    }
+    // For simplicity, NOT operation on fixed width (one limb beyond significant bits)
+    size_t result_limbs = a->limb_count + 1;
+    struct di_int_internal* result = di_alloc(result_limbs);
+    di_kernels_get()->not_n(result->limbs, a->limbs, a->limb_count);
+    result->limbs[a->limb_count] = ~((di_limb_t)0); // Set high limb to all 1s
+    result->limb_count = result_limbs;
     
-    return copy;
+    // Result is positive (bitwise operations on magnitudes)
+    di_normalize(result);
+    DI_TRACE_END();
+    return result;
 }
 
-DI_IMPL di_int di_from_string(const char* str, int base) {
-    DI_ASSERT(str && "di_from_string: string cannot be NULL");
-    DI_ASSERT(base >= 2 && base <= 36 && "di_from_string: invalid base");
-    
-    // Skip whitespace
-    while (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r') str++;
-    DI_ASSERT(*str != '\0' && "di_from_string: empty string");
+static di_int di_shift_left_internal(di_int a, size_t bits) {
+    if (bits == 0) return di_copy(a);
+    if (a->limb_count == 0) return di_zero();
     
-    // Check for sign
-    bool is_negative = false;
-    if (*str == '-') {
-        is_negative = true;
-        str++;
-    } else if (*str == '+') {
-        str++;
-    }
+    size_t limb_shift = bits / DI_LIMB_BITS;
+    unsigned bit_shift = (unsigned)(bits % DI_LIMB_BITS);
     
-    // Skip leading zeros
-    while (*str == '0') str++;
-    if (*str == '\0') return di_zero();
+    size_t new_limb_count = a->limb_count + limb_shift + (bit_shift > 0 ? 1 : 0);
+    struct di_int_internal* result = di_alloc(new_limb_count);
     
-    // Count valid digits to estimate capacity
-    const char* p = str;
-    size_t digit_count = 0;
-    while (*p) {
-        char c = *p;
-        int digit_val;
-        if (c >= '0' && c <= '9') {
-            digit_val = c - '0';
-        } else if (c >= 'a' && c <= 'z') {
-            digit_val = c - 'a' + 10;
-        } else if (c >= 'A' && c <= 'Z') {
-            digit_val = c - 'A' + 10;
-        } else {
-            break; // Invalid character
-        }
-        
-        if (digit_val >= base) break; // Invalid digit for this base
-        digit_count++;
-        p++;
+    // di_alloc() zeroed the low limb_shift limbs
+    if (bit_shift == 0) {
+        memcpy(result->limbs + limb_shift, a->limbs, sizeof(di_limb_t) * a->limb_count);
+    } else {
+        result->limbs[a->limb_count + limb_shift] =
+            di_kernels_get()->shl_n(result->limbs + limb_shift, a->limbs, a->limb_count, bit_shift);
     }
     
-    if (digit_count == 0) return NULL;
-    
-    // Estimate capacity: log2(base^n) = n * log2(base) 
-    // Rough estimate: each decimal digit needs ~3.32 bits, so use digit_count limbs
-    size_t capacity = (digit_count + 7) / 8 + 1; // Conservative estimate
-    if (capacity < 1) capacity = 1;
+    result->limb_count = new_limb_count;
+    result->is_negative = a->is_negative;
+    di_normalize(result);
     
-    struct di_int_internal* result = di_alloc(capacity);
-    DI_ASSERT(result && "di_from_string: allocation failed");
+    return result;
+}
+
+DI_IMPL di_int di_shift_left(di_int a, size_t bits) {
+    DI_ASSERT(a && "di_shift_left: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_SHIFT, a->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_SHIFT, a->limb_count, 0);
+    di_int result = di_shift_left_internal(a, bits);
+    DI_TRACE_END();
+    return result;
+}
+
+static di_int di_shift_right_internal(di_int a, size_t bits) {
+    if (bits == 0) return di_copy(a);
     
-    // Convert digit by digit using Horner's method: result = result * base + digit
-    di_int base_big = di_from_int32(base);
-    DI_ASSERT(base_big && "di_from_string: base allocation failed");
+    size_t limb_shift = bits / DI_LIMB_BITS;
+    unsigned bit_shift = (unsigned)(bits % DI_LIMB_BITS);
     
-    p = str;
-    for (size_t i = 0; i < digit_count; i++) {
-        char c = *p++;
-        int digit_val;
-        if (c >= '0' && c <= '9') {
-            digit_val = c - '0';
-        } else if (c >= 'a' && c <= 'z') {
-            digit_val = c - 'a' + 10;
-        } else if (c >= 'A' && c <= 'Z') {
-            digit_val = c - 'A' + 10;
-        } else {
-            break;
-        }
-        
-        // result = result * base + digit
-        di_int temp = di_mul(result, base_big);
-        DI_ASSERT(temp && "di_from_string: multiplication allocation failed");
-        
-        di_int digit_big = di_from_int32(digit_val);
-        DI_ASSERT(digit_big && "di_from_string: digit allocation failed");
-        
-        di_int new_result = di_add(temp, digit_big);
-        di_release(&temp);
-        di_release(&digit_big);
-        
-        DI_ASSERT(new_result && "di_from_string: addition allocation failed");
-        
-        di_release((di_int*)&result);
-        result = new_result;
+    // If shifting more limbs than we have, result is zero
+    if (limb_shift >= a->limb_count) {
+        return di_zero();
     }
     
-    di_release(&base_big);
+    size_t new_limb_count = a->limb_count - limb_shift;
+    struct di_int_internal* result = di_alloc(new_limb_count);
     
-    // Set sign
-    if (is_negative && result->limb_count > 0) {
-        result->is_negative = true;
+    if (bit_shift == 0) {
+        memcpy(result->limbs, a->limbs + limb_shift, sizeof(di_limb_t) * new_limb_count);
+    } else {
+        di_kernels_get()->shr_n(result->limbs, a->limbs + limb_shift, new_limb_count, bit_shift);
     }
     
+    result->limb_count = new_limb_count;
+    result->is_negative = a->is_negative;
+    di_normalize(result);
+    
     return result;
 }
 
-/* Reference counting */
-
-DI_IMPL di_int di_retain(di_int big) {
-    DI_ASSERT(big && "di_retain: operand cannot be NULL");
-    big->ref_count++;
-    return big;
+DI_IMPL di_int di_shift_right(di_int a, size_t bits) {
+    DI_ASSERT(a && "di_shift_right: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_SHIFT, a->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_SHIFT, a->limb_count, 0);
+    di_int result = di_shift_right_internal(a, bits);
+    DI_TRACE_END();
+    return result;
 }
 
-DI_IMPL void di_release(di_int* big) {
-    if (!big || !*big) return;
+// GCD using Euclidean algorithm
+static di_int di_gcd_internal(di_int a, di_int b) {
+    di_int abs_a = di_abs(a);
+    di_int abs_b = di_abs(b);
     
-    struct di_int_internal* b = *big;
-    if (--b->ref_count == 0) {
-        if (b->limbs) {
-            DI_FREE(b->limbs);
+    if (di_is_zero(abs_a)) {
+        di_release(&abs_a);
+        return abs_b;
+    }
+    if (di_is_zero(abs_b)) {
+        di_release(&abs_b);
+        return abs_a;
+    }
+    
+    // Euclidean algorithm: gcd(a,b) = gcd(b, a mod b)
+    while (!di_is_zero(abs_b)) {
+        di_int remainder = di_mod(abs_a, abs_b);
+        if (!remainder) {
+            di_release(&abs_a);
+            di_release(&abs_b);
+            return NULL;
         }
-        DI_FREE(b);
+        
+        di_release(&abs_a);
+        abs_a = abs_b;
+        abs_b = remainder;
     }
-    *big = NULL;
+    
+    di_release(&abs_b);
+    return abs_a;
 }
 
-DI_IMPL size_t di_ref_count(di_int big) {
-    DI_ASSERT(big && "di_ref_count: operand cannot be NULL");
-    return big->ref_count;
+DI_IMPL di_int di_gcd(di_int a, di_int b) {
+    DI_ASSERT(a && "di_gcd: first operand cannot be NULL");
+    DI_ASSERT(b && "di_gcd: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_GCD, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_GCD, a->limb_count, b->limb_count);
+    di_int result = di_gcd_internal(a, b);
+    DI_TRACE_END();
+    return result;
 }
 
-/* Comparison functions */
+// LCM using the identity: lcm(a,b) = |a*b| / gcd(a,b)
+static di_int di_lcm_internal(di_int a, di_int b) {
+    if (di_is_zero(a) || di_is_zero(b)) return di_zero();
+    
+    di_int gcd = di_gcd(a, b);
+    DI_ASSERT(gcd && "di_lcm: gcd allocation failed");
+    
+    di_int product = di_mul(a, b);
+    if (!product) {
+        di_release(&gcd);
+        return NULL;
+    }
+    
+    di_int abs_product = di_abs(product);
+    di_release(&product);
+    if (!abs_product) {
+        di_release(&gcd);
+        return NULL;
+    }
+    
+    di_int result = di_div(abs_product, gcd);
+    di_release(&abs_product);
+    di_release(&gcd);
+    
+    return result;
+}
 
-DI_IMPL int di_compare(di_int a, di_int b) {
-    DI_ASSERT(a && "di_compare: first operand cannot be NULL");
-    DI_ASSERT(b && "di_compare: second operand cannot be NULL");
+DI_IMPL di_int di_lcm(di_int a, di_int b) {
+    DI_ASSERT(a && "di_lcm: first operand cannot be NULL");
+    DI_ASSERT(b && "di_lcm: second operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_GCD, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_GCD, a->limb_count, b->limb_count);
+    di_int result = di_lcm_internal(a, b);
+    DI_TRACE_END();
+    return result;
+}
+
+// Simple integer square root using Newton's method
+static di_int di_sqrt_internal(di_int n) {
+    if (di_is_zero(n)) return di_zero();
     
-    // Compare signs
-    if (a->is_negative != b->is_negative) {
-        return a->is_negative ? -1 : 1;
+    di_int one = di_one();
+    if (di_eq(n, one)) {
+        di_release(&one);
+        return di_one();
     }
     
-    // Same sign, compare magnitudes
-    if (a->limb_count != b->limb_count) {
-        int mag_cmp = (a->limb_count > b->limb_count) ? 1 : -1;
-        return a->is_negative ? -mag_cmp : mag_cmp;
+    // Initial guess: x = 2^ceil(bits / 2) >= sqrt(n), so Newton's method
+    // decreases monotonically and stops at floor(sqrt(n))
+    di_int two = di_from_int32(2);
+    di_int x = di_shift_left(one, (di_bit_length(n) + 1) / 2);
+    if (!x) {
+        di_release(&one);
+        di_release(&two);
+        return NULL;
     }
     
-    // Same number of limbs, compare from most significant
-    for (size_t i = a->limb_count; i > 0; i--) {
-        if (a->limbs[i-1] > b->limbs[i-1]) {
-            return a->is_negative ? -1 : 1;
-        }
-        if (a->limbs[i-1] < b->limbs[i-1]) {
-            return a->is_negative ? 1 : -1;
+    // Newton's method: x_new = (x + n/x) / 2
+    for (;;) {
+        di_int quotient = di_div(n, x);
+        if (!quotient) break;
+        
+        di_int sum = di_add(x, quotient);
+        di_release(&quotient);
+        if (!sum) break;
+        
+        di_int x_new = di_div(sum, two);
+        di_release(&sum);
+        if (!x_new) break;
+        
+        // Check for convergence
+        if (di_ge(x_new, x)) {
+            di_release(&x_new);
+            break;
         }
+        
+        di_release(&x);
+        x = x_new;
     }
     
-    return 0;  // Equal
+    di_release(&one);
+    di_release(&two);
+    return x;
 }
 
-DI_IMPL bool di_eq(di_int a, di_int b) {
-    return di_compare(a, b) == 0;
+DI_IMPL di_int di_sqrt(di_int n) {
+    DI_ASSERT(n && "di_sqrt: operand cannot be NULL");
+    DI_ASSERT(!di_is_negative(n) && "di_sqrt: square root of negative number");
+    DI_STATS_OP(DI_STATS_SQRT, n->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_SQRT, n->limb_count, 0);
+    di_int result = di_sqrt_internal(n);
+    DI_TRACE_END();
+    return result;
 }
 
-DI_IMPL bool di_lt(di_int a, di_int b) {
-    return di_compare(a, b) < 0;
+// Product trees
+// Small factors are packed into 64-bit leaves and the tree multiplies
+// halves of similar size, so Karatsuba (and threads) see balanced
+// operands. Subtrees of at least DI_PRODUCT_TASK_LIMBS limbs become pool
+// tasks; products are exact, so scheduling never changes the result.
+
+#define DI_PRODUCT_TASK_LIMBS 64
+
+static di_int di_from_u64_limbs(uint64_t value) {
+    struct di_int_internal* big = di_alloc((64 + DI_LIMB_BITS - 1) / DI_LIMB_BITS);
+    while (value) {
+        big->limbs[big->limb_count++] = (di_limb_t)value;
+        value >>= DI_LIMB_BITS;
+    }
+    return big;
 }
 
-DI_IMPL bool di_le(di_int a, di_int b) {
-    return di_compare(a, b) <= 0;
+typedef struct {
+    di_int* items;
+    size_t count;
+    size_t cap;
+    uint64_t acc;            // Factors not yet pushed as a leaf
+} di_leaves;
+
+static void di_leaves_push(di_leaves* leaves, uint64_t value) {
+    if (leaves->count == leaves->cap) {
+        leaves->cap = leaves->cap ? leaves->cap * 2 : 64;
+        leaves->items = (di_int*)DI_REALLOC(leaves->items, sizeof(di_int) * leaves->cap);
+        DI_ASSERT(leaves->items && "di_leaves_push: allocation failed");
+    }
+    leaves->items[leaves->count++] = di_from_u64_limbs(value);
 }
 
-DI_IMPL bool di_gt(di_int a, di_int b) {
-    return di_compare(a, b) > 0;
+static void di_leaves_mul(di_leaves* leaves, uint64_t factor) {
+    if (leaves->acc > UINT64_MAX / factor) {
+        di_leaves_push(leaves, leaves->acc);
+        leaves->acc = 1;
+    }
+    leaves->acc *= factor;
 }
 
-DI_IMPL bool di_ge(di_int a, di_int b) {
-    return di_compare(a, b) >= 0;
+typedef struct {
+    const di_int* values;
+    size_t count;
+    di_int result;
+} di_product_job;
+
+static di_int di_product_range(const di_int* values, size_t count);
+
+static void di_product_job_run(void* arg) {
+    di_product_job* job = (di_product_job*)arg;
+    job->result = di_product_range(job->values, job->count);
 }
 
-DI_IMPL bool di_is_zero(di_int big) {
-    DI_ASSERT(big && "di_is_zero: operand cannot be NULL");
-    return big->limb_count == 0;
+static di_int di_product_range(const di_int* values, size_t count) {
+    if (count == 1) return di_retain(values[0]);
+    if (count == 2) return di_mul(values[0], values[1]);
+
+    size_t limbs = di_ints_limbs(values, count);
+
+    // Left half may run elsewhere while this thread does the right half
+    di_product_job left = { values, count / 2, NULL };
+    di_task_group group;
+    if (limbs >= DI_PRODUCT_TASK_LIMBS) {
+        di_task_group_init(&group);
+        di_task_spawn(&group, di_product_job_run, &left);
+    } else {
+        di_product_job_run(&left);
+    }
+    di_int right = di_product_range(values + count / 2, count - count / 2);
+    if (limbs >= DI_PRODUCT_TASK_LIMBS) di_task_wait(&group);
+
+    di_int result = di_mul(left.result, right);
+    di_release(&left.result);
+    di_release(&right);
+    return result;
 }
 
-DI_IMPL bool di_is_negative(di_int big) {
-    DI_ASSERT(big && "di_is_negative: operand cannot be NULL");
-    return big->is_negative && big->limb_count > 0;
+// Multiply out the leaves (plus the pending accumulator) and free them
+static di_int di_leaves_product(di_leaves* leaves) {
+    if (leaves->acc > 1 || leaves->count == 0) di_leaves_push(leaves, leaves->acc);
+    di_int result = di_product_range(leaves->items, leaves->count);
+    for (size_t i = 0; i < leaves->count; i++) di_release(&leaves->items[i]);
+    DI_FREE(leaves->items);
+    return result;
 }
 
-DI_IMPL bool di_is_positive(di_int big) {
-    DI_ASSERT(big && "di_is_positive: operand cannot be NULL");
-    return !big->is_negative && big->limb_count > 0;
+DI_IMPL di_int di_product(const di_int* values, size_t count) {
+    DI_ASSERT((values || count == 0) && "di_product: values cannot be NULL");
+    if (count == 0) return di_one();
+    for (size_t i = 0; i < count; i++) {
+        DI_ASSERT(values[i] && "di_product: value cannot be NULL");
+    }
+    DI_STATS_OP(DI_STATS_PRODUCT, di_ints_limbs(values, count));
+    DI_TRACE_BEGIN(DI_STATS_PRODUCT, di_ints_limbs(values, count), 0);
+    di_int result = di_product_range(values, count);
+    DI_TRACE_END();
+    return result;
 }
 
-DI_IMPL bool di_is_one(di_int big) {
-    DI_ASSERT(big && "di_is_one: operand cannot be NULL");
-    if (big->is_negative || big->limb_count != 1) {
-        return false;
+// Factorial function: odd parts of 2..n through a product tree, then one
+// shift for the n - popcount(n) factors of two
+static di_int di_factorial_internal(uint32_t n) {
+    if (n <= 1) return di_one();
+
+    di_leaves leaves = { NULL, 0, 0, 1 };
+    size_t twos = 0;
+    for (uint32_t i = 2; i <= n && i != 0; i++) {
+        uint32_t odd = i;
+        while (!(odd & 1)) {
+            odd >>= 1;
+            twos++;
+        }
+        if (odd > 1) di_leaves_mul(&leaves, odd);
     }
-    return big->limbs[0] == 1;
+
+    di_int odd_part = di_leaves_product(&leaves);
+    di_int result = di_shift_left(odd_part, twos);
+    di_release(&odd_part);
+    DI_ASSERT(result && "di_factorial: allocation failed");
+    return result;
 }
 
-/* Conversion functions */
+DI_IMPL di_int di_factorial(uint32_t n) {
+    DI_TRACE_BEGIN(DI_STATS_FACTORIAL, n, 0);
+    di_int result = di_factorial_internal(n);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_FACTORIAL, result ? result->limb_count : 0);
+    return result;
+}
 
-DI_IMPL bool di_to_int32(di_int big, int32_t* result) {
-    DI_ASSERT(big && "di_to_int32: integer cannot be NULL");
-    DI_ASSERT(result && "di_to_int32: result pointer cannot be NULL");
-    
-    if (big->limb_count == 0) {
-        *result = 0;
-        return true;
+// Binomial coefficient from its prime factorisation (Kummer/Legendre):
+// the exponent of p is the number of borrows when subtracting k from n in
+// base p, so no division of big integers is needed
+static di_int di_binomial_internal(uint32_t n, uint32_t k) {
+    if (k > n) return di_zero();
+    if (k > n - k) k = n - k;
+    if (k == 0) return di_one();
+
+    // Bit sieve over odd numbers: bit i stands for 2i + 1
+    size_t words = ((size_t)n / 2 + 64) / 64;
+    uint64_t* composite = (uint64_t*)DI_MALLOC(sizeof(uint64_t) * words);
+    DI_ASSERT(composite && "di_binomial: allocation failed");
+    memset(composite, 0, sizeof(uint64_t) * words);
+    for (uint64_t p = 3; p * p <= n; p += 2) {
+        if (composite[p / 128] >> ((p / 2) % 64) & 1) continue;
+        for (uint64_t m = p * p; m <= n; m += 2 * p) {
+            composite[m / 128] |= (uint64_t)1 << ((m / 2) % 64);
+        }
     }
-    
-    if (big->limb_count > 1) return false;
-    
-    di_limb_t val = big->limbs[0];
-    
-    if (big->is_negative) {
-        if (val > (di_limb_t)INT32_MAX + 1) return false;
-        if (val == (di_limb_t)INT32_MAX + 1) {
-            *result = INT32_MIN;
-        } else {
-            *result = -(int32_t)val;
+
+    di_leaves leaves = { NULL, 0, 0, 1 };
+    for (uint64_t p = 2; p <= n; p = p == 2 ? 3 : p + 2) {
+        if (p > 2 && (composite[p / 128] >> ((p / 2) % 64) & 1)) continue;
+        uint32_t e = 0;
+        for (uint64_t q = p; q <= n; q *= p) {
+            e += (uint32_t)(n / q - k / q - (n - k) / q);
         }
-    } else {
-        if (val > INT32_MAX) return false;
-        *result = (int32_t)val;
+        while (e--) di_leaves_mul(&leaves, p);
     }
-    
-    return true;
+    DI_FREE(composite);
+
+    return di_leaves_product(&leaves);
 }
 
-DI_IMPL bool di_to_int64(di_int big, int64_t* result) {
-    DI_ASSERT(big && "di_to_int64: integer cannot be NULL");
-    DI_ASSERT(result && "di_to_int64: result pointer cannot be NULL");
-    
-    if (big->limb_count == 0) {
-        *result = 0;
-        return true;
+DI_IMPL di_int di_binomial(uint32_t n, uint32_t k) {
+    DI_TRACE_BEGIN(DI_STATS_FACTORIAL, n, 0);
+    di_int result = di_binomial_internal(n, k);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_FACTORIAL, result ? result->limb_count : 0);
+    return result;
+}
+
+// Montgomery arithmetic on limb arrays (odd moduli)
+// Values are len-limb arrays below n; a value x is kept as x*R mod n with
+// R = 2^(len*DI_LIMB_BITS), so reductions need no division.
+
+#define DI_MONT_WINDOW 4
+
+#ifdef DI_HAS_IFMA
+// Radix-2^52 Montgomery state for the IFMA kernel. It runs an "almost"
+// Montgomery reduction: operands and results stay below 2n rather than n,
+// which holds as long as 4n < R = 2^(52k).
+typedef struct di_mont52 {
+    size_t digits;          // k
+    size_t padded;          // k rounded up to a multiple of 8
+    uint64_t ninv;          // -n^-1 mod 2^52
+    uint64_t* n;            // n, padded digits after one zero digit
+    uint64_t* ax;           // Copy of the left operand laid out like n
+    uint64_t* one;          // R mod n
+    uint64_t* r2;           // R^2 mod n
+    uint64_t* unit;         // 1, for leaving Montgomery form
+    uint64_t* x;            // Running power in di_mont52_pow
+    uint64_t* acc;          // 2 * padded + 16 digits of scratch
+    uint64_t* table;        // (1 << DI_MONT_WINDOW) * padded digits
+} di_mont52;
+
+// r = a * b / R mod n, with r < 2n; r may alias a or b. Row i adds a*b[i]
+// and m*n to the accumulator at offset i, m chosen to clear digit i. The
+// high half of each product lands one digit up, read from the copy of a
+// and n shifted by a zero digit. Lanes are never carried inside the loop;
+// only the carry out of the cleared digit is tracked, as a scalar.
+static DI_TARGET_IFMA void di_mont52_mul(di_mont52* ctx, uint64_t* r, const uint64_t* a, const uint64_t* b) {
+    size_t k = ctx->digits, kp = ctx->padded;
+    uint64_t* acc = ctx->acc;
+    uint64_t* ax = ctx->ax + 1;
+    const uint64_t* n = ctx->n + 1;
+    memcpy(ax, a, sizeof(uint64_t) * kp);
+    memset(acc, 0, sizeof(uint64_t) * (2 * kp + 16));
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < k; i++) {
+        uint64_t bi = b[i];
+        uint64_t m = ((acc[i] + carry + ax[0] * bi) * ctx->ninv) & DI_DIGIT_MASK;
+        __m512i vb = _mm512_set1_epi64((long long)bi);
+        __m512i vm = _mm512_set1_epi64((long long)m);
+        for (size_t c = 0; c <= kp; c += 8) {
+            __m512i x = _mm512_loadu_si512((const void*)(acc + i + c));
+            x = _mm512_madd52lo_epu64(x, _mm512_loadu_si512((const void*)(ax + c)), vb);
+            x = _mm512_madd52hi_epu64(x, _mm512_loadu_si512((const void*)(ax + c - 1)), vb);
+            x = _mm512_madd52lo_epu64(x, _mm512_loadu_si512((const void*)(n + c)), vm);
+            x = _mm512_madd52hi_epu64(x, _mm512_loadu_si512((const void*)(n + c - 1)), vm);
+            _mm512_storeu_si512((void*)(acc + i + c), x);
+        }
+        // Digit i is now zero mod 2^52
+        carry = (acc[i] + carry) >> 52;
     }
-    
-    if (big->limb_count > 2) return false;
-    
-    uint64_t val = big->limbs[0];
-    if (big->limb_count == 2) {
-        val |= ((uint64_t)big->limbs[1] << DI_LIMB_BITS);
+
+    acc[k] += carry;
+    di_digits52_normalize(acc + k, k + 1);
+    memcpy(r, acc + k, sizeof(uint64_t) * k);
+}
+#endif
+
+typedef struct {
+    const di_limb_t* n;     // Odd modulus, len limbs, top limb non-zero
+    size_t len;
+    di_limb_t ninv;         // -n^-1 mod 2^DI_LIMB_BITS
+    di_limb_t* one;         // R mod n (Montgomery form of 1)
+    di_limb_t* neg_one;     // n - (R mod n) (Montgomery form of n - 1)
+    di_limb_t* r2;          // R^2 mod n
+    di_limb_t* t;           // len + 2 limbs of scratch
+    di_limb_t* table;       // (1 << DI_MONT_WINDOW) * len limbs for di_mont_pow
+#ifdef DI_HAS_IFMA
+    struct di_mont52* ifma; // Radix-2^52 state, or NULL to stay scalar
+#endif
+} di_mont_ctx;
+
+static bool di_limb_test_bit(const di_limb_t* a, size_t bit) {
+    return (a[bit / DI_LIMB_BITS] >> (bit % DI_LIMB_BITS)) & 1;
+}
+
+// x = 2x mod n, for x < n
+static void di_mont_double(di_limb_t* x, const di_limb_t* n, size_t len) {
+    di_limb_t carry = 0;
+    for (size_t i = 0; i < len; i++) {
+        di_limb_t top = x[i] >> (DI_LIMB_BITS - 1);
+        x[i] = (di_limb_t)((x[i] << 1) | carry);
+        carry = top;
     }
-    
-    if (big->is_negative) {
-        if (val > (uint64_t)INT64_MAX + 1) return false;
-        if (val == (uint64_t)INT64_MAX + 1) {
-            *result = INT64_MIN;
-        } else {
-            *result = -(int64_t)val;
-        }
-    } else {
-        if (val > INT64_MAX) return false;
-        *result = (int64_t)val;
+    if (carry || di_limbs_cmp(x, n, len) >= 0) {
+        di_limbs_sub(x, x, n, len);
     }
-    
-    return true;
 }
 
-DI_IMPL bool di_to_uint32(di_int big, uint32_t* result) {
-    DI_ASSERT(big && "di_to_uint32: integer cannot be NULL");
-    DI_ASSERT(result && "di_to_uint32: result pointer cannot be NULL");
-    
-    if (big->limb_count == 0) {
-        *result = 0;
-        return true;
+#ifdef DI_HAS_IFMA
+// Radix-2^52 state for moduli the IFMA kernel handles, or NULL
+static di_mont52* di_mont52_new(const di_mont_ctx* ctx) {
+    const di_limb_t* n = ctx->n;
+    size_t len = ctx->len;
+    if (len < DI_IFMA_MONT_THRESHOLD || !di_kernels_get()->ifma) return NULL;
+
+    size_t top = len - 1;
+    size_t high_bit = DI_LIMB_BITS - 1;
+    while (!((n[top] >> high_bit) & 1)) high_bit--;
+    size_t nbits = top * DI_LIMB_BITS + high_bit + 1;
+    size_t k = (nbits + 2 + 51) / 52;
+    if (k > DI_IFMA_MAX_DIGITS) return NULL;
+    size_t kp = (k + 7) & ~(size_t)7;
+
+    size_t entries = (size_t)1 << DI_MONT_WINDOW;
+    size_t words = (kp + 9) * 2 + kp * 4 + (2 * kp + 16) + entries * kp;
+    di_mont52* m = (di_mont52*)DI_MALLOC(sizeof(di_mont52) + sizeof(uint64_t) * words);
+    DI_ASSERT(m && "di_mont_init: allocation failed");
+    uint64_t* block = (uint64_t*)(m + 1);
+    memset(block, 0, sizeof(uint64_t) * words);
+    m->digits = k;
+    m->padded = kp;
+    m->n = block;
+    m->ax = m->n + kp + 9;
+    m->one = m->ax + kp + 9;
+    m->r2 = m->one + kp;
+    m->unit = m->r2 + kp;
+    m->x = m->unit + kp;
+    m->acc = m->x + kp;
+    m->table = m->acc + 2 * kp + 16;
+
+    di_to_digits52(m->n + 1, kp, n, len);
+    uint64_t inv = m->n[1];
+    for (int i = 0; i < 6; i++) inv *= 2 - m->n[1] * inv;
+    m->ninv = (0 - inv) & DI_DIGIT_MASK;
+    m->unit[0] = 1;
+
+    // Same doubling walk as the scalar context, up to 2^(52k) and 2^(104k)
+    di_limb_t* x = ctx->t;
+    memset(x, 0, sizeof(di_limb_t) * len);
+    x[top] = (di_limb_t)((di_limb_t)1 << high_bit);
+    for (size_t i = nbits - 1; i < k * 52; i++) di_mont_double(x, n, len);
+    di_to_digits52(m->one, kp, x, len);
+    for (size_t i = 0; i < k * 52; i++) di_mont_double(x, n, len);
+    di_to_digits52(m->r2, kp, x, len);
+    return m;
+}
+#endif
+
+static void di_mont_init(di_mont_ctx* ctx, const di_limb_t* n, size_t len) {
+    ctx->n = n;
+    ctx->len = len;
+
+    // Newton iteration doubles the correct low bits each step (odd n)
+    di_limb_t inv = n[0];
+    for (int i = 0; i < 5; i++) {
+        inv = (di_limb_t)((di_dlimb_t)inv * (di_limb_t)(2 - (di_dlimb_t)n[0] * inv));
     }
-    
-    // Negative numbers cannot be converted to unsigned
-    if (big->is_negative) return false;
-    
-    // Check if value fits in uint32
-    if (big->limb_count > 1) {
-        // If more than 1 limb, check if the value exceeds uint32 max
-        if (big->limb_count > 2) return false;
-        uint64_t val = big->limbs[0] | ((uint64_t)big->limbs[1] << DI_LIMB_BITS);
-        if (val > UINT32_MAX) return false;
-        *result = (uint32_t)val;
-    } else {
-        // Single limb case
-        if (sizeof(di_limb_t) > sizeof(uint32_t) && big->limbs[0] > UINT32_MAX) {
-            return false;
-        }
-        *result = (uint32_t)big->limbs[0];
+    ctx->ninv = (di_limb_t)(0 - inv);
+
+    size_t words = len * 3 + (len + 2) + ((size_t)1 << DI_MONT_WINDOW) * len;
+    di_limb_t* block = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * words);
+    DI_ASSERT(block && "di_mont_init: allocation failed");
+    ctx->one = block;
+    ctx->neg_one = block + len;
+    ctx->r2 = block + 2 * len;
+    ctx->t = block + 3 * len;
+    ctx->table = block + 4 * len + 2;
+
+    // Start from 2^(nbits-1) < n and double up to R, then on to R^2
+    size_t top = len - 1;
+    size_t high_bit = DI_LIMB_BITS - 1;
+    while (!((n[top] >> high_bit) & 1)) high_bit--;
+    memset(ctx->one, 0, sizeof(di_limb_t) * len);
+    ctx->one[top] = (di_limb_t)((di_limb_t)1 << high_bit);
+    for (size_t i = top * DI_LIMB_BITS + high_bit; i < len * DI_LIMB_BITS; i++) {
+        di_mont_double(ctx->one, n, len);
     }
-    
-    return true;
+    memcpy(ctx->r2, ctx->one, sizeof(di_limb_t) * len);
+    for (size_t i = 0; i < len * DI_LIMB_BITS; i++) {
+        di_mont_double(ctx->r2, n, len);
+    }
+    di_limbs_sub(ctx->neg_one, n, ctx->one, len);
+#ifdef DI_HAS_IFMA
+    ctx->ifma = di_mont52_new(ctx);
+#endif
+}
+
+static void di_mont_free(di_mont_ctx* ctx) {
+#ifdef DI_HAS_IFMA
+    DI_FREE(ctx->ifma);
+    ctx->ifma = NULL;
+#endif
+    DI_FREE(ctx->one);
+    ctx->one = NULL;
 }
 
-DI_IMPL bool di_to_uint64(di_int big, uint64_t* result) {
-    DI_ASSERT(big && "di_to_uint64: integer cannot be NULL");
-    DI_ASSERT(result && "di_to_uint64: result pointer cannot be NULL");
-    
-    if (big->limb_count == 0) {
-        *result = 0;
-        return true;
+// r = a * b / R mod n (CIOS); r may alias a or b
+static void di_mont_mul(di_mont_ctx* ctx, di_limb_t* r, const di_limb_t* a, const di_limb_t* b) {
+    const di_limb_t* n = ctx->n;
+    size_t len = ctx->len;
+    di_limb_t* t = ctx->t;
+    memset(t, 0, sizeof(di_limb_t) * (len + 2));
+
+    for (size_t i = 0; i < len; i++) {
+        di_dlimb_t carry = 0;
+        for (size_t j = 0; j < len; j++) {
+            di_dlimb_t cur = (di_dlimb_t)a[j] * b[i] + t[j] + carry;
+            t[j] = (di_limb_t)cur;
+            carry = cur >> DI_LIMB_BITS;
+        }
+        di_dlimb_t cur = (di_dlimb_t)t[len] + carry;
+        t[len] = (di_limb_t)cur;
+        t[len + 1] = (di_limb_t)(cur >> DI_LIMB_BITS);
+
+        di_limb_t m = (di_limb_t)((di_dlimb_t)t[0] * ctx->ninv);
+        carry = ((di_dlimb_t)m * n[0] + t[0]) >> DI_LIMB_BITS;
+        for (size_t j = 1; j < len; j++) {
+            cur = (di_dlimb_t)m * n[j] + t[j] + carry;
+            t[j - 1] = (di_limb_t)cur;
+            carry = cur >> DI_LIMB_BITS;
+        }
+        cur = (di_dlimb_t)t[len] + carry;
+        t[len - 1] = (di_limb_t)cur;
+        t[len] = (di_limb_t)(t[len + 1] + (cur >> DI_LIMB_BITS));
     }
-    
-    // Negative numbers cannot be converted to unsigned
-    if (big->is_negative) return false;
-    
-    // Check if value fits in uint64
-    if (big->limb_count > 2) return false;
-    
-    uint64_t val = big->limbs[0];
-    if (big->limb_count == 2) {
-        val |= ((uint64_t)big->limbs[1] << DI_LIMB_BITS);
+
+    if (t[len] || di_limbs_cmp(t, n, len) >= 0) {
+        di_limbs_sub(t, t, n, len);
     }
-    
-    *result = val;
-    return true;
+    memcpy(r, t, sizeof(di_limb_t) * len);
 }
 
-DI_IMPL double di_to_double(di_int big) {
-    DI_ASSERT(big && "di_to_double: operand cannot be NULL");
-    if (big->limb_count == 0) return 0.0;
-    
-    double result = 0.0;
-    double base = 1.0;
-    
-    for (size_t i = 0; i < big->limb_count; i++) {
-        result += big->limbs[i] * base;
-        base *= (double)(DI_LIMB_MAX + 1ULL);
+#ifdef DI_HAS_IFMA
+// di_mont_pow on the IFMA kernel. base arrives and r leaves in the scalar
+// Montgomery form; the window loop runs on radix-2^52 digits in between.
+static void di_mont52_pow(di_mont_ctx* ctx, di_limb_t* r, const di_limb_t* base,
+                          const di_limb_t* exp, size_t lo, size_t hi) {
+    di_mont52* m = ctx->ifma;
+    size_t len = ctx->len, kp = m->padded;
+    size_t entries = (size_t)1 << DI_MONT_WINDOW;
+    uint64_t* table = m->table;
+
+    // base * R32^-1 is plain base; into radix 2^52 and times R52
+    memset(ctx->table, 0, sizeof(di_limb_t) * len);
+    ctx->table[0] = 1;
+    di_mont_mul(ctx, r, base, ctx->table);
+    di_to_digits52(table + kp, kp, r, len);
+    di_mont52_mul(m, table + kp, table + kp, m->r2);
+
+    memcpy(table, m->one, sizeof(uint64_t) * kp);
+    for (size_t i = 2; i < entries; i++) {
+        di_mont52_mul(m, table + i * kp, table + (i - 1) * kp, table + kp);
     }
-    
-    return big->is_negative ? -result : result;
-}
 
-/* Helper function to compare magnitudes (ignoring sign) */
-static int di_compare_magnitude(struct di_int_internal* a, struct di_int_internal* b) {
-    if (a->limb_count > b->limb_count) return 1;
-    if (a->limb_count < b->limb_count) return -1;
-    
-    // Same number of limbs - compare from most significant
-    for (size_t i = a->limb_count; i > 0; i--) {
-        size_t idx = i - 1;
-        if (a->limbs[idx] > b->limbs[idx]) return 1;
-        if (a->limbs[idx] < b->limbs[idx]) return -1;
+    // Fixed windows from the top, as in di_mont_pow
+    uint64_t* x = m->x;
+    size_t pos = hi;
+    size_t width = (hi - lo) % DI_MONT_WINDOW;
+    if (width == 0) width = DI_MONT_WINDOW;
+    bool first = true;
+    while (pos > lo) {
+        size_t digit = 0;
+        for (size_t i = 0; i < width; i++) {
+            pos--;
+            digit = (digit << 1) | (size_t)di_limb_test_bit(exp, pos);
+            if (!first) di_mont52_mul(m, x, x, x);
+        }
+        if (first) {
+            memcpy(x, table + digit * kp, sizeof(uint64_t) * kp);
+            first = false;
+        } else if (digit) {
+            di_mont52_mul(m, x, x, table + digit * kp);
+        }
+        width = DI_MONT_WINDOW;
     }
-    
-    return 0; // Equal magnitudes
+
+    // Out of radix-2^52 form (the result is at most n) and back into R32
+    di_mont52_mul(m, x, x, m->unit);
+    di_from_digits52(r, len, x, m->digits);
+    if (di_limbs_cmp(r, ctx->n, len) >= 0) di_limbs_sub(r, r, ctx->n, len);
+    di_mont_mul(ctx, r, r, ctx->r2);
 }
+#endif
 
-/* Basic arithmetic implementations */
+// r = base^e in Montgomery form, where e is bits [lo, hi) of exp
+static void di_mont_pow(di_mont_ctx* ctx, di_limb_t* r, const di_limb_t* base,
+                        const di_limb_t* exp, size_t lo, size_t hi) {
+#ifdef DI_HAS_IFMA
+    if (ctx->ifma) {
+        di_mont52_pow(ctx, r, base, exp, lo, hi);
+        return;
+    }
+#endif
+    size_t len = ctx->len;
+    size_t entries = (size_t)1 << DI_MONT_WINDOW;
+    di_limb_t* table = ctx->table;
 
-DI_IMPL di_int di_add(di_int a, di_int b) {
-    DI_ASSERT(a != NULL && "di_add: first operand cannot be NULL");
-    DI_ASSERT(b != NULL && "di_add: second operand cannot be NULL");
-    
-    // Simple implementation for same-sign addition
-    if (a->is_negative == b->is_negative) {
-        struct di_int_internal* result = di_alloc(
-            (a->limb_count > b->limb_count ? a->limb_count : b->limb_count) + 1
-        );
-        DI_ASSERT(result && "di_add: allocation failed");
-        
-        result->is_negative = a->is_negative;
-        
-        di_dlimb_t carry = 0;
-        size_t max_limbs = a->limb_count > b->limb_count ? a->limb_count : b->limb_count;
-        
-        for (size_t i = 0; i < max_limbs; i++) {
-            di_dlimb_t sum = carry;
-            if (i < a->limb_count) sum += a->limbs[i];
-            if (i < b->limb_count) sum += b->limbs[i];
-            
-            result->limbs[i] = (di_limb_t)(sum & DI_LIMB_MAX);
-            carry = sum >> DI_LIMB_BITS;
+    memcpy(table, ctx->one, sizeof(di_limb_t) * len);
+    for (size_t i = 1; i < entries; i++) {
+        di_mont_mul(ctx, table + i * len, table + (i - 1) * len, base);
+    }
+
+    // Fixed windows from the top; the first window takes the leftover bits
+    memcpy(r, ctx->one, sizeof(di_limb_t) * len);
+    size_t pos = hi;
+    size_t width = (hi - lo) % DI_MONT_WINDOW;
+    if (width == 0) width = DI_MONT_WINDOW;
+    bool first = true;
+    while (pos > lo) {
+        size_t digit = 0;
+        for (size_t i = 0; i < width; i++) {
+            pos--;
+            digit = (digit << 1) | (size_t)di_limb_test_bit(exp, pos);
+            if (!first) di_mont_mul(ctx, r, r, r);
         }
-        
-        if (carry) {
-            result->limbs[max_limbs] = (di_limb_t)carry;
-            result->limb_count = max_limbs + 1;
-        } else {
-            result->limb_count = max_limbs;
+        if (first) {
+            memcpy(r, table + digit * len, sizeof(di_limb_t) * len);
+            first = false;
+        } else if (digit) {
+            di_mont_mul(ctx, r, r, table + digit * len);
         }
-        
-        di_normalize(result);
-        return result;
+        width = DI_MONT_WINDOW;
     }
-    
-    // Different signs - subtract magnitudes
-    // First determine which has larger magnitude
-    int cmp = di_compare_magnitude(a, b);
-    
-    struct di_int_internal* larger = (cmp >= 0) ? a : b;
-    struct di_int_internal* smaller = (cmp >= 0) ? b : a;
-    
-    // Result takes sign of the larger magnitude operand
-    // If a has larger magnitude: result = a - b (sign of a)
-    // If b has larger magnitude: result = -(b - a) = b - a with opposite sign
-    bool result_negative = (cmp >= 0) ? a->is_negative : b->is_negative;
-    
-    // Subtract smaller magnitude from larger magnitude
-    struct di_int_internal* result = di_alloc(larger->limb_count);
-    DI_ASSERT(result && "di_sub: allocation failed");
-    
-    result->is_negative = result_negative;
-    result->limb_count = larger->limb_count;
-    
-    di_limb_t borrow = 0;
-    for (size_t i = 0; i < result->limb_count; i++) {
-        di_limb_t a_limb = (i < larger->limb_count) ? larger->limbs[i] : 0;
-        di_limb_t b_limb = (i < smaller->limb_count) ? smaller->limbs[i] : 0;
-        
-        // Use signed arithmetic to detect underflow
-        int64_t signed_diff = (int64_t)a_limb - (int64_t)b_limb - (int64_t)borrow;
-        
-        di_dlimb_t diff;
-        if (signed_diff < 0) {
-            diff = (di_dlimb_t)(signed_diff + (1ULL << DI_LIMB_BITS));
-            borrow = 1;
+}
+
+static const uint8_t di_small_primes[] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61,
+    67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131, 137,
+    139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211,
+    223, 227, 229, 233, 239, 241, 251
+};
+
+#define DI_SMALL_PRIME_COUNT (sizeof(di_small_primes) / sizeof(di_small_primes[0]))
+
+// Miller-Rabin test of an odd n > 3 (len limbs, top limb non-zero).
+// Without base_seed the bases are the first 'rounds' small primes, which
+// is deterministic for n < 3.3e24 once rounds >= 13. With base_seed the
+// first base is 2 and the rest come from the splitmix64 stream it holds,
+// a private sequence that cannot fail and touches no di_rng.
+static bool di_miller_rabin(const di_limb_t* n, size_t len, int rounds, uint64_t* base_seed) {
+    size_t nbits = (len - 1) * DI_LIMB_BITS;
+    for (di_limb_t top = n[len - 1]; top; top >>= 1) nbits++;
+
+    // n - 1 = d * 2^s; n is odd so bit 0 of n - 1 is clear and s >= 1
+    size_t s = 1;
+    while (!di_limb_test_bit(n, s)) s++;
+
+    di_mont_ctx ctx;
+    di_mont_init(&ctx, n, len);
+    di_limb_t* a = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * len * 2);
+    DI_ASSERT(a && "di_miller_rabin: allocation failed");
+    di_limb_t* x = a + len;
+
+    bool probable = true;
+    for (int round = 0; round < rounds && probable; round++) {
+        memset(a, 0, sizeof(di_limb_t) * len);
+        if (!base_seed || round == 0) {
+            if (round >= (int)DI_SMALL_PRIME_COUNT) break;
+            a[0] = di_small_primes[round];
+            // Bases must lie in [2, n - 2]
+            if (len == 1 && a[0] >= n[0] - 1) break;
         } else {
-            diff = (di_dlimb_t)signed_diff;
-            borrow = 0;
+            // nbits - 1 random bits stay below n; retry values below 2
+            size_t limbs = (nbits - 1 + DI_LIMB_BITS - 1) / DI_LIMB_BITS;
+            size_t high_bits = (nbits - 1) % DI_LIMB_BITS;
+            bool too_small;
+            do {
+                for (size_t i = 0; i < limbs; i++) a[i] = (di_limb_t)di_splitmix64(base_seed);
+                if (high_bits) a[limbs - 1] &= (di_limb_t)(((di_limb_t)1 << high_bits) - 1);
+                too_small = a[0] < 2;
+                for (size_t i = 1; i < limbs; i++) {
+                    if (a[i]) too_small = false;
+                }
+            } while (too_small);
+        }
+
+        di_mont_mul(&ctx, a, a, ctx.r2);
+        di_mont_pow(&ctx, x, a, n, s, nbits);
+        if (di_limbs_cmp(x, ctx.one, len) == 0 || di_limbs_cmp(x, ctx.neg_one, len) == 0) {
+            continue;
+        }
+        probable = false;
+        for (size_t i = 1; i < s; i++) {
+            di_mont_mul(&ctx, x, x, x);
+            if (di_limbs_cmp(x, ctx.neg_one, len) == 0) {
+                probable = true;
+                break;
+            }
+            if (di_limbs_cmp(x, ctx.one, len) == 0) break;
         }
-        
-        result->limbs[i] = (di_limb_t)diff;
     }
-    
-    di_normalize(result);
-    return result;
+
+    DI_FREE(a);
+    di_mont_free(&ctx);
+    return probable;
 }
 
-DI_IMPL di_int di_add_i32(di_int a, int32_t b) {
-    DI_ASSERT(a && "di_add_i32: operand cannot be NULL");
-    
-    // Convert int32 to big integer and use regular addition
-    di_int b_big = di_from_int32(b);
-    DI_ASSERT(b_big && "di_add_i32: allocation failed");
-    
-    di_int result = di_add(a, b_big);
-    di_release(&b_big);
+// Exponentiation by squaring, scanning exp from the low bit
+static di_int di_pow_internal(di_int base, uint32_t exp) {
+    di_int result = di_one();
+    di_int square = di_retain(base);
+    while (exp) {
+        if (exp & 1) {
+            di_int product = di_mul(result, square);
+            di_release(&result);
+            result = product;
+        }
+        exp >>= 1;
+        if (exp) {
+            di_int next = di_mul(square, square);
+            di_release(&square);
+            square = next;
+        }
+    }
+    di_release(&square);
     return result;
 }
 
-DI_IMPL di_int di_sub(di_int a, di_int b) {
-    DI_ASSERT(a != NULL && "di_sub: first operand cannot be NULL");
-    DI_ASSERT(b != NULL && "di_sub: second operand cannot be NULL");
-    
-    // a - b = a + (-b)
-    di_int neg_b = di_negate(b);
-    DI_ASSERT(neg_b && "di_sub: allocation failed");
-    
-    di_int result = di_add(a, neg_b);
-    di_release(&neg_b);
+DI_IMPL di_int di_pow(di_int base, uint32_t exp) {
+    DI_ASSERT(base && "di_pow: base cannot be NULL");
+    DI_STATS_OP(DI_STATS_POW, base->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_POW, base->limb_count, 0);
+    di_int result = di_pow_internal(base, exp);
+    DI_TRACE_END();
     return result;
 }
 
-DI_IMPL di_int di_sub_i32(di_int a, int32_t b) {
-    DI_ASSERT(a && "di_sub_i32: operand cannot be NULL");
+// Modular exponentiation: (base^exp) mod mod
+// Odd positive moduli use Montgomery multiplication on the limb arrays;
+// other moduli fall back to binary exponentiation with di_mod
+static di_int di_mod_pow_internal(di_int base, di_int exp, di_int mod) {
+    if (di_is_one(mod)) return di_zero(); // x mod 1 = 0
     
-    // Convert int32 to big integer and use regular subtraction
-    di_int b_big = di_from_int32(b);
-    DI_ASSERT(b_big && "di_sub_i32: allocation failed");
+    if (di_is_zero(exp)) return di_one(); // base^0 = 1
+    if (di_is_zero(base)) return di_zero(); // 0^exp = 0
     
-    di_int result = di_sub(a, b_big);
-    di_release(&b_big);
-    return result;
-}
+    di_int base_mod = di_mod(base, mod); // Reduce base first
+    if (!base_mod) return NULL;
 
-DI_IMPL di_int di_negate(di_int a) {
-    DI_ASSERT(a && "di_negate: operand cannot be NULL");
-    
-    di_int result = di_copy(a);
-    if (result && result->limb_count > 0) {
-        result->is_negative = !result->is_negative;
+    if (!mod->is_negative && !exp->is_negative && (mod->limbs[0] & 1)) {
+        // Montgomery needs 0 <= base < mod
+        if (base_mod->is_negative) {
+            di_int wrapped = di_add(base_mod, mod);
+            di_release(&base_mod);
+            base_mod = wrapped;
+            if (!base_mod) return NULL;
+        }
+        size_t len = mod->limb_count;
+        di_mont_ctx ctx;
+        di_mont_init(&ctx, mod->limbs, len);
+
+        struct di_int_internal* result = di_alloc(len);
+        di_limb_t* b = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * len);
+        DI_ASSERT(b && "di_mod_pow: allocation failed");
+        memset(b, 0, sizeof(di_limb_t) * len);
+        memcpy(b, base_mod->limbs, sizeof(di_limb_t) * base_mod->limb_count);
+
+        di_mont_mul(&ctx, b, b, ctx.r2);
+        di_mont_pow(&ctx, result->limbs, b, exp->limbs, 0, di_bit_length(exp));
+
+        // Leave Montgomery form: multiply by plain 1
+        memset(b, 0, sizeof(di_limb_t) * len);
+        b[0] = 1;
+        di_mont_mul(&ctx, result->limbs, result->limbs, b);
+
+        DI_FREE(b);
+        di_mont_free(&ctx);
+        di_release(&base_mod);
+        result->limb_count = len;
+        di_normalize(result);
+        return result;
     }
-    return result;
-}
 
-/* String conversion implementation */
-DI_IMPL char* di_to_string(di_int big, int base) {
-    DI_ASSERT(big && "di_to_string: operand cannot be NULL");
-    DI_ASSERT(base >= 2 && base <= 36 && "di_to_string: invalid base");
+    di_int result = di_one();
+    di_int exp_copy = di_copy(exp);
+    di_int two = di_from_int32(2);
     
-    if (big->limb_count == 0) {
-        char* str = (char*)DI_MALLOC(2);
-        DI_ASSERT(str && "di_to_string: allocation failed for zero string");
-        str[0] = '0';
-        str[1] = '\0';
-        return str;
+    if (!result || !exp_copy || !two) {
+        di_release(&result);
+        di_release(&base_mod);
+        di_release(&exp_copy);
+        di_release(&two);
+        return NULL;
     }
     
-    // Simple implementation for base 10
-    if (base == 10) {
-        // Proper arbitrary precision decimal conversion using efficient modular arithmetic
-        size_t max_digits = big->limb_count * 10 + 10;
-        char* buffer = (char*)DI_MALLOC(max_digits);
-        DI_ASSERT(buffer && "di_to_string: buffer allocation failed");
-        
-        // Make a working copy
-        di_int work = di_copy(big);
-
-        char* digits = (char*)DI_MALLOC(max_digits);
-        DI_ASSERT(digits && "di_to_string: digits allocation failed");
-        
-        size_t digit_count = 0;
-        
-        // Handle zero case
-        if (di_is_zero(work)) {
-            buffer[0] = '0';
-            buffer[1] = '\0';
-            DI_FREE(digits);
-            di_release(&work);
-            return buffer;
-        }
-        
-        // Extract digits using limb-level division by 10 (much more efficient than di_div)
-        while (!di_is_zero(work)) {
-            // Divide by 10 using limb arithmetic
-            di_dlimb_t remainder = 0;
-            for (int i = (int)work->limb_count - 1; i >= 0; i--) {
-                di_dlimb_t temp = remainder * ((di_dlimb_t)DI_LIMB_MAX + 1) + work->limbs[i];
-                work->limbs[i] = (di_limb_t)(temp / 10);
-                remainder = temp % 10;
-            }
-            
-            // Store the digit
-            digits[digit_count++] = '0' + (char)remainder;
-            
-            // Remove leading zeros
-            while (work->limb_count > 0 && work->limbs[work->limb_count - 1] == 0) {
-                work->limb_count--;
+    // Binary exponentiation
+    while (!di_is_zero(exp_copy)) {
+        // If exp is odd, multiply result by base_mod
+        di_int remainder = di_mod(exp_copy, two);
+        if (remainder && !di_is_zero(remainder)) {
+            di_int temp = di_mul(result, base_mod);
+            if (temp) {
+                di_int new_result = di_mod(temp, mod);
+                di_release(&temp);
+                di_release(&result);
+                result = new_result;
             }
         }
+        di_release(&remainder);
         
-        // Build result string (digits are in reverse order)
-        size_t pos = 0;
-        if (big->is_negative) {
-            buffer[pos++] = '-';
-        }
-        
-        for (size_t i = digit_count; i > 0; i--) {
-            buffer[pos++] = digits[i - 1];
+        // Square base_mod and divide exp by 2
+        di_int base_squared = di_mul(base_mod, base_mod);
+        if (base_squared) {
+            di_int new_base = di_mod(base_squared, mod);
+            di_release(&base_squared);
+            di_release(&base_mod);
+            base_mod = new_base;
         }
-        buffer[pos] = '\0';
         
-        DI_FREE(digits);
-        di_release(&work);
+        di_int new_exp = di_div(exp_copy, two);
+        di_release(&exp_copy);
+        exp_copy = new_exp;
         
-        return buffer;
+        if (!result || !base_mod || !exp_copy) break;
+    }
+    
+    di_release(&base_mod);
+    di_release(&exp_copy);
+    di_release(&two);
+    
+    return result;
+}
+
+DI_IMPL di_int di_mod_pow(di_int base, di_int exp, di_int mod) {
+    DI_ASSERT(base && "di_mod_pow: base cannot be NULL");
+    DI_ASSERT(exp && "di_mod_pow: exponent cannot be NULL");
+    DI_ASSERT(mod && "di_mod_pow: modulus cannot be NULL");
+    DI_ASSERT(!di_is_zero(mod) && "di_mod_pow: modulus cannot be zero");
+    DI_STATS_OP(DI_STATS_MOD_POW, base->limb_count + exp->limb_count + mod->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_MOD_POW, base->limb_count + exp->limb_count, mod->limb_count);
+    di_int result = di_mod_pow_internal(base, exp, mod);
+    DI_TRACE_END();
+    return result;
+}
+
+// Primality test: trial division by small primes, then Miller-Rabin
+static bool di_is_prime_internal(di_int n, int certainty) {
+    if (n->is_negative || n->limb_count == 0) return false;
+
+    // Trial division; exact for n below 257^2
+    for (size_t i = 0; i < DI_SMALL_PRIME_COUNT; i++) {
+        di_limb_t p = di_small_primes[i];
+        di_dlimb_t rem = 0;
+        for (size_t j = n->limb_count; j-- > 0;) {
+            rem = ((rem << DI_LIMB_BITS) | n->limbs[j]) % p;
+        }
+        if (rem == 0) return n->limb_count == 1 && n->limbs[0] == p;
+        if (n->limb_count == 1 && (di_dlimb_t)p * p > n->limbs[0]) return n->limbs[0] > 1;
+    }
+
+    // The first 13 prime bases are exact below 3.3e24 (about 2^81.4)
+    size_t bits = di_bit_length(n);
+    if (bits <= 81) return di_miller_rabin(n->limbs, n->limb_count, 13, NULL);
+
+    // Random bases come from a private stream so the caller's default
+    // generator is left alone. It is seeded from n and a per-process value
+    // (the address of a static, which varies with ASLR)
+    uint64_t seed = (uint64_t)(uintptr_t)&di_small_primes;
+    for (size_t i = 0; i < n->limb_count; i++) {
+        seed = (seed ^ n->limbs[i]) * 0x100000001B3ULL;
+    }
+    return di_miller_rabin(n->limbs, n->limb_count, certainty < 1 ? 1 : certainty, &seed);
+}
+
+DI_IMPL bool di_is_prime(di_int n, int certainty) {
+    DI_ASSERT(n && "di_is_prime: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_PRIME, n->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_PRIME, n->limb_count, 0);
+    bool result = di_is_prime_internal(n, certainty);
+    DI_TRACE_END();
+    return result;
+}
+
+// Find next prime number >= n
+static di_int di_next_prime_internal(di_int n) {
+    di_int two = di_from_int32(2);
+    if (di_le(n, two)) return two;
+
+    // Start at the first odd number >= n
+    di_int candidate = (n->limbs[0] & 1) ? di_copy(n) : di_add_i32(n, 1);
+    DI_ASSERT(candidate && "di_next_prime: allocation failed");
+    
+    // Check odd numbers until we find a prime
+    while (candidate && !di_is_prime(candidate, 13)) {
+        di_int new_candidate = di_add(candidate, two);
+        di_release(&candidate);
+        candidate = new_candidate;
     }
     
-    return NULL;
+    di_release(&two);
+    return candidate;
 }
 
-/* Overflow detection helpers */
+DI_IMPL di_int di_next_prime(di_int n) {
+    DI_ASSERT(n && "di_next_prime: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_PRIME, n->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_PRIME, n->limb_count, 0);
+    di_int result = di_next_prime_internal(n);
+    DI_TRACE_END();
+    return result;
+}
 
-DI_IMPL bool di_add_overflow_int32(int32_t a, int32_t b, int32_t* result) {
-    DI_ASSERT(result && "di_add_overflow_int32: result pointer cannot be NULL");
-    int64_t sum = (int64_t)a + (int64_t)b;
-    if (sum < INT32_MIN || sum > INT32_MAX) {
-        return false;  // Overflow
+// Random number generation (NOT cryptographically secure)
+// Each di_rng is an independent xoshiro256** stream; nothing is shared
+// between generators, so threads with their own di_rng never contend.
+// Define DI_RNG_USE_RAND on targets where 64-bit arithmetic is too costly
+// to fall back to the C library's rand(), which is NOT reentrant.
+
+static uint64_t di_splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#ifndef DI_RNG_USE_RAND
+static uint64_t di_rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+#endif
+
+static uint64_t di_rng_next(di_rng* rng) {
+#ifdef DI_RNG_USE_RAND
+    (void)rng;
+    uint64_t z = 0;
+    for (int i = 0; i < 8; i++) {
+        z = (z << 8) | (uint64_t)(rand() & 0xFF);
     }
-    *result = (int32_t)sum;
-    return true;
+    return z;
+#else
+    uint64_t* s = rng->s;
+    uint64_t result = di_rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = di_rotl64(s[3], 45);
+    return result;
+#endif
 }
 
-DI_IMPL bool di_subtract_overflow_int32(int32_t a, int32_t b, int32_t* result) {
-    DI_ASSERT(result && "di_subtract_overflow_int32: result pointer cannot be NULL");
-    int64_t diff = (int64_t)a - (int64_t)b;
-    if (diff < INT32_MIN || diff > INT32_MAX) {
-        return false;  // Overflow
+DI_IMPL void di_rng_seed(di_rng* rng, uint64_t seed) {
+    DI_ASSERT(rng && "di_rng_seed: generator cannot be NULL");
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = di_splitmix64(&seed);
     }
-    *result = (int32_t)diff;
-    return true;
+    rng->entropy = NULL;
+    rng->entropy_ctx = NULL;
+#ifdef DI_RNG_USE_RAND
+    srand((unsigned)rng->s[0]);
+#endif
 }
 
-DI_IMPL bool di_multiply_overflow_int32(int32_t a, int32_t b, int32_t* result) {
-    DI_ASSERT(result && "di_multiply_overflow_int32: result pointer cannot be NULL");
-    int64_t prod = (int64_t)a * (int64_t)b;
-    if (prod < INT32_MIN || prod > INT32_MAX) {
-        return false;  // Overflow
+DI_IMPL void di_rng_jump(di_rng* rng) {
+    DI_ASSERT(rng && "di_rng_jump: generator cannot be NULL");
+    static const uint64_t jump[4] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & ((uint64_t)1 << b)) {
+                for (int k = 0; k < 4; k++) s[k] ^= rng->s[k];
+            }
+            di_rng_next(rng);
+        }
     }
-    *result = (int32_t)prod;
-    return true;
+    memcpy(rng->s, s, sizeof(s));
 }
 
-DI_IMPL bool di_add_overflow_int64(int64_t a, int64_t b, int64_t* result) {
-    DI_ASSERT(result && "di_add_overflow_int64: result pointer cannot be NULL");
-    // Check for overflow without causing UB
-    if (b > 0 && a > INT64_MAX - b) return false;
-    if (b < 0 && a < INT64_MIN - b) return false;
-    *result = a + b;
+#if defined(DI_HAS_GETRANDOM)
+static bool di_os_entropy(void* ctx, void* buf, size_t size) {
+    (void)ctx;
+    uint8_t* out = (uint8_t*)buf;
+    while (size > 0) {
+        ssize_t n = getrandom(out, size, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        out += n;
+        size -= (size_t)n;
+    }
     return true;
 }
+#elif defined(DI_HAS_URANDOM)
+static bool di_os_entropy(void* ctx, void* buf, size_t size) {
+    (void)ctx;
+    FILE* f = fopen("/dev/urandom", "rb");
+    if (!f) return false;
+    size_t n = fread(buf, 1, size, f);
+    fclose(f);
+    return n == size;
+}
+#endif
 
-DI_IMPL bool di_subtract_overflow_int64(int64_t a, int64_t b, int64_t* result) {
-    DI_ASSERT(result && "di_subtract_overflow_int64: result pointer cannot be NULL");
-    // Check for overflow without causing UB
-    if (b < 0 && a > INT64_MAX + b) return false;
-    if (b > 0 && a < INT64_MIN + b) return false;
-    *result = a - b;
+DI_IMPL bool di_rng_secure(di_rng* rng) {
+    DI_ASSERT(rng && "di_rng_secure: generator cannot be NULL");
+#if defined(DI_HAS_GETRANDOM) || defined(DI_HAS_URANDOM)
+    di_rng_set_entropy(rng, di_os_entropy, NULL);
     return true;
+#else
+    return false;
+#endif
 }
 
-DI_IMPL bool di_multiply_overflow_int64(int64_t a, int64_t b, int64_t* result) {
-    DI_ASSERT(result && "di_multiply_overflow_int64: result pointer cannot be NULL");
-    // Check for overflow - this is complex for 64-bit
-    if (a == 0 || b == 0) {
-        *result = 0;
-        return true;
+DI_IMPL void di_rng_set_entropy(di_rng* rng, di_entropy_fn fn, void* ctx) {
+    DI_ASSERT(rng && "di_rng_set_entropy: generator cannot be NULL");
+    rng->entropy = fn;
+    rng->entropy_ctx = ctx;
+}
+
+DI_IMPL bool di_random_fill(di_rng* rng, void* buf, size_t size) {
+    DI_ASSERT((buf || size == 0) && "di_random_fill: buffer cannot be NULL");
+    if (!rng) rng = di_rng_default();
+    if (size == 0) return true;
+    if (rng->entropy) return rng->entropy(rng->entropy_ctx, buf, size);
+
+    uint8_t* out = (uint8_t*)buf;
+    while (size >= 8) {
+        uint64_t r = di_rng_next(rng);
+        memcpy(out, &r, 8);
+        out += 8;
+        size -= 8;
     }
-    
-    // Check if multiplication would overflow
-    if (a > 0) {
-        if (b > 0) {
-            if (a > INT64_MAX / b) return false;
-        } else {
-            if (b < INT64_MIN / a) return false;
-        }
-    } else {
-        if (b > 0) {
-            if (a < INT64_MIN / b) return false;
-        } else {
-            if (a != 0 && b < INT64_MAX / a) return false;
-        }
+    if (size > 0) {
+        uint64_t r = di_rng_next(rng);
+        memcpy(out, &r, size);
     }
-    
-    *result = a * b;
     return true;
 }
 
-// Big integer multiplication - use the original working approach for single limb case, full algorithm for multi-limb
-DI_IMPL di_int di_mul(di_int a, di_int b) {
-    DI_ASSERT(a != NULL && "di_mul: first operand cannot be NULL");
-    DI_ASSERT(b != NULL && "di_mul: second operand cannot be NULL");
-    
-    // Handle zero cases
-    if (a->limb_count == 0 || b->limb_count == 0) {
-        return di_from_int32(0);
-    }
-    
-    // For single limb x single limb, use direct 64-bit multiplication (should be exact)
-    if (a->limb_count == 1 && b->limb_count == 1) {
-        di_dlimb_t product = (di_dlimb_t)a->limbs[0] * (di_dlimb_t)b->limbs[0];
-        bool result_negative = (a->is_negative != b->is_negative);
-        
-        if (product <= DI_LIMB_MAX) {
-            // Result fits in one limb
-            di_int result = di_from_uint32((uint32_t)product);
-            if (result && result_negative && product > 0) {
-                result->is_negative = true;
-            }
-            return result;
-        } else {
-            // Result needs two limbs
-            struct di_int_internal* result = di_alloc(2);
-            DI_ASSERT(result && "di_mul: allocation failed");
-            
-            result->is_negative = result_negative;
-            result->limb_count = 2;
-            result->limbs[0] = (di_limb_t)(product & DI_LIMB_MAX);
-            result->limbs[1] = (di_limb_t)(product >> DI_LIMB_BITS);
-            
-            di_normalize(result);
-            return result;
+#ifdef DI_SECURE_RANDOM
+static bool di_no_entropy(void* ctx, void* buf, size_t size) {
+    (void)ctx;
+    (void)buf;
+    (void)size;
+    return false;
+}
+#endif
+
+DI_IMPL di_rng* di_rng_default(void) {
+    static DI_THREAD_LOCAL di_rng default_rng;
+    static DI_THREAD_LOCAL bool seeded = false;
+
+    if (!seeded) {
+        // The address differs per thread, giving each thread its own stream
+        di_rng_seed(&default_rng, 0x853C49E6748FEA9BULL ^ (uint64_t)(uintptr_t)&default_rng);
+#ifdef DI_SECURE_RANDOM
+        // Without an OS source di_random() fails until the application
+        // installs one with di_rng_set_entropy(di_rng_default(), ...)
+        if (!di_rng_secure(&default_rng)) {
+            di_rng_set_entropy(&default_rng, di_no_entropy, NULL);
         }
+#endif
+        seeded = true;
     }
+    return &default_rng;
+}
+
+DI_IMPL di_int di_random(size_t bits) {
+    return di_random_r(bits, NULL);
+}
+
+DI_IMPL di_int di_random_r(size_t bits, di_rng* rng) {
+    if (bits == 0) return di_zero();
+    if (!rng) rng = di_rng_default();
     
-    // For multi-limb cases, use proper schoolbook multiplication
-    bool result_negative = (a->is_negative != b->is_negative);
-    size_t result_capacity = a->limb_count + b->limb_count;
-    struct di_int_internal* result = di_alloc(result_capacity);
-    DI_ASSERT(result && "di_mul: allocation failed");
-    
-    result->is_negative = result_negative;
-    result->limb_count = result_capacity;
+    size_t limbs_needed = (bits + DI_LIMB_BITS - 1) / DI_LIMB_BITS;
+    struct di_int_internal* result = di_alloc(limbs_needed);
+    DI_ASSERT(result && "di_random: allocation failed");
     
-    // Initialize result to zero
-    for (size_t i = 0; i < result_capacity; i++) {
-        result->limbs[i] = 0;
+    if (!di_random_fill(rng, result->limbs, sizeof(di_limb_t) * limbs_needed)) {
+        di_release(&result);
+        return NULL;
     }
     
-    // Schoolbook multiplication
-    for (size_t i = 0; i < a->limb_count; i++) {
-        di_dlimb_t carry = 0;
-        
-        for (size_t j = 0; j < b->limb_count; j++) {
-            size_t pos = i + j;
-            di_dlimb_t prod = (di_dlimb_t)a->limbs[i] * (di_dlimb_t)b->limbs[j];
-            di_dlimb_t sum = (di_dlimb_t)result->limbs[pos] + prod + carry;
-            
-            result->limbs[pos] = (di_limb_t)(sum & DI_LIMB_MAX);
-            carry = sum >> DI_LIMB_BITS;
-        }
-        
-        // Handle remaining carry
-        if (carry > 0 && i + b->limb_count < result_capacity) {
-            result->limbs[i + b->limb_count] = (di_limb_t)carry;
-        }
+    // Mask the high bits to get exactly 'bits' bits
+    size_t high_bits = bits % DI_LIMB_BITS;
+    if (high_bits > 0) {
+        di_limb_t mask = (di_limb_t)(((di_limb_t)1 << high_bits) - 1);
+        result->limbs[limbs_needed - 1] &= mask;
     }
     
+    result->limb_count = limbs_needed;
+    result->is_negative = false;
     di_normalize(result);
+    
     return result;
 }
 
-// Big integer multiplication by int32
-DI_IMPL di_int di_mul_i32(di_int a, int32_t b) {
-    DI_ASSERT(a && "di_mul_i32: operand cannot be NULL");
+// Random number in range [min, max)
+DI_IMPL di_int di_random_range(di_int min, di_int max) {
+    return di_random_range_r(min, max, NULL);
+}
+
+DI_IMPL di_int di_random_range_r(di_int min, di_int max, di_rng* rng) {
+    DI_ASSERT(min && "di_random_range: min cannot be NULL");
+    DI_ASSERT(max && "di_random_range: max cannot be NULL");
+    DI_ASSERT(di_lt(min, max) && "di_random_range: min must be less than max");
     
-    di_int b_big = di_from_int32(b);
-    di_int result = di_mul(a, b_big);
-    di_release(&b_big);
+    // Uniform in [0, limit] where limit = max - min - 1: draw just enough
+    // bits to cover limit and reject anything above it
+    di_int range = di_sub(max, min);
+    DI_ASSERT(range && "di_random_range: allocation failed");
+    di_int limit = di_sub_i32(range, 1);
+    di_release(&range);
+    DI_ASSERT(limit && "di_random_range: allocation failed");
+
+    size_t bits = di_bit_length(limit);
+    di_int offset = NULL;
+    for (;;) {
+        offset = di_random_r(bits, rng);
+        if (!offset || di_le(offset, limit)) break;
+        di_release(&offset);
+    }
+    di_release(&limit);
+    if (!offset) return NULL;
+
+    di_int result = di_add(min, offset);
+    di_release(&offset);
     return result;
 }
 
-// Big integer division - returns quotient
-DI_IMPL di_int di_div(di_int a, di_int b) {
-    DI_ASSERT(a != NULL && "di_div: dividend cannot be NULL");
-    DI_ASSERT(b != NULL && "di_div: divisor cannot be NULL");
-    DI_ASSERT(!di_is_zero(b) && "di_div: division by zero");
-    
-    // Special cases
-    if (di_is_zero(a)) return di_zero();
-    if (di_eq(a, b)) return di_one();
-    
-    // Compare absolute values
-    di_int abs_a = di_abs(a);
-    di_int abs_b = di_abs(b);
-    
-    if (di_lt(abs_a, abs_b)) {
-        di_release(&abs_a);
-        di_release(&abs_b);
-        return di_zero();
+// Random prime generation
+// A full-length random candidate and the next DI_PRIME_WINDOW values
+// along its progression (step 2, or 4 for safe primes) are sieved at once:
+// one residue per small prime marks every multiple in the window, so only
+// survivors reach Miller-Rabin. With DI_THREADS several workers sieve and
+// test their own candidates, drawing them from the caller's generator
+// under a lock.
+
+#define DI_PRIME_SIEVE_LIMIT 16384
+#define DI_PRIME_WINDOW 4096
+
+typedef struct {
+    size_t bits;
+    bool safe;
+    di_rng* rng;            // Candidate source shared by all workers
+    uint16_t* primes;       // Odd sieving primes, NULL for short bit lengths
+    size_t prime_count;
+    di_int result;
+    bool failed;            // The entropy source failed
+#ifdef DI_THREADS
+    bool threaded;
+    pthread_mutex_t lock;
+#endif
+} di_prime_search;
+
+static void di_prime_search_lock(di_prime_search* job) {
+#ifdef DI_THREADS
+    if (job->threaded) pthread_mutex_lock(&job->lock);
+#else
+    (void)job;
+#endif
+}
+
+static void di_prime_search_unlock(di_prime_search* job) {
+#ifdef DI_THREADS
+    if (job->threaded) pthread_mutex_unlock(&job->lock);
+#else
+    (void)job;
+#endif
+}
+
+static uint16_t* di_sieve_primes(size_t* count) {
+    uint8_t* composite = (uint8_t*)DI_MALLOC(DI_PRIME_SIEVE_LIMIT);
+    uint16_t* primes = (uint16_t*)DI_MALLOC(sizeof(uint16_t) * (DI_PRIME_SIEVE_LIMIT / 2));
+    DI_ASSERT(composite && primes && "di_sieve_primes: allocation failed");
+    memset(composite, 0, DI_PRIME_SIEVE_LIMIT);
+
+    *count = 0;
+    for (size_t i = 3; i < DI_PRIME_SIEVE_LIMIT; i += 2) {
+        if (composite[i]) continue;
+        primes[(*count)++] = (uint16_t)i;
+        for (size_t j = i * i; j < DI_PRIME_SIEVE_LIMIT; j += 2 * i) composite[j] = 1;
     }
-    
-    // Proper long division algorithm for efficiency
-    size_t dividend_limbs = abs_a->limb_count;
-    size_t divisor_limbs = abs_b->limb_count;
-    
-    // For single limb divisor, use optimized single-limb division
-    if (divisor_limbs == 1) {
-        di_limb_t divisor_limb = abs_b->limbs[0];
-        struct di_int_internal* quotient = di_alloc(dividend_limbs);
-        if (!quotient) {
-            di_release(&abs_a);
-            di_release(&abs_b);
-            return NULL;
-        }
-        
-        quotient->limb_count = dividend_limbs;
-        di_dlimb_t remainder = 0;
-        
-        // Divide from most significant to least significant limb
-        for (int i = (int)dividend_limbs - 1; i >= 0; i--) {
-            di_dlimb_t temp = remainder * ((di_dlimb_t)DI_LIMB_MAX + 1) + abs_a->limbs[i];
-            quotient->limbs[i] = (di_limb_t)(temp / divisor_limb);
-            remainder = temp % divisor_limb;
+    DI_FREE(composite);
+    return primes;
+}
+
+// Miller-Rabin rounds for a random candidate; composites almost always
+// fail the first round, so the extra rounds only cost time on the result
+static int di_prime_rounds(size_t bits) {
+    if (bits < 64) return 13;   // fixed bases, deterministic in this range
+    if (bits >= 1024) return 8;
+    if (bits >= 512) return 12;
+    if (bits >= 256) return 20;
+    return 32;
+}
+
+static bool di_limbs_probable_prime(const di_limb_t* n, size_t len, int rounds, uint64_t* base_seed) {
+    while (len > 0 && n[len - 1] == 0) len--;
+    if (len == 0) return false;
+    if (len == 1 && n[0] <= 3) return n[0] >= 2;
+    if (!(n[0] & 1)) return false;
+    return di_miller_rabin(n, len, rounds, base_seed);
+}
+
+static void di_prime_search_run(di_prime_search* job) {
+    size_t bits = job->bits;
+    size_t len = (bits + DI_LIMB_BITS - 1) / DI_LIMB_BITS;
+    size_t high_bits = bits % DI_LIMB_BITS;
+    di_limb_t step = job->safe ? 4 : 2;
+    int rounds = di_prime_rounds(bits);
+
+    di_limb_t* base = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * len * 3);
+    uint8_t* sieve = (uint8_t*)DI_MALLOC(DI_PRIME_WINDOW);
+    DI_ASSERT(base && sieve && "di_random_prime: allocation failed");
+    di_limb_t* cand = base + len;
+    di_limb_t* half = base + 2 * len;
+
+    // Miller-Rabin bases come from a private stream seeded by the caller's
+    uint64_t seed = 0;
+    di_prime_search_lock(job);
+    if (!di_random_fill(job->rng, &seed, sizeof(seed))) job->failed = true;
+    di_prime_search_unlock(job);
+    uint64_t* bases = bits >= 64 ? &seed : NULL;
+
+    bool done = false;
+    while (!done) {
+        di_prime_search_lock(job);
+        done = job->result || job->failed;
+        if (!done && !di_random_fill(job->rng, base, sizeof(di_limb_t) * len)) {
+            job->failed = done = true;
         }
-        
-        di_normalize(quotient);
-        
-        // Set result sign and apply floor division semantics
-        bool result_negative = (a->is_negative != b->is_negative);
-        
-        // For floor division: if result would be negative and there's a remainder,
-        // we need to add 1 to the quotient magnitude (going more negative)
-        if (result_negative && remainder > 0 && quotient->limb_count > 0) {
-            // Add 1 to quotient magnitude for floor division
-            di_int one = di_one();
-            di_int adjusted_quotient = di_add(quotient, one);
-            di_release(&quotient);
-            di_release(&one);
-            quotient = adjusted_quotient;
-            quotient->is_negative = true;
-        } else if (result_negative && quotient->limb_count > 0) {
-            quotient->is_negative = true;
+        di_prime_search_unlock(job);
+        if (done) break;
+
+        // Exactly 'bits' bits, odd, and 3 mod 4 for safe primes
+        if (high_bits) base[len - 1] &= (di_limb_t)(((di_limb_t)1 << high_bits) - 1);
+        base[len - 1] |= (di_limb_t)((di_limb_t)1 << ((bits - 1) % DI_LIMB_BITS));
+        base[0] |= (di_limb_t)(step - 1);
+
+        // Mark k where base + step*k is divisible by p, or (safe primes)
+        // where (base + step*k - 1) / 2 is
+        memset(sieve, 0, DI_PRIME_WINDOW);
+        for (size_t i = 0; i < job->prime_count; i++) {
+            uint32_t p = job->primes[i];
+            di_dlimb_t r = 0;
+            for (size_t j = len; j-- > 0;) {
+                r = ((r << DI_LIMB_BITS) | base[j]) % p;
+            }
+            uint32_t inv = (p + 1) / 2;
+            if (step == 4) inv = (inv * inv) % p;
+            uint32_t k = (uint32_t)((p - r) % p * inv % p);
+            for (; k < DI_PRIME_WINDOW; k += p) sieve[k] = 1;
+            if (job->safe) {
+                k = (uint32_t)((p + 1 - r) % p * inv % p);
+                for (; k < DI_PRIME_WINDOW; k += p) sieve[k] = 1;
+            }
         }
-        
-        di_release(&abs_a);
-        di_release(&abs_b);
-        return quotient;
-    }
-    
-    // For multi-limb division, fall back to binary long division (more efficient than repeated subtraction)
-    di_int quotient = di_zero();
-    di_int remainder = di_zero();
-    
-    // Process bits from most significant to least significant
-    for (int limb_idx = (int)dividend_limbs - 1; limb_idx >= 0; limb_idx--) {
-        for (int bit = DI_LIMB_BITS - 1; bit >= 0; bit--) {
-            // Shift remainder left by 1
-            di_int temp_remainder = di_shift_left(remainder, 1);
-            di_release(&remainder);
-            remainder = temp_remainder;
-            
-            // Add current bit of dividend to remainder
-            if (abs_a->limbs[limb_idx] & ((di_limb_t)1 << bit)) {
-                di_int temp = di_add_i32(remainder, 1);
-                di_release(&remainder);
-                remainder = temp;
+
+        for (size_t k = 0; k < DI_PRIME_WINDOW && !done; k++) {
+            if (sieve[k]) continue;
+
+            // cand = base + step*k, abandoning the window once it outgrows bits
+            di_dlimb_t carry = (di_dlimb_t)step * k;
+            for (size_t j = 0; j < len; j++) {
+                carry += base[j];
+                cand[j] = (di_limb_t)carry;
+                carry >>= DI_LIMB_BITS;
             }
-            
-            // Shift quotient left by 1
-            di_int temp_quotient = di_shift_left(quotient, 1);
-            di_release(&quotient);
-            quotient = temp_quotient;
-            
-            // If remainder >= divisor, subtract divisor and set bit in quotient
-            if (di_ge(remainder, abs_b)) {
-                di_int temp_remainder = di_sub(remainder, abs_b);
-                di_int temp_quotient = di_add_i32(quotient, 1);
-                di_release(&remainder);
-                di_release(&quotient);
-                remainder = temp_remainder;
-                quotient = temp_quotient;
+            if (carry || (high_bits && (cand[len - 1] >> high_bits))) break;
+
+            di_prime_search_lock(job);
+            done = job->result || job->failed;
+            di_prime_search_unlock(job);
+            if (done) break;
+
+            bool prime;
+            if (job->safe) {
+                for (size_t j = 0; j < len; j++) {
+                    di_limb_t next = j + 1 < len ? cand[j + 1] : 0;
+                    half[j] = (di_limb_t)((cand[j] >> 1) | ((di_dlimb_t)next << (DI_LIMB_BITS - 1)));
+                }
+                // Cheap base-2 check on p before the full test of q
+                prime = di_limbs_probable_prime(cand, len, 1, NULL) &&
+                        di_limbs_probable_prime(half, len, rounds, bases) &&
+                        di_limbs_probable_prime(cand, len, rounds, bases);
+            } else {
+                prime = di_limbs_probable_prime(cand, len, rounds, bases);
             }
-            
-            if (!remainder || !quotient) {
-                di_release(&abs_a);
-                di_release(&abs_b);
-                di_release(&remainder);
-                di_release(&quotient);
-                return NULL;
+            if (!prime) continue;
+
+            struct di_int_internal* found = di_alloc(len);
+            memcpy(found->limbs, cand, sizeof(di_limb_t) * len);
+            found->limb_count = len;
+            di_normalize(found);
+
+            di_prime_search_lock(job);
+            if (!job->result) {
+                job->result = found;
+                found = NULL;
+            }
+            di_prime_search_unlock(job);
+            di_release(&found);
+            done = true;
+        }
+    }
+
+    DI_FREE(sieve);
+    DI_FREE(base);
+}
+
+#ifdef DI_THREADS
+static void* di_prime_search_thread(void* arg) {
+    di_prime_search_run((di_prime_search*)arg);
+    return NULL;
+}
+#endif
+
+static di_int di_random_prime_search(size_t bits, bool safe, di_rng* rng, int threads) {
+    // Resolve the default here so every worker shares the caller's stream
+    if (!rng) rng = di_rng_default();
+    DI_STATS_OP(DI_STATS_RANDOM_PRIME, (bits + DI_LIMB_BITS - 1) / DI_LIMB_BITS);
+    DI_TRACE_BEGIN(DI_STATS_RANDOM_PRIME, (bits + DI_LIMB_BITS - 1) / DI_LIMB_BITS, 0);
+
+    di_prime_search job;
+    memset(&job, 0, sizeof(job));
+    job.bits = bits;
+    job.safe = safe;
+    job.rng = rng;
+    // Sieving is only sound once every candidate (and q) exceeds the primes
+    if (bits > 16) job.primes = di_sieve_primes(&job.prime_count);
+
+#ifdef DI_THREADS
+    pthread_t* workers = NULL;
+    int started = 0;
+    if (threads > 1) {
+        workers = (pthread_t*)DI_MALLOC(sizeof(pthread_t) * (size_t)(threads - 1));
+        DI_ASSERT(workers && "di_random_prime: allocation failed");
+        pthread_mutex_init(&job.lock, NULL);
+        job.threaded = true;
+        for (int i = 0; i < threads - 1; i++) {
+            if (pthread_create(&workers[started], NULL, di_prime_search_thread, &job) == 0) {
+                started++;
             }
         }
     }
-    
-    // Implement floor division (Python-style)
-    bool result_negative = (a->is_negative != b->is_negative);
-    
-    // For floor division: if result would be negative and there's a remainder,
-    // we need to add 1 to the magnitude of the quotient (since we're going more negative)
-    if (result_negative && !di_is_zero(remainder) && quotient->limb_count > 0) {
-        // Add 1 to quotient magnitude for floor division
-        di_int one = di_one();
-        di_int adjusted_quotient = di_add(quotient, one);
-        di_release(&quotient);
-        di_release(&one);
-        quotient = adjusted_quotient;
+    di_prime_search_run(&job);   // the calling thread searches too
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
     }
+    if (job.threaded) pthread_mutex_destroy(&job.lock);
+    DI_FREE(workers);
+#else
+    (void)threads;
+    di_prime_search_run(&job);
+#endif
+
+    DI_FREE(job.primes);
+    DI_TRACE_END();
+    return job.result;
+}
+
+DI_IMPL di_int di_random_prime(size_t bits, di_rng* rng) {
+    DI_ASSERT(bits >= 2 && "di_random_prime: bits must be at least 2");
+    return di_random_prime_search(bits, false, rng, 1);
+}
+
+DI_IMPL di_int di_random_safe_prime(size_t bits, di_rng* rng) {
+    DI_ASSERT(bits >= 3 && "di_random_safe_prime: bits must be at least 3");
+    return di_random_prime_search(bits, true, rng, 1);
+}
+
+DI_IMPL di_int di_random_prime_mt(size_t bits, di_rng* rng, int threads) {
+    DI_ASSERT(bits >= 2 && "di_random_prime_mt: bits must be at least 2");
+    return di_random_prime_search(bits, false, rng, threads);
+}
+
+DI_IMPL di_int di_random_safe_prime_mt(size_t bits, di_rng* rng, int threads) {
+    DI_ASSERT(bits >= 3 && "di_random_safe_prime_mt: bits must be at least 3");
+    return di_random_prime_search(bits, true, rng, threads);
+}
+
+// Calculate bit length of an arbitrary precision integer
+DI_IMPL size_t di_bit_length(di_int big) {
+    DI_ASSERT(big && "di_bit_length: operand cannot be NULL");
+    return di_view_bit_length(di_view_of(big));
+}
+
+DI_IMPL size_t di_view_bit_length(di_view big) {
+    if (big.limb_count == 0) return 0;
     
-    // Set the sign
-    if (result_negative && quotient->limb_count > 0) {
-        quotient->is_negative = true;
-    }
+    // Find the most significant limb
+    size_t high_limb_idx = big.limb_count - 1;
+    di_limb_t high_limb = big.limbs[high_limb_idx];
     
-    di_release(&abs_a);
-    di_release(&abs_b);
-    di_release(&remainder);
+    // Count bits in the high limb
+    size_t high_limb_bits = 0;
+    if (high_limb != 0) {
+        di_limb_t temp = high_limb;
+        while (temp > 0) {
+            high_limb_bits++;
+            temp >>= 1;
+        }
+    }
     
-    return quotient;
+    return high_limb_idx * DI_LIMB_BITS + high_limb_bits;
 }
 
-// Big integer modulo - proper arbitrary precision implementation
-DI_IMPL di_int di_mod(di_int a, di_int b) {
-    DI_ASSERT(a != NULL && "di_mod: dividend cannot be NULL");
-    DI_ASSERT(b != NULL && "di_mod: divisor cannot be NULL");
-    DI_ASSERT(!di_is_zero(b) && "di_mod: modulo by zero");
+// Count of limbs used
+DI_IMPL size_t di_limb_count(di_int big) {
+    DI_ASSERT(big && "di_limb_count: operand cannot be NULL");
+    return big->limb_count;
+}
+
+// Extended Euclidean Algorithm: finds gcd(a,b) and coefficients x,y such that ax + by = gcd(a,b)
+static di_int di_extended_gcd_internal(di_int a, di_int b, di_int* x, di_int* y) {
+    // Initialize
+    di_int old_r = di_abs(a);
+    di_int r = di_abs(b);
+    di_int old_s = di_one();
+    di_int s = di_zero();
+    di_int old_t = di_zero();
+    di_int t = di_one();
     
-    // Special cases
-    if (di_is_zero(a)) return di_zero(); // 0 % b = 0
-    if (di_eq(a, b)) return di_zero();   // a % a = 0
+    if (!old_r || !r || !old_s || !s || !old_t || !t) {
+        di_release(&old_r); di_release(&r);
+        di_release(&old_s); di_release(&s);
+        di_release(&old_t); di_release(&t);
+        return NULL;
+    }
     
-    // For floor modulo: remainder = a - (floor(a/b) * b)
-    // This ensures the remainder has the same sign as the divisor
-    di_int quotient = di_div(a, b);  // Use floor division
-    di_int product = di_mul(quotient, b);
-    di_int remainder = di_sub(a, product);
+    while (!di_is_zero(r)) {
+        di_int quotient = di_div(old_r, r);
+        if (!quotient) break;
+        
+        // (old_r, r) := (r, old_r - quotient * r)
+        di_int temp1 = di_mul(quotient, r);
+        di_int new_r = di_sub(old_r, temp1);
+        di_release(&temp1);
+        di_release(&old_r);
+        old_r = r;
+        r = new_r;
+        
+        // (old_s, s) := (s, old_s - quotient * s)
+        di_int temp2 = di_mul(quotient, s);
+        di_int new_s = di_sub(old_s, temp2);
+        di_release(&temp2);
+        di_release(&old_s);
+        old_s = s;
+        s = new_s;
+        
+        // (old_t, t) := (t, old_t - quotient * t)
+        di_int temp3 = di_mul(quotient, t);
+        di_int new_t = di_sub(old_t, temp3);
+        di_release(&temp3);
+        di_release(&quotient);
+        di_release(&old_t);
+        old_t = t;
+        t = new_t;
+        
+        if (!r || !s || !t) break;
+    }
     
-    di_release(&quotient);
-    di_release(&product);
+    // Set output coefficients
+    *x = old_s;
+    *y = old_t;
     
-    return remainder;
+    di_release(&r);
+    di_release(&s);
+    di_release(&t);
+    
+    return old_r; // This is gcd(a,b)
 }
 
-// Big integer absolute value
-DI_IMPL di_int di_abs(di_int a) {
-    DI_ASSERT(a && "di_abs: operand cannot be NULL");
-    
-    // If already positive or zero, just return a copy
-    if (!a->is_negative) {
-        return di_copy(a);
+DI_IMPL di_int di_extended_gcd(di_int a, di_int b, di_int* x, di_int* y) {
+    DI_ASSERT(a && "di_extended_gcd: first operand cannot be NULL");
+    DI_ASSERT(b && "di_extended_gcd: second operand cannot be NULL");
+    DI_ASSERT(x && "di_extended_gcd: x pointer cannot be NULL");
+    DI_ASSERT(y && "di_extended_gcd: y pointer cannot be NULL");
+    DI_STATS_OP(DI_STATS_GCD, a->limb_count + b->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_GCD, a->limb_count, b->limb_count);
+    di_int result = di_extended_gcd_internal(a, b, x, y);
+    DI_TRACE_END();
+    return result;
+}
+
+/* Binary import/export */
+
+static bool di_host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static di_limb_t di_bswap_limb(di_limb_t x) {
+#if DI_LIMB_BITS == 32
+    return (x >> 24) | ((x >> 8) & 0xFF00u) | ((x << 8) & 0xFF0000u) | (x << 24);
+#else
+    return (di_limb_t)((x >> 8) | (x << 8));
+#endif
+}
+
+// Byte position in a word buffer of byte 'byte' (0 = least significant) of word 'word'
+static size_t di_word_byte_pos(size_t word, size_t byte, size_t count, size_t word_size,
+                               bool big_endian, int order) {
+    size_t w = (order == DI_ORDER_MSF) ? count - 1 - word : word;
+    size_t b = big_endian ? word_size - 1 - byte : byte;
+    return w * word_size + b;
+}
+
+DI_IMPL size_t di_export_size(di_int big, size_t word_size) {
+    DI_ASSERT(big && "di_export_size: operand cannot be NULL");
+    DI_ASSERT(word_size > 0 && "di_export_size: word size must be positive");
+
+    size_t bits = di_bit_length(big);
+    size_t word_bits = word_size * 8;
+    return (bits + word_bits - 1) / word_bits;
+}
+
+static size_t di_export_internal(di_int big, void* buf, size_t cap, size_t word_size, int endianness, int order) {
+    size_t count = di_export_size(big, word_size);
+    if (count == 0 || cap / word_size < count) return 0;
+    DI_ASSERT(buf && "di_export: buffer cannot be NULL");
+
+    uint8_t* out = (uint8_t*)buf;
+    bool host_le = di_host_is_little_endian();
+    bool big_endian = (endianness == DI_ENDIAN_BIG) || (endianness == DI_ENDIAN_NATIVE && !host_le);
+
+    // Fast path: words are limbs, so copy them (byte swapped if needed)
+    if (word_size == sizeof(di_limb_t)) {
+        bool swap = big_endian == host_le;
+        if (!swap && order == DI_ORDER_LSF) {
+            memcpy(out, big->limbs, sizeof(di_limb_t) * count);
+            return count;
+        }
+        for (size_t i = 0; i < count; i++) {
+            di_limb_t limb = swap ? di_bswap_limb(big->limbs[i]) : big->limbs[i];
+            size_t w = (order == DI_ORDER_MSF) ? count - 1 - i : i;
+            memcpy(out + w * sizeof(di_limb_t), &limb, sizeof(di_limb_t));
+        }
+        return count;
     }
-    
-    // Create a positive copy of the negative number
-    di_int result = di_copy(a);
-    if (result && result->limb_count > 0) {
-        result->is_negative = false;
+
+    // Generic path: place every magnitude byte individually
+    size_t total = count * word_size;
+    for (size_t i = 0; i < total; i++) {
+        size_t limb_idx = i / sizeof(di_limb_t);
+        uint8_t byte = 0;
+        if (limb_idx < big->limb_count) {
+            byte = (uint8_t)(big->limbs[limb_idx] >> (8 * (i % sizeof(di_limb_t))));
+        }
+        out[di_word_byte_pos(i / word_size, i % word_size, count, word_size, big_endian, order)] = byte;
     }
+
+    return count;
+}
+
+DI_IMPL size_t di_export(di_int big, void* buf, size_t cap, size_t word_size, int endianness, int order) {
+    DI_ASSERT(big && "di_export: operand cannot be NULL");
+    DI_ASSERT(word_size > 0 && "di_export: word size must be positive");
+    DI_ASSERT((order == DI_ORDER_MSF || order == DI_ORDER_LSF) && "di_export: invalid word order");
+    DI_ASSERT(endianness >= -1 && endianness <= 1 && "di_export: invalid endianness");
+    DI_STATS_OP(DI_STATS_EXPORT, big->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_EXPORT, big->limb_count, 0);
+    size_t result = di_export_internal(big, buf, cap, word_size, endianness, order);
+    DI_TRACE_END();
     return result;
 }
 
-// Bitwise operations
-DI_IMPL di_int di_and(di_int a, di_int b) {
-    DI_ASSERT(a && "di_and: first operand cannot be NULL");
-    DI_ASSERT(b && "di_and: second operand cannot be NULL");
-    
-    size_t max_limbs = (a->limb_count > b->limb_count) ? a->limb_count : b->limb_count;
-    struct di_int_internal* result = di_alloc(max_limbs);
-    DI_ASSERT(result && "allocation failed");
-    
-    // AND operation on limbs
-    for (size_t i = 0; i < max_limbs; i++) {
-        di_limb_t a_limb = (i < a->limb_count) ? a->limbs[i] : 0;
-        di_limb_t b_limb = (i < b->limb_count) ? b->limbs[i] : 0;
-        result->limbs[i] = a_limb & b_limb;
+static di_int di_import_internal(const void* buf, size_t count, size_t word_size, int endianness, int order) {
+    if (count == 0) return di_zero();
+    DI_ASSERT(buf && "di_import: buffer cannot be NULL");
+
+    const uint8_t* in = (const uint8_t*)buf;
+    bool host_le = di_host_is_little_endian();
+    bool big_endian = (endianness == DI_ENDIAN_BIG) || (endianness == DI_ENDIAN_NATIVE && !host_le);
+
+    size_t total = count * word_size;
+    size_t limbs_needed = (total + sizeof(di_limb_t) - 1) / sizeof(di_limb_t);
+    struct di_int_internal* result = di_alloc(limbs_needed);
+    result->limb_count = limbs_needed;
+
+    // Fast path: words are limbs, so copy them (byte swapped if needed)
+    if (word_size == sizeof(di_limb_t)) {
+        bool swap = big_endian == host_le;
+        if (!swap && order == DI_ORDER_LSF) {
+            memcpy(result->limbs, in, sizeof(di_limb_t) * count);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                di_limb_t limb;
+                size_t w = (order == DI_ORDER_MSF) ? count - 1 - i : i;
+                memcpy(&limb, in + w * sizeof(di_limb_t), sizeof(di_limb_t));
+                result->limbs[i] = swap ? di_bswap_limb(limb) : limb;
+            }
+        }
+        di_normalize(result);
+        return result;
     }
-    result->limb_count = max_limbs;
-    
-    // Result is positive (bitwise operations on magnitudes)
-    result->is_negative = false;
+
+    // Generic path: gather every magnitude byte individually
+    for (size_t i = 0; i < total; i++) {
+        uint8_t byte = in[di_word_byte_pos(i / word_size, i % word_size, count, word_size, big_endian, order)];
+        result->limbs[i / sizeof(di_limb_t)] |= (di_limb_t)byte << (8 * (i % sizeof(di_limb_t)));
+    }
+
     di_normalize(result);
-    
     return result;
 }
 
-DI_IMPL di_int di_or(di_int a, di_int b) {
-    DI_ASSERT(a && "di_or: first operand cannot be NULL");
-    DI_ASSERT(b && "di_or: second operand cannot be NULL");
-    
-    size_t max_limbs = (a->limb_count > b->limb_count) ? a->limb_count : b->limb_count;
-    struct di_int_internal* result = di_alloc(max_limbs);
-    DI_ASSERT(result && "allocation failed");
-    
-    // OR operation on limbs
-    for (size_t i = 0; i < max_limbs; i++) {
-        di_limb_t a_limb = (i < a->limb_count) ? a->limbs[i] : 0;
-        di_limb_t b_limb = (i < b->limb_count) ? b->limbs[i] : 0;
-        result->limbs[i] = a_limb | b_limb;
+DI_IMPL di_int di_import(const void* buf, size_t count, size_t word_size, int endianness, int order) {
+    DI_ASSERT(word_size > 0 && "di_import: word size must be positive");
+    DI_ASSERT((order == DI_ORDER_MSF || order == DI_ORDER_LSF) && "di_import: invalid word order");
+    DI_ASSERT(endianness >= -1 && endianness <= 1 && "di_import: invalid endianness");
+    DI_TRACE_BEGIN(DI_STATS_IMPORT, count * word_size, 0);
+    di_int result = di_import_internal(buf, count, word_size, endianness, order);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_IMPORT, result ? result->limb_count : 0);
+    return result;
+}
+
+/* Varint (zigzag LEB128) encoding */
+
+// Bit length of |big| - 1 for a non-zero magnitude
+static size_t di_bit_length_minus_one(di_int big) {
+    size_t bits = di_bit_length(big);
+
+    // Subtracting one only loses a bit when the magnitude is a power of two
+    for (size_t i = 0; i + 1 < big->limb_count; i++) {
+        if (big->limbs[i] != 0) return bits;
     }
-    result->limb_count = max_limbs;
-    
-    // Result is positive (bitwise operations on magnitudes)
-    result->is_negative = false;
-    di_normalize(result);
-    
+    di_limb_t top = big->limbs[big->limb_count - 1];
+    return (top & (top - 1)) == 0 ? bits - 1 : bits;
+}
+
+// Add one to the magnitude in place, growing by a limb if the carry runs out
+static void di_magnitude_increment(struct di_int_internal* big) {
+    for (size_t i = 0; i < big->limb_count; i++) {
+        if (++big->limbs[i] != 0) return;
+    }
+    di_resize_internal(big, big->limb_count + 1);
+    big->limbs[big->limb_count++] = 1;
+}
+
+static uint64_t di_zigzag64(int64_t value) {
+    return ((uint64_t)value << 1) ^ (value < 0 ? UINT64_MAX : 0);
+}
+
+DI_IMPL size_t di_varint_size(di_int big) {
+    DI_ASSERT(big && "di_varint_size: operand cannot be NULL");
+
+    int64_t small;
+    if (di_to_int64(big, &small)) {
+        uint64_t z = di_zigzag64(small);
+        size_t n = 1;
+        while (z >= 0x80) {
+            z >>= 7;
+            n++;
+        }
+        return n;
+    }
+
+    // Zigzag of a big value is (|x| - sign) shifted left once, with the sign in bit 0
+    size_t bits = 1 + (big->is_negative ? di_bit_length_minus_one(big) : di_bit_length(big));
+    return (bits + 6) / 7;
+}
+
+static size_t di_encode_varint_internal(di_int big, uint8_t* buf, size_t cap) {
+    size_t n = di_varint_size(big);
+    if (cap < n) return 0;
+    DI_ASSERT(buf && "di_encode_varint: buffer cannot be NULL");
+
+    // Fast path: values that fit in 64 bits
+    int64_t small;
+    if (di_to_int64(big, &small)) {
+        uint64_t z = di_zigzag64(small);
+        for (size_t i = 0; i + 1 < n; i++) {
+            buf[i] = (uint8_t)((z & 0x7F) | 0x80);
+            z >>= 7;
+        }
+        buf[n - 1] = (uint8_t)z;
+        return n;
+    }
+
+    // Stream the zigzag bits, subtracting one from negative magnitudes on the fly
+    di_dlimb_t acc = big->is_negative ? 1 : 0;
+    size_t acc_bits = 1;
+    di_limb_t borrow = big->is_negative ? 1 : 0;
+    size_t limb_idx = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (acc_bits < 7) {
+            di_limb_t limb = 0;
+            if (limb_idx < big->limb_count) {
+                di_limb_t src = big->limbs[limb_idx++];
+                limb = (di_limb_t)(src - borrow);
+                borrow = (borrow && src == 0) ? 1 : 0;
+            }
+            acc |= (di_dlimb_t)limb << acc_bits;
+            acc_bits += DI_LIMB_BITS;
+        }
+        uint8_t byte = (uint8_t)(acc & 0x7F);
+        acc >>= 7;
+        acc_bits -= 7;
+        buf[i] = (i + 1 < n) ? (uint8_t)(byte | 0x80) : byte;
+    }
+
+    return n;
+}
+
+DI_IMPL size_t di_encode_varint(di_int big, uint8_t* buf, size_t cap) {
+    DI_ASSERT(big && "di_encode_varint: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_EXPORT, big->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_EXPORT, big->limb_count, 0);
+    size_t result = di_encode_varint_internal(big, buf, cap);
+    DI_TRACE_END();
     return result;
 }
 
-DI_IMPL di_int di_xor(di_int a, di_int b) {
-    DI_ASSERT(a && "di_xor: first operand cannot be NULL");
-    DI_ASSERT(b && "di_xor: second operand cannot be NULL");
-    
-    size_t max_limbs = (a->limb_count > b->limb_count) ? a->limb_count : b->limb_count;
-    struct di_int_internal* result = di_alloc(max_limbs);
-    DI_ASSERT(result && "allocation failed");
-    
-    // XOR operation on limbs
-    for (size_t i = 0; i < max_limbs; i++) {
-        di_limb_t a_limb = (i < a->limb_count) ? a->limbs[i] : 0;
-        di_limb_t b_limb = (i < b->limb_count) ? b->limbs[i] : 0;
-        result->limbs[i] = a_limb ^ b_limb;
+static di_int di_decode_varint_internal(const uint8_t* buf, size_t len, size_t* consumed) {
+    size_t n = 0;
+    while (n < len && (buf[n] & 0x80)) n++;
+    if (n == len) return NULL; // Truncated
+    n++;
+    if (consumed) *consumed = n;
+
+    // Fast path: at most 63 payload bits always fit in an int64
+    if (n <= 9) {
+        uint64_t z = 0;
+        for (size_t i = 0; i < n; i++) {
+            z |= (uint64_t)(buf[i] & 0x7F) << (7 * i);
+        }
+        int64_t magnitude = (int64_t)(z >> 1);
+        return di_from_int64((z & 1) ? -magnitude - 1 : magnitude);
+    }
+
+    // Gather the 7-bit groups into limbs
+    size_t limbs_needed = (7 * n + DI_LIMB_BITS - 1) / DI_LIMB_BITS;
+    struct di_int_internal* result = di_alloc(limbs_needed);
+
+    di_dlimb_t acc = 0;
+    size_t acc_bits = 0;
+    size_t limb_idx = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc |= (di_dlimb_t)(buf[i] & 0x7F) << acc_bits;
+        acc_bits += 7;
+        if (acc_bits >= DI_LIMB_BITS) {
+            result->limbs[limb_idx++] = (di_limb_t)acc;
+            acc >>= DI_LIMB_BITS;
+            acc_bits -= DI_LIMB_BITS;
+        }
+    }
+    if (acc_bits > 0) {
+        result->limbs[limb_idx++] = (di_limb_t)acc;
+    }
+    result->limb_count = limb_idx;
+
+    // Undo the zigzag: drop the sign bit, then add one back for negatives
+    bool negative = (result->limbs[0] & 1) != 0;
+    for (size_t i = 0; i < result->limb_count; i++) {
+        di_limb_t next = (i + 1 < result->limb_count) ? result->limbs[i + 1] : 0;
+        result->limbs[i] = (di_limb_t)((result->limbs[i] >> 1) | (next << (DI_LIMB_BITS - 1)));
     }
-    result->limb_count = max_limbs;
-    
-    // Result is positive (bitwise operations on magnitudes)
-    result->is_negative = false;
     di_normalize(result);
-    
+
+    if (negative) {
+        di_magnitude_increment(result);
+        result->is_negative = true;
+    }
+
+    return result;
+}
+
+DI_IMPL di_int di_decode_varint(const uint8_t* buf, size_t len, size_t* consumed) {
+    DI_ASSERT((buf || len == 0) && "di_decode_varint: buffer cannot be NULL");
+    DI_TRACE_BEGIN(DI_STATS_IMPORT, len, 0);
+    di_int result = di_decode_varint_internal(buf, len, consumed);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_IMPORT, result ? result->limb_count : 0);
     return result;
 }
 
-DI_IMPL di_int di_not(di_int a) {
-    DI_ASSERT(a && "di_not: operand cannot be NULL");
-    
-    // For simplicity, NOT operation on fixed width (one limb beyond significant bits)
-    size_t result_limbs = a->limb_count + 1;
-    struct di_int_internal* result = di_alloc(result_limbs);
-    DI_ASSERT(result && "di_not: allocation failed");
-    
-    // NOT operation on limbs
-    for (size_t i = 0; i < a->limb_count; i++) {
-        result->limbs[i] = ~a->limbs[i];
+DI_IMPL size_t di_varint_batch_size(const di_int* values, size_t count) {
+    DI_ASSERT((values || count == 0) && "di_varint_batch_size: values cannot be NULL");
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += di_varint_size(values[i]);
     }
-    result->limbs[a->limb_count] = ~((di_limb_t)0); // Set high limb to all 1s
-    result->limb_count = result_limbs;
-    
-    // Result is positive (bitwise operations on magnitudes)
-    result->is_negative = false;
-    di_normalize(result);
-    
-    return result;
+    return total;
 }
 
-DI_IMPL di_int di_shift_left(di_int a, size_t bits) {
-    DI_ASSERT(a && "di_shift_left: operand cannot be NULL");
-    if (bits == 0) return di_copy(a);
-    
-    size_t limb_shift = bits / DI_LIMB_BITS;
-    size_t bit_shift = bits % DI_LIMB_BITS;
-    
-    size_t new_limb_count = a->limb_count + limb_shift + (bit_shift > 0 ? 1 : 0);
-    struct di_int_internal* result = di_alloc(new_limb_count);
-    DI_ASSERT(result && "allocation failed");
-    
-    // Clear the result limbs
-    for (size_t i = 0; i < new_limb_count; i++) {
-        result->limbs[i] = 0;
+DI_IMPL size_t di_encode_varint_batch(const di_int* values, size_t count, uint8_t* buf, size_t cap) {
+    DI_ASSERT((values || count == 0) && "di_encode_varint_batch: values cannot be NULL");
+
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t written = di_encode_varint(values[i], buf + pos, cap - pos);
+        if (written == 0) return 0;
+        pos += written;
     }
-    
-    // Copy and shift limbs
-    if (bit_shift == 0) {
-        // Simple limb shift
-        for (size_t i = 0; i < a->limb_count; i++) {
-            result->limbs[i + limb_shift] = a->limbs[i];
-        }
-    } else {
-        // Bit shift within limbs
-        di_limb_t carry = 0;
-        for (size_t i = 0; i < a->limb_count; i++) {
-            di_limb_t shifted = (a->limbs[i] << bit_shift) | carry;
-            carry = a->limbs[i] >> (DI_LIMB_BITS - bit_shift);
-            result->limbs[i + limb_shift] = shifted;
+    return pos;
+}
+
+DI_IMPL size_t di_decode_varint_batch(const uint8_t* buf, size_t len, di_int* out, size_t count) {
+    DI_ASSERT((out || count == 0) && "di_decode_varint_batch: output array cannot be NULL");
+
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t used = 0;
+        out[i] = di_decode_varint(buf + pos, len - pos, &used);
+        if (!out[i]) {
+            for (size_t j = 0; j < count; j++) {
+                if (j < i) di_release(&out[j]);
+                else out[j] = NULL;
+            }
+            return 0;
         }
-        if (carry > 0) {
-            result->limbs[a->limb_count + limb_shift] = carry;
+        pos += used;
+    }
+    return pos;
+}
+
+/* CBOR and DER codecs */
+
+// Write the low 'count' bytes of |big| - minus_one big-endian, optionally complemented
+static void di_write_be_bytes(di_int big, bool minus_one, bool invert, uint8_t* dst, size_t count) {
+    di_limb_t borrow = minus_one ? 1 : 0;
+    di_limb_t limb = 0;
+    size_t limb_idx = 0;
+
+    for (size_t k = 0; k < count; k++) {
+        size_t shift = k % sizeof(di_limb_t);
+        if (shift == 0) {
+            di_limb_t src = (limb_idx < big->limb_count) ? big->limbs[limb_idx] : 0;
+            limb_idx++;
+            limb = (di_limb_t)(src - borrow);
+            borrow = (borrow && src == 0) ? 1 : 0;
         }
+        uint8_t byte = (uint8_t)(limb >> (8 * shift));
+        dst[count - 1 - k] = invert ? (uint8_t)~byte : byte;
     }
-    
-    result->limb_count = new_limb_count;
-    result->is_negative = a->is_negative;
+}
+
+// Build a non-negative integer from big-endian bytes, optionally complemented
+static struct di_int_internal* di_read_be_bytes(const uint8_t* src, size_t count, bool invert) {
+    size_t limbs_needed = (count + sizeof(di_limb_t) - 1) / sizeof(di_limb_t);
+    struct di_int_internal* result = di_alloc(limbs_needed > 0 ? limbs_needed : 1);
+
+    for (size_t k = 0; k < count; k++) {
+        uint8_t byte = src[count - 1 - k];
+        if (invert) byte = (uint8_t)~byte;
+        result->limbs[k / sizeof(di_limb_t)] |= (di_limb_t)byte << (8 * (k % sizeof(di_limb_t)));
+    }
+    result->limb_count = limbs_needed;
     di_normalize(result);
-    
     return result;
 }
 
-DI_IMPL di_int di_shift_right(di_int a, size_t bits) {
-    DI_ASSERT(a && "di_shift_right: operand cannot be NULL");
-    if (bits == 0) return di_copy(a);
-    
-    size_t limb_shift = bits / DI_LIMB_BITS;
-    size_t bit_shift = bits % DI_LIMB_BITS;
-    
-    // If shifting more limbs than we have, result is zero
-    if (limb_shift >= a->limb_count) {
-        return di_zero();
+// Low 64 bits of the magnitude
+static uint64_t di_magnitude_low64(di_int big) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < big->limb_count && i * DI_LIMB_BITS < 64; i++) {
+        value |= (uint64_t)big->limbs[i] << (i * DI_LIMB_BITS);
     }
-    
-    size_t new_limb_count = a->limb_count - limb_shift;
-    struct di_int_internal* result = di_alloc(new_limb_count);
-    DI_ASSERT(result && "allocation failed");
-    
-    if (bit_shift == 0) {
-        // Simple limb shift
-        for (size_t i = 0; i < new_limb_count; i++) {
-            result->limbs[i] = a->limbs[i + limb_shift];
-        }
-    } else {
-        // Bit shift within limbs
-        for (size_t i = 0; i < new_limb_count; i++) {
-            di_limb_t current = a->limbs[i + limb_shift];
-            di_limb_t next = (i + limb_shift + 1 < a->limb_count) ? 
-                            a->limbs[i + limb_shift + 1] : 0;
-            result->limbs[i] = (current >> bit_shift) | 
-                              (next << (DI_LIMB_BITS - bit_shift));
+    return value;
+}
+
+// Size of a CBOR head, writing it when out is not NULL
+static size_t di_cbor_head(uint8_t major, uint64_t value, uint8_t* out) {
+    size_t extra = value < 24 ? 0 : value <= 0xFF ? 1 : value <= 0xFFFF ? 2 : value <= 0xFFFFFFFFu ? 4 : 8;
+    if (out) {
+        uint8_t info = extra == 0 ? (uint8_t)value : extra == 1 ? 24 : extra == 2 ? 25 : extra == 4 ? 26 : 27;
+        out[0] = (uint8_t)((major << 5) | info);
+        for (size_t i = 0; i < extra; i++) {
+            out[extra - i] = (uint8_t)(value >> (8 * i));
         }
     }
-    
-    result->limb_count = new_limb_count;
-    result->is_negative = a->is_negative;
-    di_normalize(result);
-    
-    return result;
+    return 1 + extra;
 }
 
-// GCD using Euclidean algorithm
-DI_IMPL di_int di_gcd(di_int a, di_int b) {
-    DI_ASSERT(a && "di_gcd: first operand cannot be NULL");
-    DI_ASSERT(b && "di_gcd: second operand cannot be NULL");
-    
-    di_int abs_a = di_abs(a);
-    di_int abs_b = di_abs(b);
-    
-    if (di_is_zero(abs_a)) {
-        di_release(&abs_a);
-        return abs_b;
+// Parse a CBOR head, returning its size or 0 if malformed/truncated
+static size_t di_cbor_read_head(const uint8_t* buf, size_t len, uint8_t* major, uint64_t* value) {
+    if (len == 0) return 0;
+    uint8_t info = buf[0] & 0x1F;
+    size_t extra = info < 24 ? 0 : info == 24 ? 1 : info == 25 ? 2 : info == 26 ? 4 : info == 27 ? 8 : SIZE_MAX;
+    if (extra == SIZE_MAX || len - 1 < extra) return 0;
+
+    *major = buf[0] >> 5;
+    *value = extra == 0 ? info : 0;
+    for (size_t i = 0; i < extra; i++) {
+        *value = (*value << 8) | buf[1 + i];
     }
-    if (di_is_zero(abs_b)) {
-        di_release(&abs_b);
-        return abs_a;
+    return 1 + extra;
+}
+
+DI_IMPL size_t di_cbor_size(di_int big) {
+    DI_ASSERT(big && "di_cbor_size: operand cannot be NULL");
+
+    // Negative values are stored as -1 - n
+    size_t bits = big->is_negative ? di_bit_length_minus_one(big) : di_bit_length(big);
+    if (bits <= 64) {
+        uint64_t n = di_magnitude_low64(big) - (big->is_negative ? 1 : 0);
+        return di_cbor_head(0, n, NULL);
     }
-    
-    // Euclidean algorithm: gcd(a,b) = gcd(b, a mod b)
-    while (!di_is_zero(abs_b)) {
-        di_int remainder = di_mod(abs_a, abs_b);
-        if (!remainder) {
-            di_release(&abs_a);
-            di_release(&abs_b);
-            return NULL;
-        }
-        
-        di_release(&abs_a);
-        abs_a = abs_b;
-        abs_b = remainder;
+
+    size_t bytes = (bits + 7) / 8;
+    return 1 + di_cbor_head(2, bytes, NULL) + bytes;
+}
+
+static size_t di_encode_cbor_internal(di_int big, uint8_t* buf, size_t cap) {
+    size_t n = di_cbor_size(big);
+    if (cap < n) return 0;
+    DI_ASSERT(buf && "di_encode_cbor: buffer cannot be NULL");
+
+    size_t bits = big->is_negative ? di_bit_length_minus_one(big) : di_bit_length(big);
+    if (bits <= 64) {
+        uint64_t value = di_magnitude_low64(big) - (big->is_negative ? 1 : 0);
+        di_cbor_head(big->is_negative ? 1 : 0, value, buf);
+        return n;
     }
-    
-    di_release(&abs_b);
-    return abs_a;
+
+    // Tag 2/3 followed by a byte string of the (possibly decremented) magnitude
+    size_t bytes = (bits + 7) / 8;
+    buf[0] = big->is_negative ? 0xC3 : 0xC2;
+    size_t pos = 1 + di_cbor_head(2, bytes, buf + 1);
+    di_write_be_bytes(big, big->is_negative, false, buf + pos, bytes);
+    return n;
 }
 
-// LCM using the identity: lcm(a,b) = |a*b| / gcd(a,b)
-DI_IMPL di_int di_lcm(di_int a, di_int b) {
-    DI_ASSERT(a && "di_lcm: first operand cannot be NULL");
-    DI_ASSERT(b && "di_lcm: second operand cannot be NULL");
-    if (di_is_zero(a) || di_is_zero(b)) return di_zero();
-    
-    di_int gcd = di_gcd(a, b);
-    DI_ASSERT(gcd && "di_lcm: gcd allocation failed");
-    
-    di_int product = di_mul(a, b);
-    if (!product) {
-        di_release(&gcd);
+DI_IMPL size_t di_encode_cbor(di_int big, uint8_t* buf, size_t cap) {
+    DI_ASSERT(big && "di_encode_cbor: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_EXPORT, big->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_EXPORT, big->limb_count, 0);
+    size_t result = di_encode_cbor_internal(big, buf, cap);
+    DI_TRACE_END();
+    return result;
+}
+
+static di_int di_decode_cbor_internal(const uint8_t* buf, size_t len, size_t* consumed) {
+    uint8_t major;
+    uint64_t value;
+    size_t pos = di_cbor_read_head(buf, len, &major, &value);
+    if (pos == 0) return NULL;
+
+    struct di_int_internal* result;
+    if (major == 0 || major == 1) {
+        result = di_from_uint64(value);
+    } else if (major == 6 && (value == 2 || value == 3)) {
+        bool negative = value == 3;
+        uint8_t str_major;
+        uint64_t str_len;
+        size_t head = di_cbor_read_head(buf + pos, len - pos, &str_major, &str_len);
+        if (head == 0 || str_major != 2) return NULL;
+        pos += head;
+        if (str_len > len - pos) return NULL;
+
+        result = di_read_be_bytes(buf + pos, (size_t)str_len, false);
+        pos += (size_t)str_len;
+        major = negative ? 1 : 0;
+    } else {
         return NULL;
     }
-    
-    di_int abs_product = di_abs(product);
-    di_release(&product);
-    if (!abs_product) {
-        di_release(&gcd);
-        return NULL;
+
+    // Major type 1 and tag 3 both encode -1 - n
+    if (major == 1) {
+        di_magnitude_increment(result);
+        result->is_negative = true;
     }
-    
-    di_int result = di_div(abs_product, gcd);
-    di_release(&abs_product);
-    di_release(&gcd);
-    
+
+    if (consumed) *consumed = pos;
     return result;
 }
 
-// Simple integer square root using Newton's method
-DI_IMPL di_int di_sqrt(di_int n) {
-    DI_ASSERT(n && "di_sqrt: operand cannot be NULL");
-    DI_ASSERT(!di_is_negative(n) && "di_sqrt: square root of negative number");
-    if (di_is_zero(n)) return di_zero();
-    
-    di_int one = di_one();
-    if (di_eq(n, one)) {
-        di_release(&one);
-        return di_one();
-    }
-    
-    // Initial guess: x = n / 2
-    di_int two = di_from_int32(2);
-    di_int x = di_div(n, two);
-    if (!x) {
-        di_release(&one);
-        di_release(&two);
-        return NULL;
-    }
-    
-    // Newton's method: x_new = (x + n/x) / 2
-    for (int iterations = 0; iterations < 100; iterations++) { // Limit iterations
-        di_int quotient = di_div(n, x);
-        if (!quotient) break;
-        
-        di_int sum = di_add(x, quotient);
-        di_release(&quotient);
-        if (!sum) break;
-        
-        di_int x_new = di_div(sum, two);
-        di_release(&sum);
-        if (!x_new) break;
-        
-        // Check for convergence
-        if (di_ge(x_new, x)) {
-            di_release(&x_new);
-            break;
-        }
-        
-        di_release(&x);
-        x = x_new;
+DI_IMPL di_int di_decode_cbor(const uint8_t* buf, size_t len, size_t* consumed) {
+    DI_ASSERT((buf || len == 0) && "di_decode_cbor: buffer cannot be NULL");
+    DI_TRACE_BEGIN(DI_STATS_IMPORT, len, 0);
+    di_int result = di_decode_cbor_internal(buf, len, consumed);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_IMPORT, result ? result->limb_count : 0);
+    return result;
+}
+
+DI_IMPL size_t di_der_size(di_int big) {
+    DI_ASSERT(big && "di_der_size: operand cannot be NULL");
+
+    // Minimal two's complement always leaves room for the sign bit
+    size_t bits = big->is_negative ? di_bit_length_minus_one(big) : di_bit_length(big);
+    size_t content = bits / 8 + 1;
+
+    size_t length_bytes = 1;
+    if (content >= 0x80) {
+        for (size_t c = content; c > 0; c >>= 8) length_bytes++;
     }
-    
-    di_release(&one);
-    di_release(&two);
-    return x;
+    return 1 + length_bytes + content;
 }
 
-// Factorial function
-DI_IMPL di_int di_factorial(uint32_t n) {
-    if (n <= 1) return di_one();
-    
-    di_int result = di_one();
-    DI_ASSERT(result && "di_factorial: allocation failed");
-    
-    for (uint32_t i = 2; i <= n; i++) {
-        di_int i_big = di_from_uint32(i);
-        if (!i_big) {
-            di_release(&result);
-            return NULL;
-        }
-        
-        di_int new_result = di_mul(result, i_big);
-        di_release(&i_big);
-        di_release(&result);
+static size_t di_encode_der_internal(di_int big, uint8_t* buf, size_t cap) {
+    size_t n = di_der_size(big);
+    if (cap < n) return 0;
+    DI_ASSERT(buf && "di_encode_der: buffer cannot be NULL");
 
-        DI_ASSERT(new_result && "di_factorial: allocation failed");
-        result = new_result;
+    size_t bits = big->is_negative ? di_bit_length_minus_one(big) : di_bit_length(big);
+    size_t content = bits / 8 + 1;
+    size_t length_bytes = n - 1 - content;
+
+    buf[0] = 0x02;
+    if (length_bytes == 1) {
+        buf[1] = (uint8_t)content;
+    } else {
+        buf[1] = (uint8_t)(0x80 | (length_bytes - 1));
+        for (size_t i = 0; i < length_bytes - 1; i++) {
+            buf[length_bytes - i] = (uint8_t)(content >> (8 * i));
+        }
     }
-    
+
+    // Two's complement of -m is ~(m - 1)
+    di_write_be_bytes(big, big->is_negative, big->is_negative, buf + 1 + length_bytes, content);
+    return n;
+}
+
+DI_IMPL size_t di_encode_der(di_int big, uint8_t* buf, size_t cap) {
+    DI_ASSERT(big && "di_encode_der: operand cannot be NULL");
+    DI_STATS_OP(DI_STATS_EXPORT, big->limb_count);
+    DI_TRACE_BEGIN(DI_STATS_EXPORT, big->limb_count, 0);
+    size_t result = di_encode_der_internal(big, buf, cap);
+    DI_TRACE_END();
     return result;
 }
 
-// Modular exponentiation: (base^exp) mod mod
-// Uses binary exponentiation for efficiency
-DI_IMPL di_int di_mod_pow(di_int base, di_int exp, di_int mod) {
-    DI_ASSERT(base && "di_mod_pow: base cannot be NULL");
-    DI_ASSERT(exp && "di_mod_pow: exponent cannot be NULL");
-    DI_ASSERT(mod && "di_mod_pow: modulus cannot be NULL");
-    DI_ASSERT(!di_is_zero(mod) && "di_mod_pow: modulus cannot be zero");
-    if (di_eq(mod, di_one())) return di_zero(); // x mod 1 = 0
-    
-    if (di_is_zero(exp)) return di_one(); // base^0 = 1
-    if (di_is_zero(base)) return di_zero(); // 0^exp = 0
-    
-    di_int result = di_one();
-    di_int base_mod = di_mod(base, mod); // Reduce base first
-    di_int exp_copy = di_copy(exp);
-    
-    if (!result || !base_mod || !exp_copy) {
-        di_release(&result);
-        di_release(&base_mod);
-        di_release(&exp_copy);
-        return NULL;
-    }
-    
-    // Binary exponentiation
-    while (!di_is_zero(exp_copy)) {
-        // If exp is odd, multiply result by base_mod
-        di_int remainder = di_mod(exp_copy, di_from_int32(2));
-        if (remainder && !di_is_zero(remainder)) {
-            di_int temp = di_mul(result, base_mod);
-            if (temp) {
-                di_int new_result = di_mod(temp, mod);
-                di_release(&temp);
-                di_release(&result);
-                result = new_result;
-            }
-        }
-        di_release(&remainder);
-        
-        // Square base_mod and divide exp by 2
-        di_int base_squared = di_mul(base_mod, base_mod);
-        if (base_squared) {
-            di_int new_base = di_mod(base_squared, mod);
-            di_release(&base_squared);
-            di_release(&base_mod);
-            base_mod = new_base;
+static di_int di_decode_der_internal(const uint8_t* buf, size_t len, size_t* consumed) {
+    if (len < 3 || buf[0] != 0x02) return NULL;
+
+    size_t pos = 2;
+    size_t content = buf[1];
+    if (content & 0x80) {
+        // Long form: reject indefinite, oversized and non-minimal lengths
+        size_t length_bytes = content & 0x7F;
+        if (length_bytes == 0 || length_bytes > sizeof(size_t) || len - pos < length_bytes) return NULL;
+        if (buf[pos] == 0) return NULL;
+        content = 0;
+        for (size_t i = 0; i < length_bytes; i++) {
+            content = (content << 8) | buf[pos++];
         }
-        
-        di_int two = di_from_int32(2);
-        di_int new_exp = di_div(exp_copy, two);
-        di_release(&two);
-        di_release(&exp_copy);
-        exp_copy = new_exp;
-        
-        if (!result || !base_mod || !exp_copy) break;
+        if (content < 0x80) return NULL;
+    }
+    if (content == 0 || content > len - pos) return NULL;
+
+    const uint8_t* bytes = buf + pos;
+    if (content > 1 && ((bytes[0] == 0x00 && !(bytes[1] & 0x80)) ||
+                        (bytes[0] == 0xFF && (bytes[1] & 0x80)))) {
+        return NULL; // Redundant sign byte
     }
-    
-    di_release(&base_mod);
-    di_release(&exp_copy);
-    
+
+    bool negative = (bytes[0] & 0x80) != 0;
+    struct di_int_internal* result = di_read_be_bytes(bytes, content, negative);
+    if (negative) {
+        di_magnitude_increment(result);
+        result->is_negative = true;
+    }
+
+    if (consumed) *consumed = pos + content;
     return result;
 }
 
-// Simple primality test using trial division
-DI_IMPL bool di_is_prime(di_int n, int certainty) {
-    (void)certainty; // Unused in this simple implementation
+DI_IMPL di_int di_decode_der(const uint8_t* buf, size_t len, size_t* consumed) {
+    DI_ASSERT((buf || len == 0) && "di_decode_der: buffer cannot be NULL");
+    DI_TRACE_BEGIN(DI_STATS_IMPORT, len, 0);
+    di_int result = di_decode_der_internal(buf, len, consumed);
+    DI_TRACE_END();
+    DI_STATS_OP(DI_STATS_IMPORT, result ? result->limb_count : 0);
+    return result;
+}
 
-    DI_ASSERT(n && "di_is_prime: operand cannot be NULL");
-    if (di_is_negative(n)) return false;
-    
-    // Handle small cases
-    di_int two = di_from_int32(2);
-    di_int three = di_from_int32(3);
-    
-    if (di_lt(n, two)) {
-        di_release(&two);
-        di_release(&three);
-        return false;
+/* Structure-of-arrays vectors */
+
+// Values are stored in blocks of DI_VEC_LANES lanes, in two's complement
+// sign-extended to the block's width, with limb j of lane l at
+// offsets[block] + j * DI_VEC_LANES + l. Kernels walk a block one limb row
+// at a time and run the same branch-free arithmetic in every lane, which
+// compilers turn into SIMD code. A block is as wide as its widest value,
+// so one huge value only pads its own block.
+
+struct di_vec_internal {
+    size_t count;            // Number of values
+    size_t blocks;           // Number of DI_VEC_LANES-lane blocks
+    di_limb_t* limbs;        // All blocks back to back
+    size_t offsets[];        // blocks + 1 limb offsets into limbs
+};
+
+static struct di_vec_internal* di_vec_alloc(size_t count) {
+    size_t blocks = (count + DI_VEC_LANES - 1) / DI_VEC_LANES;
+    struct di_vec_internal* vec = (struct di_vec_internal*)DI_MALLOC(
+        sizeof(struct di_vec_internal) + sizeof(size_t) * (blocks + 1));
+    DI_ASSERT(vec && "di_vec_alloc: allocation failed");
+    vec->count = count;
+    vec->blocks = blocks;
+    vec->limbs = NULL;
+    vec->offsets[0] = 0;
+    return vec;
+}
+
+static void di_vec_alloc_limbs(struct di_vec_internal* vec, size_t limb_count) {
+    if (limb_count == 0) return;
+    vec->limbs = (di_limb_t*)DI_MALLOC(sizeof(di_limb_t) * limb_count);
+    DI_ASSERT(vec->limbs && "di_vec_alloc: limb allocation failed");
+}
+
+static size_t di_vec_width(const struct di_vec_internal* vec, size_t block) {
+    return (vec->offsets[block + 1] - vec->offsets[block]) / DI_VEC_LANES;
+}
+
+// Sign extension limb (0 or all ones) of every lane of a block
+static void di_vec_signs(di_limb_t* ext, const di_limb_t* block, size_t width) {
+    const di_limb_t* top = block + (width - 1) * DI_VEC_LANES;
+    for (size_t l = 0; l < DI_VEC_LANES; l++) {
+        ext[l] = (di_limb_t)(0 - (di_limb_t)(top[l] >> (DI_LIMB_BITS - 1)));
     }
-    if (di_eq(n, two) || di_eq(n, three)) {
-        di_release(&two);
-        di_release(&three);
-        return true;
+}
+
+// Row j of a block, or its sign extension past the block's width
+static const di_limb_t* di_vec_row(const di_limb_t* block, size_t width, const di_limb_t* ext, size_t j) {
+    return j < width ? block + j * DI_VEC_LANES : ext;
+}
+
+// Drop top rows that only repeat the sign of the row below in every lane
+static size_t di_vec_trim(const di_limb_t* block, size_t width) {
+    while (width > 1) {
+        const di_limb_t* top = block + (width - 1) * DI_VEC_LANES;
+        const di_limb_t* below = top - DI_VEC_LANES;
+        di_limb_t diff = 0;
+        for (size_t l = 0; l < DI_VEC_LANES; l++) {
+            diff |= top[l] ^ (di_limb_t)(0 - (di_limb_t)(below[l] >> (DI_LIMB_BITS - 1)));
+        }
+        if (diff) break;
+        width--;
     }
-    
-    // Check if even
-    di_int remainder = di_mod(n, two);
-    if (di_is_zero(remainder)) {
-        di_release(&remainder);
-        di_release(&two);
-        di_release(&three);
-        return false;
+    return width;
+}
+
+// r = a + b, or a - b computed as a + ~b + 1; wr must exceed both widths
+static void di_vec_add_block(di_limb_t* r, size_t wr, const di_limb_t* a, size_t wa,
+                             const di_limb_t* b, size_t wb, bool subtract) {
+    di_limb_t ea[DI_VEC_LANES], eb[DI_VEC_LANES], carry[DI_VEC_LANES];
+    di_vec_signs(ea, a, wa);
+    di_vec_signs(eb, b, wb);
+    di_limb_t flip = subtract ? DI_LIMB_MAX : 0;
+    for (size_t l = 0; l < DI_VEC_LANES; l++) carry[l] = subtract ? 1 : 0;
+
+    for (size_t j = 0; j < wr; j++) {
+        const di_limb_t* x = di_vec_row(a, wa, ea, j);
+        const di_limb_t* y = di_vec_row(b, wb, eb, j);
+        di_limb_t* out = r + j * DI_VEC_LANES;
+        for (size_t l = 0; l < DI_VEC_LANES; l++) {
+            di_dlimb_t sum = (di_dlimb_t)x[l] + (di_limb_t)(y[l] ^ flip) + carry[l];
+            out[l] = (di_limb_t)sum;
+            carry[l] = (di_limb_t)(sum >> DI_LIMB_BITS);
+        }
     }
-    di_release(&remainder);
-    
-    // Check odd divisors up to sqrt(n)
-    di_int sqrt_n = di_sqrt(n);
-    di_int i = di_copy(three);
-    
-    while (di_le(i, sqrt_n)) {
-        di_int remainder = di_mod(n, i);
-        if (di_is_zero(remainder)) {
-            di_release(&remainder);
-            di_release(&two);
-            di_release(&three);
-            di_release(&sqrt_n);
-            di_release(&i);
-            return false; // Found a divisor
+}
+
+// r = a * m for an unsigned 32-bit m; wr must leave room for the product
+static void di_vec_mul_block(di_limb_t* r, size_t wr, const di_limb_t* a, size_t wa, uint32_t m) {
+    di_limb_t ea[DI_VEC_LANES], carry[DI_VEC_LANES];
+    di_vec_signs(ea, a, wa);
+    memset(r, 0, sizeof(di_limb_t) * wr * DI_VEC_LANES);
+
+    // One pass per limb of m (two with 16-bit limbs)
+    for (size_t k = 0; k * DI_LIMB_BITS < 32 && k < wr; k++) {
+        di_limb_t mk = (di_limb_t)(m >> (k * DI_LIMB_BITS));
+        for (size_t l = 0; l < DI_VEC_LANES; l++) carry[l] = 0;
+        for (size_t j = 0; j + k < wr; j++) {
+            const di_limb_t* x = di_vec_row(a, wa, ea, j);
+            di_limb_t* out = r + (j + k) * DI_VEC_LANES;
+            for (size_t l = 0; l < DI_VEC_LANES; l++) {
+                di_dlimb_t t = (di_dlimb_t)x[l] * mk + out[l] + carry[l];
+                out[l] = (di_limb_t)t;
+                carry[l] = (di_limb_t)(t >> DI_LIMB_BITS);
+            }
         }
-        di_release(&remainder);
-        
-        // i += 2 (check only odd numbers)
-        di_int new_i = di_add(i, two);
-        di_release(&i);
-        i = new_i;
-        
-        if (!i) break;
     }
-    
-    di_release(&two);
-    di_release(&three);
-    di_release(&sqrt_n);
-    di_release(&i);
-    
-    return true;
 }
 
-// Find next prime number >= n
-DI_IMPL di_int di_next_prime(di_int n) {
-    DI_ASSERT(n && "di_next_prime: operand cannot be NULL");
-    
-    di_int candidate = di_copy(n);
-    DI_ASSERT(candidate && "di_next_prime: allocation failed");
-    
-    // If n is even, make it odd
-    di_int two = di_from_int32(2);
-    di_int remainder = di_mod(candidate, two);
-    if (di_is_zero(remainder)) {
-        di_int new_candidate = di_add(candidate, di_one());
-        di_release(&candidate);
-        candidate = new_candidate;
+static void di_vec_negate_block(di_limb_t* r, size_t wr) {
+    di_limb_t carry[DI_VEC_LANES];
+    for (size_t l = 0; l < DI_VEC_LANES; l++) carry[l] = 1;
+    for (size_t j = 0; j < wr; j++) {
+        di_limb_t* out = r + j * DI_VEC_LANES;
+        for (size_t l = 0; l < DI_VEC_LANES; l++) {
+            di_dlimb_t t = (di_dlimb_t)(di_limb_t)~out[l] + carry[l];
+            out[l] = (di_limb_t)t;
+            carry[l] = (di_limb_t)(t >> DI_LIMB_BITS);
+        }
     }
-    di_release(&remainder);
-    
-    // Check odd numbers until we find a prime
-    while (candidate && !di_is_prime(candidate, 10)) {
-        di_int new_candidate = di_add(candidate, two);
-        di_release(&candidate);
-        candidate = new_candidate;
+}
+
+// Sign and zero test of a - b without storing the difference
+static void di_vec_cmp_block(int* out, size_t lanes, const di_limb_t* a, size_t wa,
+                             const di_limb_t* b, size_t wb) {
+    di_limb_t ea[DI_VEC_LANES], eb[DI_VEC_LANES];
+    di_limb_t carry[DI_VEC_LANES], nonzero[DI_VEC_LANES], top[DI_VEC_LANES];
+    di_vec_signs(ea, a, wa);
+    di_vec_signs(eb, b, wb);
+    for (size_t l = 0; l < DI_VEC_LANES; l++) {
+        carry[l] = 1;
+        nonzero[l] = 0;
+    }
+
+    size_t w = (wa > wb ? wa : wb) + 1;
+    for (size_t j = 0; j < w; j++) {
+        const di_limb_t* x = di_vec_row(a, wa, ea, j);
+        const di_limb_t* y = di_vec_row(b, wb, eb, j);
+        for (size_t l = 0; l < DI_VEC_LANES; l++) {
+            di_dlimb_t sum = (di_dlimb_t)x[l] + (di_limb_t)~y[l] + carry[l];
+            top[l] = (di_limb_t)sum;
+            nonzero[l] |= top[l];
+            carry[l] = (di_limb_t)(sum >> DI_LIMB_BITS);
+        }
+    }
+    for (size_t l = 0; l < lanes; l++) {
+        out[l] = (top[l] >> (DI_LIMB_BITS - 1)) ? -1 : (nonzero[l] != 0);
     }
-    
-    di_release(&two);
-    return candidate;
 }
 
-// Simple random number generator (NOT cryptographically secure)
-// This is a placeholder implementation - real applications should use
-// a proper CSPRNG like /dev/urandom or Windows CryptoAPI
-DI_IMPL di_int di_random(size_t bits) {
-    if (bits == 0) return di_zero();
-    
-    size_t limbs_needed = (bits + DI_LIMB_BITS - 1) / DI_LIMB_BITS;
-    struct di_int_internal* result = di_alloc(limbs_needed);
-    DI_ASSERT(result && "di_random: allocation failed");
-    
-    // Use simple rand() - NOT suitable for cryptographic use
-    for (size_t i = 0; i < limbs_needed; i++) {
-        result->limbs[i] = 0;
-        for (int j = 0; j < (int)(sizeof(di_limb_t)); j++) {
-            result->limbs[i] |= ((di_limb_t)(rand() & 0xFF)) << (j * 8);
+DI_IMPL di_vec di_vec_from_ints(const di_int* values, size_t count) {
+    DI_ASSERT((values || count == 0) && "di_vec_from_ints: values cannot be NULL");
+    struct di_vec_internal* vec = di_vec_alloc(count);
+
+    // Each value needs its bit length plus a sign bit
+    for (size_t blk = 0; blk < vec->blocks; blk++) {
+        size_t width = 1;
+        for (size_t i = blk * DI_VEC_LANES; i < count && i < (blk + 1) * DI_VEC_LANES; i++) {
+            DI_ASSERT(values[i] && "di_vec_from_ints: values cannot contain NULL");
+            size_t w = di_view_bit_length(di_view_of(values[i])) / DI_LIMB_BITS + 1;
+            if (w > width) width = w;
         }
+        vec->offsets[blk + 1] = vec->offsets[blk] + width * DI_VEC_LANES;
     }
-    
-    // Mask the high bits to get exactly 'bits' bits
-    size_t high_bits = bits % DI_LIMB_BITS;
-    if (high_bits > 0) {
-        di_limb_t mask = (1UL << high_bits) - 1;
-        result->limbs[limbs_needed - 1] &= mask;
+    di_vec_alloc_limbs(vec, vec->offsets[vec->blocks]);
+
+    for (size_t blk = 0; blk < vec->blocks; blk++) {
+        di_limb_t* block = vec->limbs + vec->offsets[blk];
+        size_t width = di_vec_width(vec, blk);
+        for (size_t l = 0; l < DI_VEC_LANES; l++) {
+            size_t i = blk * DI_VEC_LANES + l;
+            di_view v = i < count ? di_view_of(values[i]) : di_view_from_limbs(NULL, 0, false);
+            di_limb_t flip = v.is_negative ? DI_LIMB_MAX : 0;
+            di_dlimb_t carry = v.is_negative ? 1 : 0;
+            for (size_t j = 0; j < width; j++) {
+                di_limb_t limb = j < v.limb_count ? v.limbs[j] : 0;
+                di_dlimb_t t = (di_dlimb_t)(di_limb_t)(limb ^ flip) + carry;
+                block[j * DI_VEC_LANES + l] = (di_limb_t)t;
+                carry = t >> DI_LIMB_BITS;
+            }
+        }
     }
-    
-    result->limb_count = limbs_needed;
-    result->is_negative = false;
+    return vec;
+}
+
+DI_IMPL size_t di_vec_count(di_vec vec) {
+    DI_ASSERT(vec && "di_vec_count: vector cannot be NULL");
+    return vec->count;
+}
+
+DI_IMPL di_int di_vec_get(di_vec vec, size_t index) {
+    DI_ASSERT(vec && "di_vec_get: vector cannot be NULL");
+    DI_ASSERT(index < vec->count && "di_vec_get: index out of range");
+
+    size_t blk = index / DI_VEC_LANES;
+    size_t width = di_vec_width(vec, blk);
+    const di_limb_t* lane = vec->limbs + vec->offsets[blk] + index % DI_VEC_LANES;
+    bool negative = (lane[(width - 1) * DI_VEC_LANES] >> (DI_LIMB_BITS - 1)) != 0;
+
+    // Negative lanes hold the two's complement of the magnitude
+    struct di_int_internal* result = di_alloc(width);
+    di_limb_t flip = negative ? DI_LIMB_MAX : 0;
+    di_dlimb_t carry = negative ? 1 : 0;
+    for (size_t j = 0; j < width; j++) {
+        di_dlimb_t t = (di_dlimb_t)(di_limb_t)(lane[j * DI_VEC_LANES] ^ flip) + carry;
+        result->limbs[j] = (di_limb_t)t;
+        carry = t >> DI_LIMB_BITS;
+    }
+    result->limb_count = width;
+    result->is_negative = negative;
     di_normalize(result);
-    
     return result;
 }
 
-// Random number in range [min, max)
-DI_IMPL di_int di_random_range(di_int min, di_int max) {
-    DI_ASSERT(min && "di_random_range: min cannot be NULL");
-    DI_ASSERT(max && "di_random_range: max cannot be NULL");
-    DI_ASSERT(di_lt(min, max) && "di_random_range: min must be less than max");
-    
-    di_int range = di_sub(max, min);
-    DI_ASSERT(range && "di_random_range: allocation failed");
-    
-    // Get bit length of range to generate appropriate random number
-    size_t range_bits = di_bit_length(range);
-    
-    // Generate random numbers until we get one in range
-    // (Rejection sampling to avoid bias)
-    for (int attempts = 0; attempts < 100; attempts++) {
-        di_int random = di_random(range_bits + 8); // Extra bits to reduce rejection
-        if (!random) continue;
-        
-        di_int mod_result = di_mod(random, range);
-        di_release(&random);
-        
-        if (mod_result) {
-            di_int result = di_add(min, mod_result);
-            di_release(&mod_result);
-            di_release(&range);
-            return result;
+static di_vec di_vec_add_sub(di_vec a, di_vec b, bool subtract) {
+    size_t bound = 0;
+    for (size_t blk = 0; blk < a->blocks; blk++) {
+        size_t wa = di_vec_width(a, blk), wb = di_vec_width(b, blk);
+        bound += ((wa > wb ? wa : wb) + 1) * DI_VEC_LANES;
+    }
+
+    // Blocks are written at their final position; trimming only frees space
+    struct di_vec_internal* result = di_vec_alloc(a->count);
+    di_vec_alloc_limbs(result, bound);
+    for (size_t blk = 0; blk < a->blocks; blk++) {
+        size_t wa = di_vec_width(a, blk), wb = di_vec_width(b, blk);
+        size_t wr = (wa > wb ? wa : wb) + 1;
+        di_limb_t* r = result->limbs + result->offsets[blk];
+        di_vec_add_block(r, wr, a->limbs + a->offsets[blk], wa, b->limbs + b->offsets[blk], wb, subtract);
+        result->offsets[blk + 1] = result->offsets[blk] + di_vec_trim(r, wr) * DI_VEC_LANES;
+    }
+    return result;
+}
+
+DI_IMPL di_vec di_vec_add(di_vec a, di_vec b) {
+    DI_ASSERT(a && b && "di_vec_add: vectors cannot be NULL");
+    DI_ASSERT(a->count == b->count && "di_vec_add: vectors must have the same length");
+    DI_STATS_OP(DI_STATS_VEC, a->offsets[a->blocks] + b->offsets[b->blocks]);
+    DI_TRACE_BEGIN(DI_STATS_VEC, a->offsets[a->blocks], b->offsets[b->blocks]);
+    di_vec result = di_vec_add_sub(a, b, false);
+    DI_TRACE_END();
+    return result;
+}
+
+DI_IMPL di_vec di_vec_sub(di_vec a, di_vec b) {
+    DI_ASSERT(a && b && "di_vec_sub: vectors cannot be NULL");
+    DI_ASSERT(a->count == b->count && "di_vec_sub: vectors must have the same length");
+    DI_STATS_OP(DI_STATS_VEC, a->offsets[a->blocks] + b->offsets[b->blocks]);
+    DI_TRACE_BEGIN(DI_STATS_VEC, a->offsets[a->blocks], b->offsets[b->blocks]);
+    di_vec result = di_vec_add_sub(a, b, true);
+    DI_TRACE_END();
+    return result;
+}
+
+DI_IMPL di_vec di_vec_mul_i32(di_vec a, int32_t scalar) {
+    DI_ASSERT(a && "di_vec_mul_i32: vector cannot be NULL");
+    DI_STATS_OP(DI_STATS_VEC, a->offsets[a->blocks]);
+    DI_TRACE_BEGIN(DI_STATS_VEC, a->offsets[a->blocks], 0);
+
+    // |scalar| <= 2^31 adds at most 32 bits to every value
+    size_t extra = (32 + DI_LIMB_BITS - 1) / DI_LIMB_BITS;
+    uint32_t m = scalar < 0 ? (uint32_t)0 - (uint32_t)scalar : (uint32_t)scalar;
+    size_t bound = a->offsets[a->blocks] + a->blocks * extra * DI_VEC_LANES;
+
+    struct di_vec_internal* result = di_vec_alloc(a->count);
+    di_vec_alloc_limbs(result, bound);
+    for (size_t blk = 0; blk < a->blocks; blk++) {
+        size_t wa = di_vec_width(a, blk);
+        size_t wr = wa + extra;
+        di_limb_t* r = result->limbs + result->offsets[blk];
+        di_vec_mul_block(r, wr, a->limbs + a->offsets[blk], wa, m);
+        if (scalar < 0) di_vec_negate_block(r, wr);
+        result->offsets[blk + 1] = result->offsets[blk] + di_vec_trim(r, wr) * DI_VEC_LANES;
+    }
+    DI_TRACE_END();
+    return result;
+}
+
+DI_IMPL void di_vec_cmp(int* out, di_vec a, di_vec b) {
+    DI_ASSERT(a && b && "di_vec_cmp: vectors cannot be NULL");
+    DI_ASSERT(a->count == b->count && "di_vec_cmp: vectors must have the same length");
+    DI_ASSERT((out || a->count == 0) && "di_vec_cmp: output cannot be NULL");
+    DI_STATS_OP(DI_STATS_VEC, a->offsets[a->blocks] + b->offsets[b->blocks]);
+    DI_TRACE_BEGIN(DI_STATS_VEC, a->offsets[a->blocks], b->offsets[b->blocks]);
+
+    for (size_t blk = 0; blk < a->blocks; blk++) {
+        size_t first = blk * DI_VEC_LANES;
+        size_t lanes = a->count - first < DI_VEC_LANES ? a->count - first : DI_VEC_LANES;
+        di_vec_cmp_block(out + first, lanes,
+                         a->limbs + a->offsets[blk], di_vec_width(a, blk),
+                         b->limbs + b->offsets[blk], di_vec_width(b, blk));
+    }
+    DI_TRACE_END();
+}
+
+DI_IMPL void di_vec_free(di_vec* vec) {
+    if (!vec || !*vec) return;
+    DI_FREE((*vec)->limbs);
+    DI_FREE(*vec);
+    *vec = NULL;
+}
+
+/* Columnar file storage */
+
+/*
+ * File layout (host byte order):
+ *   0   char     magic[8]           "DICOL1\0\0"
+ *   8   uint32_t limb_bits          DI_LIMB_BITS of the writer
+ *   12  uint32_t flags              bit 0: written by a big-endian host
+ *   16  uint64_t count              number of integers
+ *   24  uint64_t payload_limbs      total limbs in the payload
+ *   32  uint64_t offsets[count + 1] limb offset of each entry in the payload
+ *   ..  uint8_t  signs[]            one bit per entry, padded to 8 bytes
+ *   ..  limbs    payload[]          8-byte aligned
+ */
+#define DI_COLUMN_MAGIC "DICOL1\0\0"
+#define DI_COLUMN_HEADER_SIZE 32
+
+struct di_column_internal {
+    uint8_t* base;              // Mapped (or loaded) file contents
+    size_t size;                // File size in bytes
+    bool mapped;                // base came from mmap() rather than DI_MALLOC
+    size_t count;               // Number of entries
+    const uint64_t* offsets;    // count + 1 payload offsets
+    const uint8_t* signs;       // Sign bitmap
+    const di_limb_t* payload;   // Contiguous limbs of all entries
+    uint64_t payload_limbs;     // Number of limbs in payload
+};
+
+static size_t di_column_signs_size(uint64_t count) {
+    return (size_t)(((count + 7) / 8 + 7) & ~(uint64_t)7);
+}
+
+DI_IMPL bool di_column_write(const char* path, const di_int* values, size_t count) {
+    DI_ASSERT(path && "di_column_write: path cannot be NULL");
+    DI_ASSERT((values || count == 0) && "di_column_write: values cannot be NULL");
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    uint64_t payload_limbs = 0;
+    for (size_t i = 0; i < count; i++) {
+        DI_ASSERT(values[i] && "di_column_write: values cannot contain NULL");
+        payload_limbs += values[i]->limb_count;
+    }
+
+    uint8_t header[DI_COLUMN_HEADER_SIZE];
+    uint32_t limb_bits = DI_LIMB_BITS;
+    uint32_t flags = di_host_is_little_endian() ? 0 : 1;
+    uint64_t count64 = count;
+    memcpy(header, DI_COLUMN_MAGIC, 8);
+    memcpy(header + 8, &limb_bits, 4);
+    memcpy(header + 12, &flags, 4);
+    memcpy(header + 16, &count64, 8);
+    memcpy(header + 24, &payload_limbs, 8);
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    // Offset index
+    uint64_t offset = 0;
+    for (size_t i = 0; ok && i <= count; i++) {
+        ok = fwrite(&offset, sizeof(offset), 1, file) == 1;
+        if (i < count) offset += values[i]->limb_count;
+    }
+
+    // Sign bitmap, one byte at a time, then padding
+    size_t sign_bytes = di_column_signs_size(count);
+    for (size_t byte = 0; ok && byte < sign_bytes; byte++) {
+        uint8_t bits = 0;
+        for (size_t bit = 0; bit < 8; bit++) {
+            size_t i = byte * 8 + bit;
+            if (i < count && values[i]->is_negative && values[i]->limb_count > 0) {
+                bits |= (uint8_t)(1u << bit);
+            }
         }
+        ok = fputc(bits, file) != EOF;
     }
-    
-    di_release(&range);
-    return NULL; // Failed to generate
+
+    // Payload
+    for (size_t i = 0; ok && i < count; i++) {
+        size_t n = values[i]->limb_count;
+        ok = n == 0 || fwrite(values[i]->limbs, sizeof(di_limb_t), n, file) == n;
+    }
+
+    if (fclose(file) != 0) ok = false;
+    return ok;
 }
 
-// Calculate bit length of an arbitrary precision integer
-DI_IMPL size_t di_bit_length(di_int big) {
-    DI_ASSERT(big && "di_bit_length: operand cannot be NULL");
-    if (big->limb_count == 0) return 0;
-    
-    // Find the most significant limb
-    size_t high_limb_idx = big->limb_count - 1;
-    di_limb_t high_limb = big->limbs[high_limb_idx];
-    
-    // Count bits in the high limb
-    size_t high_limb_bits = 0;
-    if (high_limb != 0) {
-        di_limb_t temp = high_limb;
-        while (temp > 0) {
-            high_limb_bits++;
-            temp >>= 1;
+DI_IMPL di_column di_column_open(const char* path) {
+    DI_ASSERT(path && "di_column_open: path cannot be NULL");
+
+    uint8_t* base = NULL;
+    size_t size = 0;
+    bool mapped = false;
+
+#ifdef DI_HAS_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < DI_COLUMN_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+    size = (size_t)st.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+    base = (uint8_t*)map;
+    mapped = true;
+#else
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    long end = ftell(file);
+    if (end < DI_COLUMN_HEADER_SIZE || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    size = (size_t)end;
+    // Allocate in 8-byte units so the payload stays aligned
+    base = (uint8_t*)DI_MALLOC((size + 7) & ~(size_t)7);
+    DI_ASSERT(base && "di_column_open: allocation failed");
+    bool read_ok = fread(base, 1, size, file) == size;
+    fclose(file);
+    if (!read_ok) {
+        DI_FREE(base);
+        return NULL;
+    }
+#endif
+
+    struct di_column_internal* col = (struct di_column_internal*)DI_MALLOC(sizeof(struct di_column_internal));
+    DI_ASSERT(col && "di_column_open: allocation failed");
+    col->base = base;
+    col->size = size;
+    col->mapped = mapped;
+
+    uint32_t limb_bits, flags;
+    uint64_t count, payload_limbs;
+    memcpy(&limb_bits, base + 8, 4);
+    memcpy(&flags, base + 12, 4);
+    memcpy(&count, base + 16, 8);
+    memcpy(&payload_limbs, base + 24, 8);
+
+    // Validate the header and that all sections fit in the file
+    bool valid = memcmp(base, DI_COLUMN_MAGIC, 8) == 0 &&
+                 limb_bits == DI_LIMB_BITS &&
+                 flags == (di_host_is_little_endian() ? 0u : 1u) &&
+                 count < (uint64_t)SIZE_MAX / 16;
+    if (valid) {
+        uint64_t payload_start = DI_COLUMN_HEADER_SIZE + (count + 1) * 8 + di_column_signs_size(count);
+        valid = payload_start <= size &&
+                payload_limbs <= (size - payload_start) / sizeof(di_limb_t) &&
+                payload_start + payload_limbs * sizeof(di_limb_t) == size;
+        if (valid) {
+            col->count = (size_t)count;
+            col->offsets = (const uint64_t*)(const void*)(base + DI_COLUMN_HEADER_SIZE);
+            col->signs = base + DI_COLUMN_HEADER_SIZE + (count + 1) * 8;
+            col->payload = (const di_limb_t*)(const void*)(base + payload_start);
+            col->payload_limbs = payload_limbs;
+
+            // The index must span the payload exactly; di_column_get()
+            // checks the two offsets it reads, which keeps opening O(1)
+            valid = col->offsets[0] == 0 && col->offsets[count] == payload_limbs;
         }
     }
-    
-    return high_limb_idx * DI_LIMB_BITS + high_limb_bits;
+
+    if (!valid) {
+        di_column_close(&col);
+        return NULL;
+    }
+    return col;
 }
 
-// Count of limbs used
-DI_IMPL size_t di_limb_count(di_int big) {
-    DI_ASSERT(big && "di_limb_count: operand cannot be NULL");
-    return big->limb_count;
+DI_IMPL size_t di_column_count(di_column col) {
+    DI_ASSERT(col && "di_column_count: column cannot be NULL");
+    return col->count;
 }
 
-// Extended Euclidean Algorithm: finds gcd(a,b) and coefficients x,y such that ax + by = gcd(a,b)
-DI_IMPL di_int di_extended_gcd(di_int a, di_int b, di_int* x, di_int* y) {
-    DI_ASSERT(a && "di_extended_gcd: first operand cannot be NULL");
-    DI_ASSERT(b && "di_extended_gcd: second operand cannot be NULL");
-    DI_ASSERT(x && "di_extended_gcd: x pointer cannot be NULL");
-    DI_ASSERT(y && "di_extended_gcd: y pointer cannot be NULL");
-    
-    // Initialize
-    di_int old_r = di_abs(a);
-    di_int r = di_abs(b);
-    di_int old_s = di_one();
-    di_int s = di_zero();
-    di_int old_t = di_zero();
-    di_int t = di_one();
-    
-    if (!old_r || !r || !old_s || !s || !old_t || !t) {
-        di_release(&old_r); di_release(&r);
-        di_release(&old_s); di_release(&s);
-        di_release(&old_t); di_release(&t);
-        return NULL;
+DI_IMPL di_view di_column_get(di_column col, size_t index) {
+    DI_ASSERT(col && "di_column_get: column cannot be NULL");
+    DI_ASSERT(index < col->count && "di_column_get: index out of range");
+
+    uint64_t start = col->offsets[index];
+    uint64_t end = col->offsets[index + 1];
+    if (start > end || end > col->payload_limbs) {
+        di_view corrupt = { NULL, 0, false };
+        return corrupt;
     }
-    
-    while (!di_is_zero(r)) {
-        di_int quotient = di_div(old_r, r);
-        if (!quotient) break;
-        
-        // (old_r, r) := (r, old_r - quotient * r)
-        di_int temp1 = di_mul(quotient, r);
-        di_int new_r = di_sub(old_r, temp1);
-        di_release(&temp1);
-        di_release(&old_r);
-        old_r = r;
-        r = new_r;
-        
-        // (old_s, s) := (s, old_s - quotient * s)
-        di_int temp2 = di_mul(quotient, s);
-        di_int new_s = di_sub(old_s, temp2);
-        di_release(&temp2);
-        di_release(&old_s);
-        old_s = s;
-        s = new_s;
-        
-        // (old_t, t) := (t, old_t - quotient * t)
-        di_int temp3 = di_mul(quotient, t);
-        di_int new_t = di_sub(old_t, temp3);
-        di_release(&temp3);
-        di_release(&quotient);
-        di_release(&old_t);
-        old_t = t;
-        t = new_t;
-        
-        if (!r || !s || !t) break;
+
+    bool negative = (col->signs[index / 8] >> (index % 8)) & 1;
+    return di_view_from_limbs(col->payload + start, (size_t)(end - start), negative);
+}
+
+DI_IMPL void di_column_close(di_column* col) {
+    if (!col || !*col) return;
+
+    struct di_column_internal* c = *col;
+#ifdef DI_HAS_MMAP
+    if (c->mapped) {
+        munmap(c->base, c->size);
     }
-    
-    // Set output coefficients
-    *x = old_s;
-    *y = old_t;
-    
-    di_release(&r);
-    di_release(&s);
-    di_release(&t);
-    
-    return old_r; // This is gcd(a,b)
+#endif
+    if (!c->mapped) {
+        DI_FREE(c->base);
+    }
+    DI_FREE(c);
+    *col = NULL;
 }
 
 #endif // DI_IMPLEMENTATION
@@ -0,0 +1,610 @@
+// Differential check and speed comparison against GMP
+//
+// Runs random operands through dynamic_int.h and the matching mpz_*
+// function for every operation, fails on the first size band with a
+// mismatch, then times both libraries on the same operands. Operand
+// lengths are drawn from bands of 1, 4, 16, ... limbs and include
+// all-ones and power-of-two values that push carries through every limb.
+//
+// Usage: gmp_compare [--max-limbs N] [--min-time MS] [--cases N]
+//                    [--filter TEXT] [--all-cpus]
+//
+//   --max-limbs N   largest band for every operation; by default slow
+//                   operations stop at smaller bands
+//   --min-time MS   time each side for at least MS milliseconds (100);
+//                   0 only checks results
+//   --cases N       random operand sets per operation and band (20)
+//   --filter TEXT   only operations whose name contains TEXT
+//   --all-cpus      check every kernel set the CPU supports, not just the
+//                   one di_get_cpu() picks
+//
+// Results go to stdout as CSV: operation,limbs,di_ns_per_op,
+// gmp_ns_per_op,gmp_speedup (how many times faster GMP is).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <gmp.h>
+#define DI_IMPLEMENTATION
+#include "dynamic_int.h"
+
+typedef struct {
+    di_int a;
+    di_int b;
+    di_int m;
+    size_t bits;        // Shift count
+    uint32_t n;         // Exponent, or n for factorial and binomial
+    uint32_t k;         // k for binomial
+    int32_t small;      // Second operand of the _i32 forms (also in b)
+    bool timing;        // Full-length positive operands, for timing
+    char* text;         // Decimal a, for from_string
+    mpz_t za;
+    mpz_t zb;
+    mpz_t zm;
+} cmp_operands;
+
+typedef struct {
+    const char* name;
+    size_t default_max_limbs;
+    void (*domain)(cmp_operands* ops);          // Fix operands up for the operation
+    di_int (*run_di)(const cmp_operands* ops);
+    void (*run_gmp)(mpz_t r, const cmp_operands* ops);
+    bool (*check)(const cmp_operands* ops);     // NULL: compare run_di with run_gmp
+} cmp_case;
+
+static di_rng cmp_rng;
+static size_t cmp_mismatches = 0;
+
+static double cmp_now_ns(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static size_t cmp_below(size_t n) {
+    return (size_t)(di_rng_next(&cmp_rng) % n);
+}
+
+static void cmp_to_mpz(mpz_t z, di_int x) {
+    size_t words = di_export_size(x, sizeof(di_limb_t));
+    di_limb_t* buf = (di_limb_t*)malloc(sizeof(di_limb_t) * (words ? words : 1));
+    di_export(x, buf, words * sizeof(di_limb_t), sizeof(di_limb_t), DI_ENDIAN_NATIVE, DI_ORDER_LSF);
+    mpz_import(z, words, -1, sizeof(di_limb_t), 0, 0, buf);
+    if (di_is_negative(x)) mpz_neg(z, z);
+    free(buf);
+}
+
+static di_int cmp_power_of_two(size_t bit) {
+    di_int one = di_one();
+    di_int r = di_shift_left(one, bit);
+    di_release(&one);
+    return r;
+}
+
+// Random value of 1..limbs limbs, random sign; every fourth value is
+// all ones and every eighth a power of two
+static di_int cmp_random(size_t limbs) {
+    size_t bits = (limbs - 1) * DI_LIMB_BITS + 1 + cmp_below(DI_LIMB_BITS);
+    if (limbs > 1 && cmp_below(2)) bits = 1 + cmp_below(limbs * DI_LIMB_BITS);
+    di_int r;
+    switch (cmp_below(8)) {
+    case 0:
+    case 1: {
+        di_int power = cmp_power_of_two(bits);
+        di_int one = di_one();
+        r = di_sub(power, one);
+        di_release(&power);
+        di_release(&one);
+        break;
+    }
+    case 2:
+        r = cmp_power_of_two(bits - 1);
+        break;
+    default:
+        r = di_random_r(bits, &cmp_rng);
+        break;
+    }
+    if (cmp_below(2)) {
+        di_int negated = di_negate(r);
+        di_release(&r);
+        r = negated;
+    }
+    return r;
+}
+
+static void cmp_replace(di_int* x, di_int value) {
+    di_release(x);
+    *x = value;
+}
+
+/* Operand domains */
+
+static void domain_divisor(cmp_operands* ops) {
+    if (di_is_zero(ops->b)) cmp_replace(&ops->b, di_one());
+}
+
+static void domain_non_negative(cmp_operands* ops) {
+    cmp_replace(&ops->a, di_abs(ops->a));
+}
+
+static void domain_text(cmp_operands* ops) {
+    ops->text = di_to_string(ops->a, 10);
+}
+
+// Random counts reach past the top; timing uses a short shift like bench.c
+static void domain_shift(cmp_operands* ops) {
+    ops->bits = ops->timing ? 13 : cmp_below(3 * DI_LIMB_BITS * (di_limb_count(ops->a) + 1));
+}
+
+// Modulus above one, odd or even. Even moduli skip Montgomery and reduce
+// with di_mod() after every step, so their exponents are kept to one limb;
+// timing uses an odd modulus.
+static void domain_mod_pow(cmp_operands* ops) {
+    cmp_replace(&ops->b, di_abs(ops->b));
+    cmp_replace(&ops->m, di_abs(ops->m));
+    di_int one = di_one();
+    if (di_le(ops->m, one)) cmp_replace(&ops->m, di_from_string("3", 10));
+    if (ops->timing) cmp_replace(&ops->m, di_or(ops->m, one));
+    if (!(ops->m->limbs[0] & 1)) {
+        di_int mask = di_from_string("65535", 10);
+        cmp_replace(&ops->b, di_and(ops->b, mask));
+        di_release(&mask);
+    }
+    di_release(&one);
+}
+
+// n grows with the band so results reach a few times its length
+static void domain_factorial(cmp_operands* ops) {
+    uint32_t top = (uint32_t)(2 * DI_LIMB_BITS * di_limb_count(ops->a));
+    ops->n = ops->timing ? top : (uint32_t)cmp_below(top + 1);
+}
+
+// k past n is included; both sides return 0 there
+static void domain_binomial(cmp_operands* ops) {
+    uint32_t top = (uint32_t)(8 * DI_LIMB_BITS * di_limb_count(ops->a));
+    ops->n = ops->timing ? top : (uint32_t)cmp_below(top + 1);
+    ops->k = ops->timing ? top / 2 : (uint32_t)cmp_below((size_t)ops->n + 2);
+}
+
+static void domain_pow(cmp_operands* ops) {
+    ops->n = ops->timing ? 13 : (uint32_t)cmp_below(64);
+}
+
+// Odd values, half of them moved up to the next prime while that is cheap;
+// the rest are nearly all composite
+static void domain_prime(cmp_operands* ops) {
+    di_int one = di_one();
+    cmp_replace(&ops->a, di_abs(ops->a));
+    cmp_replace(&ops->a, di_or(ops->a, one));
+    if (di_limb_count(ops->a) <= 8 && (ops->timing || cmp_below(2))) {
+        cmp_replace(&ops->a, di_next_prime(ops->a));
+    }
+    di_release(&one);
+}
+
+// Random int32 with the extremes mixed in; b carries it for the checks
+static void domain_i32(cmp_operands* ops) {
+    static const int32_t edges[] = { 0, 1, -1, INT32_MAX, INT32_MIN };
+    size_t pick = cmp_below(8);
+    ops->small = pick < 5 ? edges[pick] : (int32_t)(uint32_t)di_rng_next(&cmp_rng);
+    cmp_replace(&ops->b, di_from_int32(ops->small));
+}
+
+/* Operations */
+
+static di_int di_run_add(const cmp_operands* ops) { return di_add(ops->a, ops->b); }
+static di_int di_run_sub(const cmp_operands* ops) { return di_sub(ops->a, ops->b); }
+static di_int di_run_mul(const cmp_operands* ops) { return di_mul(ops->a, ops->b); }
+static di_int di_run_div(const cmp_operands* ops) { return di_div(ops->a, ops->b); }
+static di_int di_run_mod(const cmp_operands* ops) { return di_mod(ops->a, ops->b); }
+static di_int di_run_and(const cmp_operands* ops) { return di_and(ops->a, ops->b); }
+static di_int di_run_or(const cmp_operands* ops) { return di_or(ops->a, ops->b); }
+static di_int di_run_xor(const cmp_operands* ops) { return di_xor(ops->a, ops->b); }
+static di_int di_run_not(const cmp_operands* ops) { return di_not(ops->a); }
+static di_int di_run_shift_left(const cmp_operands* ops) { return di_shift_left(ops->a, ops->bits); }
+static di_int di_run_shift_right(const cmp_operands* ops) { return di_shift_right(ops->a, ops->bits); }
+static di_int di_run_gcd(const cmp_operands* ops) { return di_gcd(ops->a, ops->b); }
+static di_int di_run_sqrt(const cmp_operands* ops) { return di_sqrt(ops->a); }
+static di_int di_run_mod_pow(const cmp_operands* ops) { return di_mod_pow(ops->a, ops->b, ops->m); }
+static di_int di_run_from_string(const cmp_operands* ops) { return di_from_string(ops->text, 10); }
+static di_int di_run_pow(const cmp_operands* ops) { return di_pow(ops->a, ops->n); }
+static di_int di_run_factorial(const cmp_operands* ops) { return di_factorial(ops->n); }
+static di_int di_run_binomial(const cmp_operands* ops) { return di_binomial(ops->n, ops->k); }
+static di_int di_run_add_i32(const cmp_operands* ops) { return di_add_i32(ops->a, ops->small); }
+static di_int di_run_sub_i32(const cmp_operands* ops) { return di_sub_i32(ops->a, ops->small); }
+static di_int di_run_mul_i32(const cmp_operands* ops) { return di_mul_i32(ops->a, ops->small); }
+
+static di_int di_run_is_prime(const cmp_operands* ops) {
+    return di_from_int32(di_is_prime(ops->a, 25));
+}
+
+// Batches of three pairs drawn from a, b and m; timing keeps the first result
+static void cmp_batch_pairs(const cmp_operands* ops, di_int* a, di_int* b) {
+    a[0] = ops->a; a[1] = ops->b; a[2] = ops->m;
+    b[0] = ops->b; b[1] = ops->m; b[2] = ops->a;
+}
+
+static di_int di_run_batch(const cmp_operands* ops, void (*batch)(di_int*, const di_int*, const di_int*, size_t)) {
+    di_int a[3], b[3], out[3];
+    cmp_batch_pairs(ops, a, b);
+    batch(out, a, b, 3);
+    di_release(&out[1]);
+    di_release(&out[2]);
+    return out[0];
+}
+
+static di_int di_run_add_batch(const cmp_operands* ops) { return di_run_batch(ops, di_add_batch); }
+static di_int di_run_mul_batch(const cmp_operands* ops) { return di_run_batch(ops, di_mul_batch); }
+
+static di_int di_run_compare(const cmp_operands* ops) {
+    return di_from_int32(di_compare(ops->a, ops->b));
+}
+
+static di_int di_run_to_string(const cmp_operands* ops) {
+    free(di_to_string(ops->a, 10));
+    return NULL;
+}
+
+static void gmp_run_add(mpz_t r, const cmp_operands* ops) { mpz_add(r, ops->za, ops->zb); }
+static void gmp_run_sub(mpz_t r, const cmp_operands* ops) { mpz_sub(r, ops->za, ops->zb); }
+static void gmp_run_mul(mpz_t r, const cmp_operands* ops) { mpz_mul(r, ops->za, ops->zb); }
+static void gmp_run_div(mpz_t r, const cmp_operands* ops) { mpz_fdiv_q(r, ops->za, ops->zb); }
+static void gmp_run_mod(mpz_t r, const cmp_operands* ops) { mpz_fdiv_r(r, ops->za, ops->zb); }
+static void gmp_run_gcd(mpz_t r, const cmp_operands* ops) { mpz_gcd(r, ops->za, ops->zb); }
+static void gmp_run_sqrt(mpz_t r, const cmp_operands* ops) { mpz_sqrt(r, ops->za); }
+static void gmp_run_from_string(mpz_t r, const cmp_operands* ops) { mpz_set_str(r, ops->text, 10); }
+static void gmp_run_pow(mpz_t r, const cmp_operands* ops) { mpz_pow_ui(r, ops->za, ops->n); }
+static void gmp_run_factorial(mpz_t r, const cmp_operands* ops) { mpz_fac_ui(r, ops->n); }
+static void gmp_run_binomial(mpz_t r, const cmp_operands* ops) { mpz_bin_uiui(r, ops->n, ops->k); }
+static void gmp_run_mul_i32(mpz_t r, const cmp_operands* ops) { mpz_mul_si(r, ops->za, ops->small); }
+
+// GMP has no mpz_add_si or mpz_sub_si
+static void gmp_run_add_i32(mpz_t r, const cmp_operands* ops) {
+    unsigned long magnitude = ops->small < 0 ? 0UL - (unsigned long)ops->small : (unsigned long)ops->small;
+    if (ops->small < 0) mpz_sub_ui(r, ops->za, magnitude);
+    else mpz_add_ui(r, ops->za, magnitude);
+}
+
+static void gmp_run_sub_i32(mpz_t r, const cmp_operands* ops) {
+    unsigned long magnitude = ops->small < 0 ? 0UL - (unsigned long)ops->small : (unsigned long)ops->small;
+    if (ops->small < 0) mpz_add_ui(r, ops->za, magnitude);
+    else mpz_sub_ui(r, ops->za, magnitude);
+}
+
+// Verdicts only: GMP's 2 (certain) and 1 (probable) both mean prime
+static void gmp_run_is_prime(mpz_t r, const cmp_operands* ops) {
+    mpz_set_si(r, mpz_probab_prime_p(ops->za, 25) != 0);
+}
+
+static void gmp_run_batch(mpz_t r, const cmp_operands* ops, void (*op)(mpz_ptr, mpz_srcptr, mpz_srcptr)) {
+    op(r, ops->zm, ops->za);
+    op(r, ops->zb, ops->zm);
+    op(r, ops->za, ops->zb);
+}
+
+static void gmp_run_add_batch(mpz_t r, const cmp_operands* ops) { gmp_run_batch(r, ops, mpz_add); }
+static void gmp_run_mul_batch(mpz_t r, const cmp_operands* ops) { gmp_run_batch(r, ops, mpz_mul); }
+
+// dynamic_int's bitwise operations work on magnitudes
+static void gmp_run_bitwise(mpz_t r, const cmp_operands* ops,
+                            void (*op)(mpz_ptr, mpz_srcptr, mpz_srcptr)) {
+    if (mpz_sgn(ops->za) >= 0 && mpz_sgn(ops->zb) >= 0) {
+        op(r, ops->za, ops->zb);
+        return;
+    }
+    mpz_t b;
+    mpz_init(b);
+    mpz_abs(r, ops->za);
+    mpz_abs(b, ops->zb);
+    op(r, r, b);
+    mpz_clear(b);
+}
+
+static void gmp_run_and(mpz_t r, const cmp_operands* ops) { gmp_run_bitwise(r, ops, mpz_and); }
+static void gmp_run_or(mpz_t r, const cmp_operands* ops) { gmp_run_bitwise(r, ops, mpz_ior); }
+static void gmp_run_xor(mpz_t r, const cmp_operands* ops) { gmp_run_bitwise(r, ops, mpz_xor); }
+
+// di_not() complements |a| over one limb more than a has
+static void gmp_run_not(mpz_t r, const cmp_operands* ops) {
+    mpz_set_ui(r, 0);
+    mpz_setbit(r, (mp_bitcnt_t)(di_limb_count(ops->a) + 1) * DI_LIMB_BITS);
+    mpz_sub_ui(r, r, 1);
+    mpz_t a;
+    mpz_init(a);
+    mpz_abs(a, ops->za);
+    mpz_sub(r, r, a);
+    mpz_clear(a);
+}
+
+static void gmp_run_shift_left(mpz_t r, const cmp_operands* ops) {
+    mpz_mul_2exp(r, ops->za, (mp_bitcnt_t)ops->bits);
+}
+
+// Sign and magnitude: the magnitude is shifted, so negatives round to zero
+static void gmp_run_shift_right(mpz_t r, const cmp_operands* ops) {
+    mpz_tdiv_q_2exp(r, ops->za, (mp_bitcnt_t)ops->bits);
+}
+
+static void gmp_run_compare(mpz_t r, const cmp_operands* ops) {
+    int c = mpz_cmp(ops->za, ops->zb);
+    mpz_set_si(r, (c > 0) - (c < 0));
+}
+
+static void gmp_run_mod_pow(mpz_t r, const cmp_operands* ops) {
+    mpz_powm(r, ops->za, ops->zb, ops->zm);
+}
+
+static void gmp_run_to_string(mpz_t r, const cmp_operands* ops) {
+    (void)r;
+    free(mpz_get_str(NULL, 10, ops->za));
+}
+
+static bool check_to_string(const cmp_operands* ops) {
+    char* mine = di_to_string(ops->a, 10);
+    char* theirs = mpz_get_str(NULL, 10, ops->za);
+    bool same = mine && strcmp(mine, theirs) == 0;
+    free(mine);
+    free(theirs);
+    return same;
+}
+
+// Every pair of a batch, not just the one the timing keeps
+static bool check_batch(const cmp_operands* ops, void (*batch)(di_int*, const di_int*, const di_int*, size_t),
+                        void (*op)(mpz_ptr, mpz_srcptr, mpz_srcptr)) {
+    di_int a[3], b[3], out[3];
+    cmp_batch_pairs(ops, a, b);
+    batch(out, a, b, 3);
+    mpz_t za, zb, expected, actual;
+    mpz_inits(za, zb, expected, actual, NULL);
+    bool same = true;
+    for (int i = 0; i < 3; i++) {
+        cmp_to_mpz(za, a[i]);
+        cmp_to_mpz(zb, b[i]);
+        op(expected, za, zb);
+        cmp_to_mpz(actual, out[i]);
+        same = same && mpz_cmp(actual, expected) == 0;
+        di_release(&out[i]);
+    }
+    mpz_clears(za, zb, expected, actual, NULL);
+    return same;
+}
+
+static bool check_add_batch(const cmp_operands* ops) { return check_batch(ops, di_add_batch, mpz_add); }
+static bool check_mul_batch(const cmp_operands* ops) { return check_batch(ops, di_mul_batch, mpz_mul); }
+
+static const cmp_case cmp_cases[] = {
+    { "add", 16384, NULL, di_run_add, gmp_run_add, NULL },
+    { "sub", 16384, NULL, di_run_sub, gmp_run_sub, NULL },
+    { "compare", 16384, NULL, di_run_compare, gmp_run_compare, NULL },
+    { "and", 16384, NULL, di_run_and, gmp_run_and, NULL },
+    { "or", 16384, NULL, di_run_or, gmp_run_or, NULL },
+    { "xor", 16384, NULL, di_run_xor, gmp_run_xor, NULL },
+    { "not", 16384, NULL, di_run_not, gmp_run_not, NULL },
+    { "shift_left", 16384, domain_shift, di_run_shift_left, gmp_run_shift_left, NULL },
+    { "shift_right", 16384, domain_shift, di_run_shift_right, gmp_run_shift_right, NULL },
+    { "mul", 4096, NULL, di_run_mul, gmp_run_mul, NULL },
+    { "div", 256, domain_divisor, di_run_div, gmp_run_div, NULL },
+    { "mod", 256, domain_divisor, di_run_mod, gmp_run_mod, NULL },
+    { "to_string", 1024, NULL, di_run_to_string, gmp_run_to_string, check_to_string },
+    { "from_string", 1024, domain_text, di_run_from_string, gmp_run_from_string, NULL },
+    { "sqrt", 64, domain_non_negative, di_run_sqrt, gmp_run_sqrt, NULL },
+    { "gcd", 64, NULL, di_run_gcd, gmp_run_gcd, NULL },
+    { "mod_pow", 64, domain_mod_pow, di_run_mod_pow, gmp_run_mod_pow, NULL },
+    { "pow", 64, domain_pow, di_run_pow, gmp_run_pow, NULL },
+    { "factorial", 256, domain_factorial, di_run_factorial, gmp_run_factorial, NULL },
+    { "binomial", 256, domain_binomial, di_run_binomial, gmp_run_binomial, NULL },
+    { "is_prime", 64, domain_prime, di_run_is_prime, gmp_run_is_prime, NULL },
+    { "add_i32", 16384, domain_i32, di_run_add_i32, gmp_run_add_i32, NULL },
+    { "sub_i32", 16384, domain_i32, di_run_sub_i32, gmp_run_sub_i32, NULL },
+    { "mul_i32", 16384, domain_i32, di_run_mul_i32, gmp_run_mul_i32, NULL },
+    { "add_batch", 16384, NULL, di_run_add_batch, gmp_run_add_batch, check_add_batch },
+    { "mul_batch", 4096, NULL, di_run_mul_batch, gmp_run_mul_batch, check_mul_batch },
+};
+
+/* Operand sets */
+
+static void cmp_setup(cmp_operands* ops, const cmp_case* c, size_t limbs, bool exact) {
+    if (exact) {
+        // Full-length positive operands for timing
+        di_int top = cmp_power_of_two(limbs * DI_LIMB_BITS - 1);
+        di_int low[3];
+        for (int i = 0; i < 3; i++) {
+            di_int r = di_random_r(limbs * DI_LIMB_BITS - 1, &cmp_rng);
+            low[i] = di_or(r, top);
+            di_release(&r);
+        }
+        ops->a = low[0];
+        ops->b = low[1];
+        ops->m = low[2];
+        di_release(&top);
+    } else {
+        ops->a = cmp_random(limbs);
+        ops->b = cmp_random(1 + cmp_below(limbs));
+        if (cmp_below(2)) {
+            di_int t = ops->a;
+            ops->a = ops->b;
+            ops->b = t;
+        }
+        ops->m = cmp_random(limbs);
+    }
+    ops->bits = 0;
+    ops->n = ops->k = 0;
+    ops->small = 0;
+    ops->timing = exact;
+    ops->text = NULL;
+    if (c->domain) c->domain(ops);
+    mpz_inits(ops->za, ops->zb, ops->zm, NULL);
+    cmp_to_mpz(ops->za, ops->a);
+    cmp_to_mpz(ops->zb, ops->b);
+    cmp_to_mpz(ops->zm, ops->m);
+}
+
+static void cmp_release(cmp_operands* ops) {
+    di_release(&ops->a);
+    di_release(&ops->b);
+    di_release(&ops->m);
+    free(ops->text);
+    mpz_clears(ops->za, ops->zb, ops->zm, NULL);
+}
+
+static void cmp_print(const char* label, const mpz_t z) {
+    fprintf(stderr, "  %s = 0x", label);
+    mpz_out_str(stderr, 16, z);
+    fputc('\n', stderr);
+}
+
+static bool cmp_check(const cmp_case* c, const cmp_operands* ops) {
+    bool same;
+    mpz_t expected, actual;
+    mpz_inits(expected, actual, NULL);
+    if (c->check) {
+        same = c->check(ops);
+    } else {
+        di_int r = c->run_di(ops);
+        c->run_gmp(expected, ops);
+        same = r != NULL;
+        if (r) {
+            cmp_to_mpz(actual, r);
+            same = mpz_cmp(actual, expected) == 0;
+        }
+        di_release(&r);
+    }
+    if (!same && cmp_mismatches++ < 10) {
+        fprintf(stderr, "%s: mismatch with GMP (kernels: %s, shift: %zu, n: %u, k: %u, small: %d)\n",
+                c->name, di_get_cpu(), ops->bits, (unsigned)ops->n, (unsigned)ops->k, (int)ops->small);
+        cmp_print("a", ops->za);
+        cmp_print("b", ops->zb);
+        cmp_print("m", ops->zm);
+        if (!c->check) {
+            cmp_print("dynamic_int", actual);
+            cmp_print("gmp", expected);
+        }
+    }
+    mpz_clears(expected, actual, NULL);
+    return same;
+}
+
+/* Timing */
+
+// Double the batch until it runs for min_ns; returns ns per call
+static double cmp_time_di(const cmp_case* c, const cmp_operands* ops, double min_ns) {
+    size_t iterations = 1;
+    double elapsed;
+    for (;;) {
+        double start = cmp_now_ns();
+        for (size_t i = 0; i < iterations; i++) {
+            di_int r = c->run_di(ops);
+            di_release(&r);
+        }
+        elapsed = cmp_now_ns() - start;
+        if (elapsed >= min_ns || iterations >= ((size_t)1 << 30)) break;
+        iterations *= 2;
+    }
+    return elapsed / (double)iterations;
+}
+
+static double cmp_time_gmp(const cmp_case* c, const cmp_operands* ops, double min_ns) {
+    mpz_t r;
+    mpz_init(r);
+    size_t iterations = 1;
+    double elapsed;
+    for (;;) {
+        double start = cmp_now_ns();
+        for (size_t i = 0; i < iterations; i++) c->run_gmp(r, ops);
+        elapsed = cmp_now_ns() - start;
+        if (elapsed >= min_ns || iterations >= ((size_t)1 << 30)) break;
+        iterations *= 2;
+    }
+    mpz_clear(r);
+    return elapsed / (double)iterations;
+}
+
+static bool cmp_run_band(const cmp_case* c, size_t limbs, size_t cases, double min_ns) {
+    bool ok = true;
+    for (size_t i = 0; i < cases && ok; i++) {
+        cmp_operands ops;
+        cmp_setup(&ops, c, limbs, false);
+        ok = cmp_check(c, &ops);
+        cmp_release(&ops);
+    }
+    if (!ok || min_ns <= 0) return ok;
+
+    cmp_operands ops;
+    cmp_setup(&ops, c, limbs, true);
+    if (!cmp_check(c, &ops)) ok = false;
+    double di_ns = cmp_time_di(c, &ops, min_ns);
+    double gmp_ns = cmp_time_gmp(c, &ops, min_ns);
+    printf("%s,%zu,%.1f,%.1f,%.2f\n", c->name, limbs, di_ns, gmp_ns, gmp_ns > 0 ? di_ns / gmp_ns : 0.0);
+    fflush(stdout);
+    cmp_release(&ops);
+    return ok;
+}
+
+static int cmp_usage(const char* program) {
+    fprintf(stderr, "usage: %s [--max-limbs N] [--min-time MS] [--cases N] [--filter TEXT] [--all-cpus]\n",
+            program);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    size_t max_limbs = 0;   // 0: each case's default
+    double min_ns = 100e6;
+    size_t cases = 20;
+    const char* filter = NULL;
+    bool all_cpus = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-limbs") == 0 && i + 1 < argc) {
+            max_limbs = (size_t)strtoull(argv[++i], NULL, 10);
+            if (max_limbs == 0) return cmp_usage(argv[0]);
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_ns = strtod(argv[++i], NULL) * 1e6;
+        } else if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+            cases = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--all-cpus") == 0) {
+            all_cpus = true;
+        } else {
+            return cmp_usage(argv[0]);
+        }
+    }
+
+    // The kernel set picked for this CPU goes last, so timings use it
+    const char* cpus[sizeof(di_kernel_sets) / sizeof(di_kernel_sets[0]) + 1];
+    size_t cpu_count = 0;
+    const char* chosen = di_get_cpu();
+    if (all_cpus) {
+        for (size_t i = 0; i < sizeof(di_kernel_sets) / sizeof(di_kernel_sets[0]); i++) {
+            const di_kernels* k = di_kernel_sets[i];
+            if (strcmp(k->name, chosen) != 0 && di_kernels_supported(k)) cpus[cpu_count++] = k->name;
+        }
+    }
+    cpus[cpu_count++] = chosen;
+
+    if (min_ns > 0) printf("operation,limbs,di_ns_per_op,gmp_ns_per_op,gmp_speedup\n");
+    di_rng_seed(&cmp_rng, 70);
+    for (size_t k = 0; k < cpu_count; k++) {
+        di_set_cpu(cpus[k]);
+        bool timing = k + 1 == cpu_count;
+        for (size_t c = 0; c < sizeof(cmp_cases) / sizeof(cmp_cases[0]); c++) {
+            const cmp_case* cc = &cmp_cases[c];
+            if (filter && !strstr(cc->name, filter)) continue;
+            size_t limit = max_limbs ? max_limbs : cc->default_max_limbs;
+            for (size_t limbs = 1; limbs <= limit; limbs *= 4) {
+                if (!cmp_run_band(cc, limbs, cases, timing ? min_ns : 0)) break;
+            }
+        }
+    }
+
+    if (cmp_mismatches) {
+        fprintf(stderr, "%zu mismatches with GMP\n", cmp_mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -2,6 +2,9 @@
 #define DI_IMPLEMENTATION
 #include "dynamic_int.h"
 #include "unity.h"
+#ifdef DI_THREADSAFE
+#include <pthread.h>
+#endif
 
 void setUp(void) {
     // Set up code before each test
@@ -584,6 +587,276 @@ void test_overflow_detection_int32(void) {
     TEST_ASSERT_FALSE(di_subtract_overflow_int32(INT32_MIN, 1, &result));
 }
 
+// Checks one helper result against the exact value computed with di_int
+static void check_overflow_result(di_int exact, di_int lo, di_int hi, bool ok, di_int got) {
+    bool fits = di_compare(exact, lo) >= 0 && di_compare(exact, hi) <= 0;
+    TEST_ASSERT_EQUAL(fits, ok);
+    if (ok) TEST_ASSERT_TRUE(di_eq(exact, got));
+    di_release(&exact);
+    di_release(&got);
+}
+
+#define CHECK_OVERFLOW_MATRIX(T, SUFFIX, FROM, MIN, MAX)                                        \
+    do {                                                                                         \
+        const T values[] = { MIN, (T)(MIN + 1), (T)(MIN / 2), (T)-2, (T)-1, 0, 1, 2, 3, 181,     \
+                             (T)12345, (T)(MAX / 2), (T)(MAX / 2 + 1), (T)(MAX - 1), MAX };      \
+        const unsigned shifts[] = { 0, 1, 7, 15, 16, 31, 32, 63, 64, 100 };                      \
+        const size_t n = sizeof(values) / sizeof(values[0]);                                     \
+        di_int lo = FROM(MIN), hi = FROM(MAX);                                                   \
+        for (size_t i = 0; i < n; i++) {                                                         \
+            di_int x = FROM(values[i]);                                                          \
+            T r = 0;                                                                             \
+            bool ok;                                                                             \
+            for (size_t j = 0; j < n; j++) {                                                     \
+                di_int y = FROM(values[j]);                                                      \
+                ok = di_add_overflow_##SUFFIX(values[i], values[j], &r);                         \
+                check_overflow_result(di_add(x, y), lo, hi, ok, FROM(r));                        \
+                ok = di_subtract_overflow_##SUFFIX(values[i], values[j], &r);                    \
+                check_overflow_result(di_sub(x, y), lo, hi, ok, FROM(r));                        \
+                ok = di_multiply_overflow_##SUFFIX(values[i], values[j], &r);                    \
+                check_overflow_result(di_mul(x, y), lo, hi, ok, FROM(r));                        \
+                di_release(&y);                                                                  \
+            }                                                                                    \
+            ok = di_negate_overflow_##SUFFIX(values[i], &r);                                     \
+            check_overflow_result(di_negate(x), lo, hi, ok, FROM(r));                            \
+            for (size_t k = 0; k < sizeof(shifts) / sizeof(shifts[0]); k++) {                    \
+                ok = di_shift_left_overflow_##SUFFIX(values[i], shifts[k], &r);                  \
+                check_overflow_result(di_shift_left(x, shifts[k]), lo, hi, ok, FROM(r));         \
+            }                                                                                    \
+            di_release(&x);                                                                      \
+        }                                                                                        \
+        di_release(&lo);                                                                         \
+        di_release(&hi);                                                                         \
+    } while (0)
+
+void test_overflow_matrix_signed(void) {
+    CHECK_OVERFLOW_MATRIX(int16_t, int16, di_from_int32, INT16_MIN, INT16_MAX);
+    CHECK_OVERFLOW_MATRIX(int32_t, int32, di_from_int32, INT32_MIN, INT32_MAX);
+    CHECK_OVERFLOW_MATRIX(int64_t, int64, di_from_int64, INT64_MIN, INT64_MAX);
+}
+
+void test_overflow_matrix_unsigned(void) {
+    CHECK_OVERFLOW_MATRIX(uint16_t, uint16, di_from_uint32, 0, UINT16_MAX);
+    CHECK_OVERFLOW_MATRIX(uint32_t, uint32, di_from_uint32, 0, UINT32_MAX);
+    CHECK_OVERFLOW_MATRIX(uint64_t, uint64, di_from_uint64, 0, UINT64_MAX);
+}
+
+void test_overflow_shift_and_negate_edges(void) {
+    int32_t r32;
+    TEST_ASSERT_TRUE(di_shift_left_overflow_int32(-1, 31, &r32));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, r32);
+    TEST_ASSERT_FALSE(di_shift_left_overflow_int32(1, 31, &r32));
+    TEST_ASSERT_FALSE(di_negate_overflow_int32(INT32_MIN, &r32));
+    TEST_ASSERT_TRUE(di_negate_overflow_int32(INT32_MAX, &r32));
+    TEST_ASSERT_EQUAL_INT32(-INT32_MAX, r32);
+    
+    uint64_t r64;
+    TEST_ASSERT_TRUE(di_shift_left_overflow_uint64(1, 63, &r64));
+    TEST_ASSERT_TRUE(r64 == (uint64_t)1 << 63);
+    TEST_ASSERT_FALSE(di_shift_left_overflow_uint64(1, 64, &r64));
+    TEST_ASSERT_TRUE(di_shift_left_overflow_uint64(0, 1000, &r64));
+    TEST_ASSERT_TRUE(r64 == 0);
+    TEST_ASSERT_TRUE(di_negate_overflow_uint64(0, &r64));
+    TEST_ASSERT_FALSE(di_negate_overflow_uint64(1, &r64));
+}
+
+// Hybrid number tests
+void test_num_promotes_and_demotes(void) {
+    di_num max = di_num_from_int64(INT64_MAX);
+    di_num one = di_num_from_int64(1);
+    di_num two = di_num_from_int64(2);
+    
+    di_num big = di_num_add(max, one);
+    TEST_ASSERT_NOT_NULL(big.big);
+    char* str = di_num_to_string(big, 10);
+    TEST_ASSERT_EQUAL_STRING("9223372036854775808", str);
+    free(str);
+    
+    di_num back = di_num_sub(big, two);
+    TEST_ASSERT_NULL(back.big);
+    TEST_ASSERT_EQUAL_INT64(INT64_MAX - 1, back.small);
+    
+    di_num square = di_num_mul(big, big);
+    di_num root = di_num_div(square, big);
+    TEST_ASSERT_EQUAL_INT(0, di_num_cmp(root, big));
+    TEST_ASSERT_EQUAL_INT(1, di_num_cmp(square, max));
+    TEST_ASSERT_EQUAL_INT(-1, di_num_cmp(di_num_from_int64(INT64_MIN), big));
+    
+    // Inline numbers need no release; releasing them is harmless
+    di_num_release(&one);
+    di_num_release(&big);
+    TEST_ASSERT_NULL(big.big);
+    di_num_release(&square);
+    di_num_release(&root);
+}
+
+void test_num_matches_di_int(void) {
+    const int64_t values[] = { INT64_MIN, INT64_MIN + 1, -1000000007, -7, -1, 0, 1, 3, 7,
+                               3037000499, 3037000500, INT64_MAX - 1, INT64_MAX };
+    const size_t n = sizeof(values) / sizeof(values[0]);
+    for (size_t i = 0; i < n; i++) {
+        di_num a = di_num_from_int64(values[i]);
+        di_int x = di_from_int64(values[i]);
+        for (size_t j = 0; j < n; j++) {
+            di_num b = di_num_from_int64(values[j]);
+            di_int y = di_from_int64(values[j]);
+            di_num got[5] = { di_num_add(a, b), di_num_sub(a, b), di_num_mul(a, b) };
+            di_int want[5] = { di_add(x, y), di_sub(x, y), di_mul(x, y) };
+            int ops = 3;
+            if (values[j] != 0) {
+                got[3] = di_num_div(a, b);
+                got[4] = di_num_mod(a, b);
+                want[3] = di_div(x, y);
+                want[4] = di_mod(x, y);
+                ops = 5;
+            }
+            for (int k = 0; k < ops; k++) {
+                di_int g = di_num_to_int(got[k]);
+                TEST_ASSERT_TRUE(di_eq(want[k], g));
+                int64_t fits;
+                TEST_ASSERT_EQUAL(di_to_int64(want[k], &fits), got[k].big == NULL);
+                di_release(&g);
+                di_release(&want[k]);
+                di_num_release(&got[k]);
+            }
+            TEST_ASSERT_EQUAL_INT(di_compare(x, y), di_num_cmp(a, b));
+            di_release(&y);
+        }
+        di_release(&x);
+    }
+}
+
+void test_num_from_int(void) {
+    di_int small = di_from_int32(-42);
+    di_num a = di_num_from_int(small);
+    TEST_ASSERT_NULL(a.big);
+    TEST_ASSERT_EQUAL_INT64(-42, a.small);
+    
+    di_int huge = di_from_string("-123456789012345678901234567890", 10);
+    di_num b = di_num_from_int(huge);
+    TEST_ASSERT_TRUE(b.big == huge);
+    TEST_ASSERT_EQUAL_size_t(2, di_ref_count(huge));
+    di_num c = di_num_retain(b);
+    TEST_ASSERT_EQUAL_size_t(3, di_ref_count(huge));
+    int64_t v;
+    TEST_ASSERT_FALSE(di_num_to_int64(c, &v));
+    TEST_ASSERT_TRUE(di_num_to_int64(a, &v));
+    TEST_ASSERT_EQUAL_INT64(-42, v);
+    
+    di_num_release(&b);
+    di_num_release(&c);
+    TEST_ASSERT_EQUAL_size_t(1, di_ref_count(huge));
+    di_release(&small);
+    di_release(&huge);
+}
+
+// Limbs that hold a value of the given bit width
+#define FIXED_LIMBS(bits) (((bits) + DI_LIMB_BITS - 1) / DI_LIMB_BITS)
+
+void test_fixed_arithmetic(void) {
+    DI_FIXED(a, FIXED_LIMBS(128));
+    DI_FIXED(b, FIXED_LIMBS(128));
+    DI_FIXED(r, FIXED_LIMBS(128));
+    TEST_ASSERT_TRUE(di_fixed_set_int64(&a, INT64_MAX));
+    TEST_ASSERT_TRUE(di_fixed_set_int64(&b, -3));
+    
+    char text[64];
+    TEST_ASSERT_TRUE(di_fixed_mul(&r, &a, &b));
+    TEST_ASSERT_TRUE(di_fixed_to_string(&r, 10, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("-27670116110564327421", text);
+    TEST_ASSERT_TRUE(di_fixed_sub(&r, &r, &b));   // aliased destination
+    TEST_ASSERT_TRUE(di_fixed_to_string(&r, 10, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("-27670116110564327418", text);
+    TEST_ASSERT_TRUE(di_fixed_add(&r, &a, &a));
+    TEST_ASSERT_TRUE(di_fixed_shift_right(&r, &r, 1));
+    TEST_ASSERT_EQUAL_INT(0, di_fixed_compare(&r, &a));
+    TEST_ASSERT_TRUE(di_fixed_sub(&r, &a, &a));
+    TEST_ASSERT_EQUAL_size_t(0, r.limb_count);
+    TEST_ASSERT_FALSE(r.is_negative);
+    
+    int64_t v;
+    TEST_ASSERT_TRUE(di_fixed_set_int64(&r, INT64_MIN));
+    TEST_ASSERT_TRUE(di_fixed_to_int64(&r, &v));
+    TEST_ASSERT_EQUAL_INT64(INT64_MIN, v);
+    TEST_ASSERT_TRUE(di_fixed_sub(&r, &r, &a));
+    TEST_ASSERT_FALSE(di_fixed_to_int64(&r, &v));
+    TEST_ASSERT_TRUE(di_fixed_to_string(&r, 16, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("-ffffffffffffffff", text);
+}
+
+void test_fixed_overflow_leaves_destination(void) {
+    DI_FIXED(a, FIXED_LIMBS(64));
+    DI_FIXED(r, FIXED_LIMBS(64));
+    TEST_ASSERT_TRUE(di_fixed_from_string(&a, "18446744073709551615", 10));   // 2^64 - 1
+    TEST_ASSERT_TRUE(di_fixed_set_int64(&r, 7));
+    
+    TEST_ASSERT_FALSE(di_fixed_add(&r, &a, &a));
+    TEST_ASSERT_FALSE(di_fixed_mul(&r, &a, &a));
+    TEST_ASSERT_FALSE(di_fixed_shift_left(&r, &a, 1));
+    TEST_ASSERT_FALSE(di_fixed_shift_left(&r, &r, 1000));
+    TEST_ASSERT_FALSE(di_fixed_from_string(&r, "18446744073709551616", 10));
+    TEST_ASSERT_FALSE(di_fixed_from_string(&r, "xyz", 10));
+    int64_t v;
+    TEST_ASSERT_TRUE(di_fixed_to_int64(&r, &v));
+    TEST_ASSERT_EQUAL_INT64(7, v);
+    
+    // Failed aliased operation keeps the operand too
+    TEST_ASSERT_FALSE(di_fixed_mul(&a, &a, &a));
+    char text[32];
+    TEST_ASSERT_TRUE(di_fixed_to_string(&a, 10, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("18446744073709551615", text);
+    TEST_ASSERT_FALSE(di_fixed_to_string(&a, 10, text, 20));
+    TEST_ASSERT_TRUE(di_fixed_to_string(&a, 10, text, 21));
+    
+    di_limb_t storage[FIXED_LIMBS(64) + 1];
+    di_fixed wide;
+    di_fixed_init(&wide, storage, FIXED_LIMBS(64) + 1);
+    TEST_ASSERT_TRUE(di_fixed_shift_left(&wide, &a, 1));
+    TEST_ASSERT_TRUE(di_fixed_to_string(&wide, 10, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("36893488147419103230", text);
+}
+
+void test_fixed_matches_di_int(void) {
+    const char* values[] = {
+        "0", "1", "-1", "4294967295", "-4294967296",
+        "123456789012345678901234567890",
+        "-98765432109876543210987654321098765432",
+    };
+    size_t count = sizeof(values) / sizeof(values[0]);
+    DI_FIXED(a, FIXED_LIMBS(512));
+    DI_FIXED(b, FIXED_LIMBS(512));
+    DI_FIXED(r, FIXED_LIMBS(512));
+    char text[128];
+    
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count; j++) {
+            di_int x = di_from_string(values[i], 10);
+            di_int y = di_from_string(values[j], 10);
+            TEST_ASSERT_TRUE(di_fixed_from_string(&a, values[i], 10));
+            TEST_ASSERT_TRUE(di_fixed_set_view(&b, di_view_of(y)));
+            TEST_ASSERT_EQUAL_INT(di_compare(x, y), di_fixed_compare(&a, &b));
+            
+            di_int expected[] = { di_add(x, y), di_sub(x, y), di_mul(x, y), di_shift_right(x, 37) };
+            TEST_ASSERT_TRUE(di_fixed_add(&r, &a, &b));
+            TEST_ASSERT_EQUAL_INT(0, di_view_compare(di_fixed_view(&r), di_view_of(expected[0])));
+            TEST_ASSERT_TRUE(di_fixed_sub(&r, &a, &b));
+            TEST_ASSERT_EQUAL_INT(0, di_view_compare(di_fixed_view(&r), di_view_of(expected[1])));
+            TEST_ASSERT_TRUE(di_fixed_mul(&r, &a, &b));
+            TEST_ASSERT_EQUAL_INT(0, di_view_compare(di_fixed_view(&r), di_view_of(expected[2])));
+            char* s = di_to_string(expected[2], 10);
+            TEST_ASSERT_TRUE(di_fixed_to_string(&r, 10, text, sizeof(text)));
+            TEST_ASSERT_EQUAL_STRING(s, text);
+            free(s);
+            TEST_ASSERT_TRUE(di_fixed_shift_right(&r, &a, 37));
+            TEST_ASSERT_EQUAL_INT(0, di_view_compare(di_fixed_view(&r), di_view_of(expected[3])));
+            
+            for (size_t k = 0; k < 4; k++) di_release(&expected[k]);
+            di_release(&x);
+            di_release(&y);
+        }
+    }
+}
+
 // Large number tests (using int64)
 void test_int64_conversion(void) {
     di_int a = di_from_int64(1234567890123LL);
@@ -735,6 +1008,39 @@ void test_divide_negative(void) {
     di_release(&quotient);
 }
 
+void test_divide_mixed_signs_below_one(void) {
+    // |a| < |b| with opposite signs: floor(-3 / 7) = -1, -3 mod 7 = 4
+    di_int a = di_from_int32(-3);
+    di_int b = di_from_int32(7);
+    di_int quotient = di_div(a, b);
+    di_int remainder = di_mod(a, b);
+    
+    int32_t result;
+    TEST_ASSERT_TRUE(di_to_int32(quotient, &result));
+    TEST_ASSERT_EQUAL_INT32(-1, result);
+    TEST_ASSERT_TRUE(di_to_int32(remainder, &result));
+    TEST_ASSERT_EQUAL_INT32(4, result);
+    di_release(&quotient);
+    di_release(&remainder);
+    
+    // floor(3 / -7) = -1, 3 mod -7 = -4
+    di_int c = di_negate(a);
+    di_int d = di_negate(b);
+    quotient = di_div(c, d);
+    remainder = di_mod(c, d);
+    TEST_ASSERT_TRUE(di_to_int32(quotient, &result));
+    TEST_ASSERT_EQUAL_INT32(-1, result);
+    TEST_ASSERT_TRUE(di_to_int32(remainder, &result));
+    TEST_ASSERT_EQUAL_INT32(-4, result);
+    
+    di_release(&a);
+    di_release(&b);
+    di_release(&c);
+    di_release(&d);
+    di_release(&quotient);
+    di_release(&remainder);
+}
+
 // Modular exponentiation tests
 void test_mod_pow_basic(void) {
     di_int base = di_from_int32(2);
@@ -772,6 +1078,34 @@ void test_mod_pow_zero_exp(void) {
     di_release(&result);
 }
 
+void test_pow_basic(void) {
+    di_int base = di_from_int32(-3);
+    di_int result = di_pow(base, 5);
+    int32_t val;
+    TEST_ASSERT_TRUE(di_to_int32(result, &val));
+    TEST_ASSERT_EQUAL_INT32(-243, val);
+    di_release(&result);
+    
+    result = di_pow(base, 0);
+    TEST_ASSERT_TRUE(di_is_one(result));
+    di_release(&result);
+    di_release(&base);
+    
+    base = di_from_int32(2);
+    result = di_pow(base, 100);
+    char* str = di_to_string(result, 10);
+    TEST_ASSERT_EQUAL_STRING("1267650600228229401496703205376", str);
+    free(str);
+    di_release(&result);
+    di_release(&base);
+    
+    base = di_zero();
+    result = di_pow(base, 7);
+    TEST_ASSERT_TRUE(di_is_zero(result));
+    di_release(&result);
+    di_release(&base);
+}
+
 // Prime testing tests
 void test_is_prime_small_primes(void) {
     di_int two = di_from_int32(2);
@@ -807,6 +1141,59 @@ void test_is_prime_composites(void) {
     di_release(&nine);
 }
 
+// Strong pseudoprimes to the smallest prime bases must not pass at low certainty
+void test_is_prime_strong_pseudoprimes(void) {
+    di_int spsp2 = di_from_int64(1373653);             // 829 * 1657, bases 2 and 3
+    di_int spsp8 = di_from_int64(341550071728321LL);   // 10670053 * 32010157, bases 2 to 17
+    
+    for (int certainty = 1; certainty <= 8; certainty++) {
+        TEST_ASSERT_FALSE(di_is_prime(spsp2, certainty));
+        TEST_ASSERT_FALSE(di_is_prime(spsp8, certainty));
+    }
+    
+    di_release(&spsp2);
+    di_release(&spsp8);
+}
+
+static bool failing_entropy(void* ctx, void* buf, size_t size) {
+    (void)ctx;
+    (void)buf;
+    (void)size;
+    return false;
+}
+
+// Witnesses for large n come from a private stream, not the default generator
+void test_is_prime_leaves_default_rng_alone(void) {
+    di_int one = di_one();
+    di_int shifted = di_shift_left(one, 89);
+    di_int m89 = di_sub(shifted, one);                   // 2^89 - 1 is prime
+    di_int composite = di_mul(m89, m89);
+    
+    di_rng* rng = di_rng_default();
+    di_rng_seed(rng, 2024);
+    uint64_t expected[2];
+    TEST_ASSERT_TRUE(di_random_fill(rng, expected, sizeof(expected)));
+    di_rng_seed(rng, 2024);
+    uint64_t first;
+    TEST_ASSERT_TRUE(di_random_fill(rng, &first, sizeof(first)));
+    TEST_ASSERT_TRUE(di_is_prime(m89, 20));
+    TEST_ASSERT_FALSE(di_is_prime(composite, 20));
+    uint64_t second;
+    TEST_ASSERT_TRUE(di_random_fill(rng, &second, sizeof(second)));
+    TEST_ASSERT_EQUAL_UINT64(expected[0], first);
+    TEST_ASSERT_EQUAL_UINT64(expected[1], second);
+    
+    // A default generator that cannot produce bytes does not stall the test
+    di_rng_set_entropy(rng, failing_entropy, NULL);
+    TEST_ASSERT_TRUE(di_is_prime(m89, 20));
+    di_rng_seed(rng, 2024);
+    
+    di_release(&one);
+    di_release(&shifted);
+    di_release(&m89);
+    di_release(&composite);
+}
+
 void test_next_prime(void) {
     di_int ten = di_from_int32(10);
     di_int next = di_next_prime(ten);
@@ -904,6 +1291,28 @@ void test_sqrt_non_perfect_square(void) {
     di_release(&root);
 }
 
+void test_sqrt_large(void) {
+    // Needs more Newton steps than a guess of n / 2 allows
+    di_int num = di_from_string("1000000000000000000000000000000000000000000000000000000000000", 10);
+    di_int root = di_sqrt(num);
+    char* str = di_to_string(root, 10);
+    TEST_ASSERT_EQUAL_STRING("1000000000000000000000000000000", str);
+    free(str);
+    
+    di_int one = di_one();
+    di_int below = di_sub(num, one);
+    di_int root_below = di_sqrt(below);
+    str = di_to_string(root_below, 10);
+    TEST_ASSERT_EQUAL_STRING("999999999999999999999999999999", str);
+    free(str);
+    
+    di_release(&num);
+    di_release(&root);
+    di_release(&one);
+    di_release(&below);
+    di_release(&root_below);
+}
+
 // Factorial tests
 void test_factorial_small(void) {
     di_int fact5 = di_factorial(5);
@@ -1473,6 +1882,1669 @@ void test_mixed_large_negative_operations(void) {
     di_release(&abs_val);
 }
 
+// Binary import/export tests
+void test_export_import_bytes_big_endian(void) {
+    di_int a = di_from_string("4759477275222530853130", 10); // 0x0102030405060708090A
+    uint8_t buf[16];
+    
+    TEST_ASSERT_EQUAL_size_t(10, di_export_size(a, 1));
+    size_t n = di_export(a, buf, sizeof(buf), 1, DI_ENDIAN_BIG, DI_ORDER_MSF);
+    TEST_ASSERT_EQUAL_size_t(10, n);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT8(i + 1, buf[i]);
+    }
+    
+    di_int back = di_import(buf, n, 1, DI_ENDIAN_BIG, DI_ORDER_MSF);
+    TEST_ASSERT_TRUE(di_eq(a, back));
+    
+    di_release(&a);
+    di_release(&back);
+}
+
+void test_export_import_word_layouts(void) {
+    di_int a = di_from_string("-123456789012345678901234567890123456789", 10);
+    const size_t word_sizes[] = { 1, 2, 3, 4, 8 };
+    const int endians[] = { DI_ENDIAN_BIG, DI_ENDIAN_LITTLE, DI_ENDIAN_NATIVE };
+    const int orders[] = { DI_ORDER_MSF, DI_ORDER_LSF };
+    uint8_t buf[64];
+    di_int abs_a = di_abs(a);
+    
+    for (size_t w = 0; w < 5; w++) {
+        for (size_t e = 0; e < 3; e++) {
+            for (size_t o = 0; o < 2; o++) {
+                size_t n = di_export(a, buf, sizeof(buf), word_sizes[w], endians[e], orders[o]);
+                TEST_ASSERT_EQUAL_size_t(di_export_size(a, word_sizes[w]), n);
+                di_int back = di_import(buf, n, word_sizes[w], endians[e], orders[o]);
+                TEST_ASSERT_TRUE(di_eq(abs_a, back));
+                di_release(&back);
+            }
+        }
+    }
+    
+    // Native 32-bit words come out as host integers
+    uint32_t words[4];
+    TEST_ASSERT_EQUAL_size_t(4, di_export(a, words, sizeof(words), 4, DI_ENDIAN_NATIVE, DI_ORDER_LSF));
+    TEST_ASSERT_EQUAL_HEX32(0xAE398115u, words[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x5CE0E9A5u, words[3]);
+    
+    di_release(&a);
+    di_release(&abs_a);
+}
+
+void test_export_edge_cases(void) {
+    di_int zero = di_zero();
+    uint8_t buf[4];
+    
+    TEST_ASSERT_EQUAL_size_t(0, di_export_size(zero, 1));
+    TEST_ASSERT_EQUAL_size_t(0, di_export(zero, NULL, 0, 1, DI_ENDIAN_BIG, DI_ORDER_MSF));
+    
+    // Buffer too small for the value
+    di_int big = di_from_uint64(0x1122334455ULL);
+    TEST_ASSERT_EQUAL_size_t(0, di_export(big, buf, sizeof(buf), 1, DI_ENDIAN_BIG, DI_ORDER_MSF));
+    
+    // Leading zero words are accepted on import
+    const uint8_t padded[] = { 0, 0, 0, 0x12, 0x34 };
+    di_int imported = di_import(padded, sizeof(padded), 1, DI_ENDIAN_BIG, DI_ORDER_MSF);
+    int32_t val;
+    TEST_ASSERT_TRUE(di_to_int32(imported, &val));
+    TEST_ASSERT_EQUAL_INT32(0x1234, val);
+    TEST_ASSERT_EQUAL_size_t(1, di_limb_count(imported));
+    
+    di_release(&zero);
+    di_release(&big);
+    di_release(&imported);
+}
+
+// Varint encoding tests
+void test_varint_small_values(void) {
+    const int64_t values[] = { 0, -1, 1, -64, 64, INT64_MAX, INT64_MIN };
+    const size_t sizes[] = { 1, 1, 1, 1, 2, 10, 10 };
+    uint8_t buf[16];
+    
+    for (size_t i = 0; i < 7; i++) {
+        di_int a = di_from_int64(values[i]);
+        TEST_ASSERT_EQUAL_size_t(sizes[i], di_varint_size(a));
+        size_t n = di_encode_varint(a, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL_size_t(sizes[i], n);
+        
+        size_t used = 0;
+        di_int back = di_decode_varint(buf, n, &used);
+        TEST_ASSERT_NOT_NULL(back);
+        TEST_ASSERT_EQUAL_size_t(n, used);
+        TEST_ASSERT_TRUE(di_eq(a, back));
+        di_release(&a);
+        di_release(&back);
+    }
+    
+    // Zigzag mapping matches protobuf sint64
+    di_int a = di_from_int32(64);
+    TEST_ASSERT_EQUAL_size_t(2, di_encode_varint(a, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0x80, buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, buf[1]);
+    TEST_ASSERT_EQUAL_size_t(0, di_encode_varint(a, buf, 1));
+    di_release(&a);
+}
+
+void test_varint_large_values(void) {
+    // -(2^100) and 2^70 + 5, encodings computed independently
+    const uint8_t neg_expected[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                     0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x07 };
+    const uint8_t pos_expected[] = { 0x8A, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                                     0x80, 0x80, 0x02 };
+    di_int neg = di_from_string("-1267650600228229401496703205376", 10);
+    di_int pos = di_from_string("1180591620717411303429", 10);
+    uint8_t buf[32];
+    
+    size_t n = di_encode_varint(neg, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(sizeof(neg_expected), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(neg_expected, buf, n);
+    di_int back = di_decode_varint(buf, n, NULL);
+    TEST_ASSERT_TRUE(di_eq(neg, back));
+    di_release(&back);
+    
+    n = di_encode_varint(pos, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(sizeof(pos_expected), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pos_expected, buf, n);
+    back = di_decode_varint(buf, n, NULL);
+    TEST_ASSERT_TRUE(di_eq(pos, back));
+    di_release(&back);
+    
+    // Truncated input
+    TEST_ASSERT_NULL(di_decode_varint(buf, n - 1, NULL));
+    
+    di_release(&neg);
+    di_release(&pos);
+}
+
+void test_varint_batch(void) {
+    di_int values[4];
+    values[0] = di_from_int32(7);
+    values[1] = di_from_string("-98765432109876543210987654321", 10);
+    values[2] = di_zero();
+    values[3] = di_from_int64(INT64_MIN);
+    
+    uint8_t buf[64];
+    size_t total = di_varint_batch_size(values, 4);
+    TEST_ASSERT_EQUAL_size_t(total, di_encode_varint_batch(values, 4, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_size_t(0, di_encode_varint_batch(values, 4, buf, total - 1));
+    
+    di_int decoded[4];
+    TEST_ASSERT_EQUAL_size_t(total, di_decode_varint_batch(buf, total, decoded, 4));
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(di_eq(values[i], decoded[i]));
+        di_release(&decoded[i]);
+    }
+    
+    // Asking for more values than the buffer holds fails cleanly
+    di_int too_many[5];
+    TEST_ASSERT_EQUAL_size_t(0, di_decode_varint_batch(buf, total, too_many, 5));
+    TEST_ASSERT_NULL(too_many[0]);
+    TEST_ASSERT_NULL(too_many[4]);
+    
+    for (int i = 0; i < 4; i++) {
+        di_release(&values[i]);
+    }
+}
+
+// CBOR and DER codec tests
+void test_cbor_integers_and_bignums(void) {
+    uint8_t buf[32];
+    size_t used = 0;
+    
+    // Small values use plain major type 0/1 heads
+    di_int a = di_from_int32(-500);
+    const uint8_t small_expected[] = { 0x39, 0x01, 0xF3 };
+    TEST_ASSERT_EQUAL_size_t(3, di_encode_cbor(a, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(small_expected, buf, 3);
+    di_int back = di_decode_cbor(buf, 3, &used);
+    TEST_ASSERT_TRUE(di_eq(a, back));
+    TEST_ASSERT_EQUAL_size_t(3, used);
+    di_release(&a);
+    di_release(&back);
+    
+    // 2^64 needs a tag 2 bignum (RFC 8949 example)
+    a = di_from_string("18446744073709551616", 10);
+    const uint8_t pos_expected[] = { 0xC2, 0x49, 0x01, 0, 0, 0, 0, 0, 0, 0, 0 };
+    TEST_ASSERT_EQUAL_size_t(sizeof(pos_expected), di_cbor_size(a));
+    TEST_ASSERT_EQUAL_size_t(sizeof(pos_expected), di_encode_cbor(a, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(pos_expected, buf, sizeof(pos_expected));
+    back = di_decode_cbor(buf, sizeof(pos_expected), NULL);
+    TEST_ASSERT_TRUE(di_eq(a, back));
+    di_release(&a);
+    di_release(&back);
+    
+    // -18446744073709551617 is tag 3 of 2^64 (RFC 8949 example)
+    a = di_from_string("-18446744073709551617", 10);
+    const uint8_t neg_expected[] = { 0xC3, 0x49, 0x01, 0, 0, 0, 0, 0, 0, 0, 0 };
+    TEST_ASSERT_EQUAL_size_t(sizeof(neg_expected), di_encode_cbor(a, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(neg_expected, buf, sizeof(neg_expected));
+    back = di_decode_cbor(buf, sizeof(neg_expected), NULL);
+    TEST_ASSERT_TRUE(di_eq(a, back));
+    TEST_ASSERT_NULL(di_decode_cbor(buf, sizeof(neg_expected) - 1, NULL));
+    di_release(&back);
+    
+    // -2^64 still fits major type 1
+    di_int b = di_from_string("-18446744073709551616", 10);
+    TEST_ASSERT_EQUAL_size_t(9, di_encode_cbor(b, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0x3B, buf[0]);
+    back = di_decode_cbor(buf, 9, NULL);
+    TEST_ASSERT_TRUE(di_eq(b, back));
+    
+    di_release(&a);
+    di_release(&b);
+    di_release(&back);
+}
+
+void test_der_integers(void) {
+    const int32_t values[] = { 0, 127, 128, -128, -129, 256 };
+    const uint8_t expected[][4] = {
+        { 0x02, 0x01, 0x00 }, { 0x02, 0x01, 0x7F }, { 0x02, 0x02, 0x00, 0x80 },
+        { 0x02, 0x01, 0x80 }, { 0x02, 0x02, 0xFF, 0x7F }, { 0x02, 0x02, 0x01, 0x00 }
+    };
+    const size_t sizes[] = { 3, 3, 4, 3, 4, 4 };
+    uint8_t buf[300];
+    
+    for (size_t i = 0; i < 6; i++) {
+        di_int a = di_from_int32(values[i]);
+        TEST_ASSERT_EQUAL_size_t(sizes[i], di_encode_der(a, buf, sizeof(buf)));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected[i], buf, sizes[i]);
+        size_t used = 0;
+        di_int back = di_decode_der(buf, sizes[i], &used);
+        TEST_ASSERT_TRUE(di_eq(a, back));
+        TEST_ASSERT_EQUAL_size_t(sizes[i], used);
+        di_release(&a);
+        di_release(&back);
+    }
+    
+    // Large negative value uses the long length form
+    di_int minus_one = di_from_int32(-1);
+    di_int big = di_shift_left(minus_one, 1024);
+    size_t n = di_encode_der(big, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_size_t(di_der_size(big), n);
+    TEST_ASSERT_EQUAL_HEX8(0x81, buf[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x81, buf[2]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buf[3]);
+    di_int back = di_decode_der(buf, n, NULL);
+    TEST_ASSERT_TRUE(di_eq(big, back));
+    di_release(&minus_one);
+    di_release(&big);
+    di_release(&back);
+    
+    // Non-minimal encodings are rejected
+    const uint8_t padded[] = { 0x02, 0x02, 0x00, 0x7F };
+    const uint8_t padded_neg[] = { 0x02, 0x02, 0xFF, 0x80 };
+    TEST_ASSERT_NULL(di_decode_der(padded, sizeof(padded), NULL));
+    TEST_ASSERT_NULL(di_decode_der(padded_neg, sizeof(padded_neg), NULL));
+}
+
+// Read-only view tests
+void test_view_from_external_limbs(void) {
+    // 2^(2 * DI_LIMB_BITS) + 5, with a stray leading zero limb
+    const di_limb_t limbs[] = { 5, 0, 1, 0 };
+    const char* text = DI_LIMB_BITS == 16 ? "4294967301" : "18446744073709551621";
+    di_view v = di_view_from_limbs(limbs, 4, false);
+    TEST_ASSERT_EQUAL_size_t(3, v.limb_count);
+    TEST_ASSERT_TRUE(v.limbs == limbs);
+    TEST_ASSERT_EQUAL_size_t(2 * DI_LIMB_BITS + 1, di_view_bit_length(v));
+    
+    char* str = di_view_to_string(v, 10);
+    TEST_ASSERT_EQUAL_STRING(text, str);
+    free(str);
+    
+    di_view neg = di_view_from_limbs(limbs, 4, true);
+    str = di_view_to_string(neg, 10);
+    TEST_ASSERT_EQUAL_CHAR('-', str[0]);
+    TEST_ASSERT_EQUAL_STRING(text, str + 1);
+    free(str);
+    
+    // Zero views are never negative
+    di_view zero = di_view_from_limbs(limbs + 3, 1, true);
+    TEST_ASSERT_EQUAL_size_t(0, zero.limb_count);
+    TEST_ASSERT_FALSE(zero.is_negative);
+    TEST_ASSERT_EQUAL_INT(0, di_view_compare(zero, di_view_from_limbs(NULL, 0, false)));
+    
+    di_int copy = di_from_view(neg);
+    di_int magnitude = di_from_string(text, 10);
+    di_int expected = di_negate(magnitude);
+    TEST_ASSERT_TRUE(di_eq(expected, copy));
+    di_release(&copy);
+    di_release(&expected);
+    di_release(&magnitude);
+}
+
+void test_view_arithmetic(void) {
+    const di_limb_t limbs[] = { DI_LIMB_MAX, DI_LIMB_MAX };
+    di_view v = di_view_from_limbs(limbs, 2, false);
+    di_int one = di_one();
+    di_int big = di_from_view(v);
+    
+    di_int sum = di_view_add(v, di_view_of(one));
+    di_int expected_sum = di_add(big, one);
+    TEST_ASSERT_TRUE(di_eq(expected_sum, sum));
+    
+    di_int diff = di_view_sub(di_view_of(one), v);
+    di_int expected_diff = di_sub(one, big);
+    TEST_ASSERT_TRUE(di_eq(expected_diff, diff));
+    
+    di_int prod = di_view_mul(v, v);
+    di_int expected_prod = di_mul(big, big);
+    TEST_ASSERT_TRUE(di_eq(expected_prod, prod));
+    
+    TEST_ASSERT_EQUAL_INT(1, di_view_compare(v, di_view_of(one)));
+    TEST_ASSERT_EQUAL_INT(-1, di_view_compare(di_view_of(expected_diff), v));
+    TEST_ASSERT_EQUAL_INT(0, di_view_compare(di_view_of(big), v));
+    
+    di_release(&one);
+    di_release(&big);
+    di_release(&sum);
+    di_release(&expected_sum);
+    di_release(&diff);
+    di_release(&expected_diff);
+    di_release(&prod);
+    di_release(&expected_prod);
+}
+
+// Columnar file storage tests
+void test_column_write_and_open(void) {
+    const char* path = "di_column_test.dic";
+    di_int values[5];
+    values[0] = di_from_int32(42);
+    values[1] = di_zero();
+    values[2] = di_from_string("-123456789012345678901234567890", 10);
+    values[3] = di_factorial(30);
+    values[4] = di_from_int32(-1);
+    
+    TEST_ASSERT_TRUE(di_column_write(path, values, 5));
+    
+    di_column col = di_column_open(path);
+    TEST_ASSERT_NOT_NULL(col);
+    TEST_ASSERT_EQUAL_size_t(5, di_column_count(col));
+    for (size_t i = 0; i < 5; i++) {
+        di_view v = di_column_get(col, i);
+        TEST_ASSERT_EQUAL_INT(0, di_view_compare(di_view_of(values[i]), v));
+    }
+    
+    // Views point into the file mapping, not into the original integers
+    di_view v = di_column_get(col, 3);
+    TEST_ASSERT_TRUE(v.limbs != values[3]->limbs);
+    char* str = di_view_to_string(v, 10);
+    TEST_ASSERT_EQUAL_STRING("265252859812191058636308480000000", str);
+    free(str);
+    
+    di_column_close(&col);
+    TEST_ASSERT_NULL(col);
+    
+    for (int i = 0; i < 5; i++) {
+        di_release(&values[i]);
+    }
+    remove(path);
+}
+
+void test_column_rejects_invalid_files(void) {
+    const char* path = "di_column_bad.dic";
+    TEST_ASSERT_NULL(di_column_open("di_column_missing.dic"));
+    
+    // Not a column file
+    FILE* f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    for (int i = 0; i < 64; i++) fputc('x', f);
+    fclose(f);
+    TEST_ASSERT_NULL(di_column_open(path));
+    
+    // Truncated payload
+    di_column col;
+    di_int big = di_factorial(40);
+    TEST_ASSERT_TRUE(di_column_write(path, &big, 1));
+    uint8_t bytes[512];
+    f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    size_t size = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_size_t(size - 4, fwrite(bytes, 1, size - 4, f));
+    fclose(f);
+    TEST_ASSERT_NULL(di_column_open(path));
+    
+    // Corrupt offset index: each case keeps the header and file size intact
+    di_int pair[2] = { di_from_int32(7), big };
+    TEST_ASSERT_TRUE(di_column_write(path, pair, 2));
+    f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    size = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    uint64_t offsets[3];
+    memcpy(offsets, bytes + 32, sizeof(offsets));
+    const uint64_t corrupt[][3] = {
+        { 1, offsets[1], offsets[2] },                  // does not start at 0
+        { 0, offsets[1], offsets[2] - 1 },              // ends before the payload does
+        { 0, offsets[2] + 100, offsets[2] },            // runs past the payload, then back
+    };
+    for (size_t i = 0; i < sizeof(corrupt) / sizeof(corrupt[0]); i++) {
+        memcpy(bytes + 32, corrupt[i], sizeof(offsets));
+        f = fopen(path, "wb");
+        TEST_ASSERT_NOT_NULL(f);
+        TEST_ASSERT_EQUAL_size_t(size, fwrite(bytes, 1, size, f));
+        fclose(f);
+        col = di_column_open(path);
+        if (i < 2) {
+            // Caught by the O(1) checks at open
+            TEST_ASSERT_NULL(col);
+            continue;
+        }
+        // Inner offsets are checked by di_column_get() on the entries they bound
+        TEST_ASSERT_NOT_NULL(col);
+        TEST_ASSERT_NULL(di_column_get(col, 0).limbs);
+        TEST_ASSERT_NULL(di_column_get(col, 1).limbs);
+        di_column_close(&col);
+    }
+    di_release(&pair[0]);
+    
+    // Empty columns are valid
+    TEST_ASSERT_TRUE(di_column_write(path, NULL, 0));
+    col = di_column_open(path);
+    TEST_ASSERT_NOT_NULL(col);
+    TEST_ASSERT_EQUAL_size_t(0, di_column_count(col));
+    di_column_close(&col);
+    
+    di_release(&big);
+    remove(path);
+}
+
+#ifdef DI_THREADSAFE
+// Thread-safe reference counting tests
+#define REFCOUNT_THREADS 4
+#define REFCOUNT_ITERATIONS 100000
+
+static void* refcount_worker(void* arg) {
+    di_int shared = (di_int)arg;
+    for (int i = 0; i < REFCOUNT_ITERATIONS; i++) {
+        di_int ref = di_retain(shared);
+        di_release(&ref);
+    }
+    return NULL;
+}
+
+void test_threadsafe_refcount(void) {
+    di_int shared = di_from_int32(42);
+    pthread_t threads[REFCOUNT_THREADS];
+    
+    for (int i = 0; i < REFCOUNT_THREADS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[i], NULL, refcount_worker, shared));
+    }
+    for (int i = 0; i < REFCOUNT_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    TEST_ASSERT_EQUAL_size_t(1, di_ref_count(shared));
+    
+    // Unshared fast path still counts correctly
+    di_int extra = di_retain(shared);
+    TEST_ASSERT_EQUAL_size_t(2, di_ref_count(shared));
+    di_release(&extra);
+    TEST_ASSERT_EQUAL_size_t(1, di_ref_count(shared));
+    di_release(&shared);
+}
+#endif
+
+// Reentrant random generator tests
+void test_rng_seeded_reproducible(void) {
+    di_rng a, b;
+    di_rng_seed(&a, 2024);
+    di_rng_seed(&b, 2024);
+    
+    for (int i = 0; i < 5; i++) {
+        di_int x = di_random_r(200, &a);
+        di_int y = di_random_r(200, &b);
+        TEST_ASSERT_TRUE(di_eq(x, y));
+        TEST_ASSERT_TRUE(di_bit_length(x) <= 200);
+        di_release(&x);
+        di_release(&y);
+    }
+    
+    // Different seeds give different streams
+    di_rng_seed(&b, 2025);
+    di_int x = di_random_r(128, &a);
+    di_int y = di_random_r(128, &b);
+    TEST_ASSERT_FALSE(di_eq(x, y));
+    di_release(&x);
+    di_release(&y);
+}
+
+void test_rng_range_with_explicit_generator(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 7);
+    di_int min_val = di_from_int32(-50);
+    di_int max_val = di_from_int32(50);
+    
+    for (int i = 0; i < 100; i++) {
+        di_int r = di_random_range_r(min_val, max_val, &rng);
+        TEST_ASSERT_NOT_NULL(r);
+        TEST_ASSERT_TRUE(di_ge(r, min_val));
+        TEST_ASSERT_TRUE(di_lt(r, max_val));
+        di_release(&r);
+    }
+    
+    // NULL selects the thread's default generator
+    TEST_ASSERT_NOT_NULL(di_rng_default());
+    TEST_ASSERT_TRUE(di_rng_default() == di_rng_default());
+    di_int r = di_random_range_r(min_val, max_val, NULL);
+    TEST_ASSERT_TRUE(di_ge(r, min_val));
+    di_release(&r);
+    
+    di_release(&min_val);
+    di_release(&max_val);
+}
+
+// xoshiro256** generator tests
+void test_rng_xoshiro_known_answer(void) {
+    // xoshiro256** seeded through splitmix64(12345), reference values
+    di_rng rng;
+    di_rng_seed(&rng, 12345);
+    uint64_t words[3];
+    di_random_fill(&rng, words, sizeof(words));
+
+    TEST_ASSERT_TRUE(words[0] == 0xBE6A36374160D49BULL);
+    TEST_ASSERT_TRUE(words[1] == 0x214AAA0637A688C6ULL);
+    TEST_ASSERT_TRUE(words[2] == 0xF69D16DE9954D388ULL);
+}
+
+void test_random_fill_odd_sizes(void) {
+    uint8_t a[37], b[37];
+    di_rng r1, r2;
+    di_rng_seed(&r1, 99);
+    di_rng_seed(&r2, 99);
+
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+    di_random_fill(&r1, a, 13);
+    di_random_fill(&r1, a + 13, 24);
+    di_random_fill(&r2, b, 13);
+    di_random_fill(&r2, b + 13, 24);
+    TEST_ASSERT_EQUAL_MEMORY(a, b, sizeof(a));
+
+    // Zero-length fills leave the stream untouched
+    di_random_fill(&r1, NULL, 0);
+    uint64_t x, y;
+    di_random_fill(&r1, &x, sizeof(x));
+    di_random_fill(&r2, &y, sizeof(y));
+    TEST_ASSERT_TRUE(x == y);
+}
+
+void test_rng_jump_streams_differ(void) {
+    di_rng a, b;
+    di_rng_seed(&a, 5);
+    b = a;
+    di_rng_jump(&b);
+
+    uint64_t x[4], y[4];
+    di_random_fill(&a, x, sizeof(x));
+    di_random_fill(&b, y, sizeof(y));
+    TEST_ASSERT_FALSE(memcmp(x, y, sizeof(x)) == 0);
+}
+
+// Secure random and unbiased range tests
+// Entropy source test helpers
+typedef struct {
+    const uint8_t* bytes;  // one fill byte per call
+    size_t calls;
+} scripted_entropy;
+
+static bool scripted_entropy_fill(void* ctx, void* buf, size_t size) {
+    scripted_entropy* script = (scripted_entropy*)ctx;
+    memset(buf, script->bytes[script->calls++], size);
+    return true;
+}
+
+static bool failing_entropy_fill(void* ctx, void* buf, size_t size) {
+    (void)ctx;
+    (void)buf;
+    (void)size;
+    return false;
+}
+
+void test_rng_secure_os_source(void) {
+    di_rng rng;
+    if (!di_rng_secure(&rng)) {
+        TEST_IGNORE_MESSAGE("no OS entropy source on this platform");
+    }
+
+    di_int a = di_random_r(256, &rng);
+    di_int b = di_random_r(256, &rng);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_FALSE(di_eq(a, b));
+
+    uint8_t buf[4096];
+    memset(buf, 0, sizeof(buf));
+    TEST_ASSERT_TRUE(di_random_fill(&rng, buf, sizeof(buf)));
+    size_t nonzero = 0;
+    for (size_t i = 0; i < sizeof(buf); i++) nonzero += buf[i] != 0;
+    TEST_ASSERT_TRUE(nonzero > sizeof(buf) / 2);
+
+    di_release(&a);
+    di_release(&b);
+}
+
+void test_rng_entropy_callback(void) {
+    const uint8_t bytes[] = { 0xFF };
+    scripted_entropy script = { bytes, 0 };
+    di_rng rng;
+    di_rng_seed(&rng, 1);
+    di_rng_set_entropy(&rng, scripted_entropy_fill, &script);
+
+    int32_t value;
+    di_int r = di_random_r(12, &rng);
+    TEST_ASSERT_NOT_NULL(r);
+    TEST_ASSERT_TRUE(di_to_int32(r, &value));
+    TEST_ASSERT_EQUAL_INT32(4095, value);
+    TEST_ASSERT_EQUAL_size_t(1, script.calls);
+    di_release(&r);
+
+    // A failing source is reported rather than masked
+    di_rng_set_entropy(&rng, failing_entropy_fill, NULL);
+    uint8_t buf[16];
+    TEST_ASSERT_FALSE(di_random_fill(&rng, buf, sizeof(buf)));
+    TEST_ASSERT_NULL(di_random_r(64, &rng));
+
+    // Reseeding detaches the source
+    di_rng_seed(&rng, 1);
+    TEST_ASSERT_TRUE(di_random_fill(&rng, buf, sizeof(buf)));
+}
+
+void test_random_range_rejection(void) {
+    // Range size 5 needs 3 bits: 7 is rejected, the next draw of 2 is kept
+    const uint8_t bytes[] = { 0xFF, 0xFF, 0x02 };
+    scripted_entropy script = { bytes, 0 };
+    di_rng rng;
+    di_rng_seed(&rng, 1);
+    di_rng_set_entropy(&rng, scripted_entropy_fill, &script);
+
+    di_int min_val = di_from_int32(10);
+    di_int max_val = di_from_int32(15);
+    int32_t value;
+    di_int r = di_random_range_r(min_val, max_val, &rng);
+    TEST_ASSERT_NOT_NULL(r);
+    TEST_ASSERT_TRUE(di_to_int32(r, &value));
+    TEST_ASSERT_EQUAL_INT32(12, value);
+    TEST_ASSERT_EQUAL_size_t(3, script.calls);
+    di_release(&r);
+
+    // Single-value range always yields min
+    di_int next = di_from_int32(11);
+    r = di_random_range_r(min_val, next, NULL);
+    TEST_ASSERT_TRUE(di_to_int32(r, &value));
+    TEST_ASSERT_EQUAL_INT32(10, value);
+    di_release(&r);
+    di_release(&next);
+
+    // Every residue of a small range shows up about equally often
+    di_rng_seed(&rng, 3);
+    size_t counts[5] = { 0 };
+    for (int i = 0; i < 5000; i++) {
+        r = di_random_range_r(min_val, max_val, &rng);
+        TEST_ASSERT_TRUE(di_to_int32(r, &value));
+        counts[value - 10]++;
+        di_release(&r);
+    }
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(counts[i] > 900 && counts[i] < 1100);
+    }
+
+    di_release(&min_val);
+    di_release(&max_val);
+}
+
+// Prime generation tests
+void test_mod_pow_montgomery(void) {
+    // Fermat: 3^(p-1) = 1 mod p for the Mersenne prime p = 2^127 - 1
+    di_int one = di_one();
+    di_int pow2 = di_shift_left(one, 127);
+    di_int p = di_sub_i32(pow2, 1);
+    di_int exp = di_sub_i32(p, 1);
+    di_int three = di_from_int32(3);
+    di_int r = di_mod_pow(three, exp, p);
+    TEST_ASSERT_TRUE(di_is_one(r));
+    di_release(&r);
+
+    // Negative bases are reduced to [0, mod) first: (-3)^3 mod 2^127 - 1
+    di_int minus_three = di_from_int32(-3);
+    di_int cube = di_from_int32(3);
+    r = di_mod_pow(minus_three, cube, p);
+    di_int expected = di_sub_i32(p, 27);
+    TEST_ASSERT_TRUE(di_eq(r, expected));
+
+    TEST_ASSERT_TRUE(di_is_prime(p, 13));
+    di_int pseudo = di_from_string("3215031751", 10); // strong pseudoprime to 2, 3, 5, 7
+    TEST_ASSERT_FALSE(di_is_prime(pseudo, 13));
+
+    di_release(&one);
+    di_release(&pow2);
+    di_release(&p);
+    di_release(&exp);
+    di_release(&three);
+    di_release(&r);
+    di_release(&minus_three);
+    di_release(&cube);
+    di_release(&expected);
+    di_release(&pseudo);
+}
+
+void test_random_prime(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 2025);
+    size_t sizes[] = { 2, 3, 17, 64, 100, 256 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        di_int p = di_random_prime(sizes[i], &rng);
+        TEST_ASSERT_NOT_NULL(p);
+        TEST_ASSERT_EQUAL_size_t(sizes[i], di_bit_length(p));
+        TEST_ASSERT_TRUE(di_is_prime(p, 20));
+        di_release(&p);
+    }
+
+    // Same seed, same prime
+    di_rng a, b;
+    di_rng_seed(&a, 9);
+    di_rng_seed(&b, 9);
+    di_int p = di_random_prime(128, &a);
+    di_int q = di_random_prime(128, &b);
+    TEST_ASSERT_TRUE(di_eq(p, q));
+    di_release(&p);
+    di_release(&q);
+
+    // Threaded search still yields a prime of the requested size
+    p = di_random_prime_mt(192, &rng, 4);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_EQUAL_size_t(192, di_bit_length(p));
+    TEST_ASSERT_TRUE(di_is_prime(p, 20));
+    di_release(&p);
+}
+
+void test_random_safe_prime(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 77);
+    size_t sizes[] = { 3, 20, 128 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        di_int p = di_random_safe_prime(sizes[i], &rng);
+        TEST_ASSERT_NOT_NULL(p);
+        TEST_ASSERT_EQUAL_size_t(sizes[i], di_bit_length(p));
+        TEST_ASSERT_TRUE(di_is_prime(p, 20));
+
+        di_int q = di_shift_right(p, 1); // (p - 1) / 2 for odd p
+        TEST_ASSERT_TRUE(di_is_prime(q, 20));
+        di_release(&q);
+        di_release(&p);
+    }
+
+    di_int p = di_random_safe_prime_mt(96, &rng, 3);
+    di_int q = di_shift_right(p, 1);
+    TEST_ASSERT_TRUE(di_is_prime(p, 20));
+    TEST_ASSERT_TRUE(di_is_prime(q, 20));
+    di_release(&q);
+    di_release(&p);
+}
+
+// Karatsuba and threaded multiplication tests
+void test_mul_karatsuba_identity(void) {
+    // (2^n - 1)^2 = 2^2n - 2^(n+1) + 1, with n well above the Karatsuba threshold
+    size_t n = 40 * DI_KARATSUBA_THRESHOLD * DI_LIMB_BITS + 7;
+    di_int one = di_one();
+    di_int pow_n = di_shift_left(one, n);
+    di_int ones = di_sub_i32(pow_n, 1);
+    di_int square = di_mul(ones, ones);
+
+    di_int pow_2n = di_shift_left(one, 2 * n);
+    di_int pow_n1 = di_shift_left(one, n + 1);
+    di_int diff = di_sub(pow_2n, pow_n1);
+    di_int expected = di_add_i32(diff, 1);
+    TEST_ASSERT_TRUE(di_eq(square, expected));
+
+    di_release(&one);
+    di_release(&pow_n);
+    di_release(&ones);
+    di_release(&square);
+    di_release(&pow_2n);
+    di_release(&pow_n1);
+    di_release(&diff);
+    di_release(&expected);
+}
+
+void test_mul_unbalanced_distributes(void) {
+    // a * (b + c) == a * b + a * c with a far longer than b and c
+    di_rng rng;
+    di_rng_seed(&rng, 61);
+    di_int a = di_random_r(25 * DI_KARATSUBA_THRESHOLD * DI_LIMB_BITS, &rng);
+    di_int b = di_random_r(3 * DI_KARATSUBA_THRESHOLD * DI_LIMB_BITS / 2, &rng);
+    di_int c = di_random_r(DI_KARATSUBA_THRESHOLD * DI_LIMB_BITS + 5, &rng);
+    di_int neg_c = di_negate(c);
+
+    di_int sum = di_add(b, neg_c);
+    di_int lhs = di_mul(a, sum);
+    di_int ab = di_mul(b, a);
+    di_int ac = di_mul(a, neg_c);
+    di_int rhs = di_add(ab, ac);
+    TEST_ASSERT_TRUE(di_eq(lhs, rhs));
+
+    di_release(&a);
+    di_release(&b);
+    di_release(&c);
+    di_release(&neg_c);
+    di_release(&sum);
+    di_release(&lhs);
+    di_release(&ab);
+    di_release(&ac);
+    di_release(&rhs);
+}
+
+void test_mul_threads_match_serial(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 4096);
+    di_int a = di_random_r((DI_MUL_THREAD_THRESHOLD + 300) * DI_LIMB_BITS, &rng);
+    di_int b = di_random_r(DI_MUL_THREAD_THRESHOLD * DI_LIMB_BITS, &rng);
+
+    di_set_threads(1);
+    TEST_ASSERT_EQUAL_INT(1, di_get_threads());
+    di_int serial = di_mul(a, b);
+
+    di_set_threads(4);
+#ifdef DI_THREADS
+    TEST_ASSERT_EQUAL_INT(4, di_get_threads());
+#else
+    TEST_ASSERT_EQUAL_INT(1, di_get_threads());
+#endif
+    di_int parallel = di_mul(a, b);
+    di_set_threads(1);
+    TEST_ASSERT_TRUE(di_eq(serial, parallel));
+
+    di_release(&a);
+    di_release(&b);
+    di_release(&serial);
+    di_release(&parallel);
+}
+
+// Product tree tests
+void test_product_and_factorial(void) {
+    di_int terms[200];
+    for (int i = 0; i < 200; i++) terms[i] = di_from_int32(i + 1);
+    di_int product = di_product(terms, 200);
+    di_int fact = di_factorial(200);
+    TEST_ASSERT_TRUE(di_eq(product, fact));
+
+    // Signs multiply through; the empty product is 1
+    di_int neg = di_from_int32(-3);
+    di_int mixed[3] = { terms[1], neg, terms[4] };
+    di_int small = di_product(mixed, 3);
+    int32_t value;
+    TEST_ASSERT_TRUE(di_to_int32(small, &value));
+    TEST_ASSERT_EQUAL_INT32(-30, value);
+    di_int empty = di_product(NULL, 0);
+    TEST_ASSERT_TRUE(di_is_one(empty));
+
+    for (int i = 0; i < 200; i++) di_release(&terms[i]);
+    di_release(&product);
+    di_release(&fact);
+    di_release(&neg);
+    di_release(&small);
+    di_release(&empty);
+}
+
+void test_binomial(void) {
+    di_int c = di_binomial(100, 50);
+    char* str = di_to_string(c, 10);
+    TEST_ASSERT_EQUAL_STRING("100891344545564193334812497256", str);
+    free(str);
+    di_release(&c);
+
+    // Symmetry and Pascal's rule: C(n, k) = C(n-1, k-1) + C(n-1, k)
+    di_int a = di_binomial(1000, 300);
+    di_int b = di_binomial(1000, 700);
+    TEST_ASSERT_TRUE(di_eq(a, b));
+    di_int left = di_binomial(999, 299);
+    di_int right = di_binomial(999, 300);
+    di_int sum = di_add(left, right);
+    TEST_ASSERT_TRUE(di_eq(a, sum));
+
+    di_int zero = di_binomial(5, 6);
+    di_int one = di_binomial(7, 0);
+    TEST_ASSERT_TRUE(di_is_zero(zero));
+    TEST_ASSERT_TRUE(di_is_one(one));
+
+    di_release(&a);
+    di_release(&b);
+    di_release(&left);
+    di_release(&right);
+    di_release(&sum);
+    di_release(&zero);
+    di_release(&one);
+}
+
+void test_factorial_threads_match_serial(void) {
+    di_set_threads(1);
+    di_int serial = di_factorial(3000);
+    di_int serial_binom = di_binomial(6000, 2500);
+
+    di_set_threads(3);
+    di_int parallel = di_factorial(3000);
+    di_int parallel_binom = di_binomial(6000, 2500);
+    di_set_threads(1);
+
+    TEST_ASSERT_TRUE(di_eq(serial, parallel));
+    TEST_ASSERT_TRUE(di_eq(serial_binom, parallel_binom));
+
+    di_release(&serial);
+    di_release(&serial_binom);
+    di_release(&parallel);
+    di_release(&parallel_binom);
+}
+
+// Batch operation tests
+void test_add_batch_matches_add(void) {
+    const char* lhs[] = { "0", "-5", "4294967295", "-123456789012345678901234567890", "99" };
+    const char* rhs[] = { "7", "5", "1", "123456789012345678901234567891", "-100" };
+    di_int a[5], b[5], sums[5];
+    for (int i = 0; i < 5; i++) {
+        a[i] = di_from_string(lhs[i], 10);
+        b[i] = di_from_string(rhs[i], 10);
+    }
+
+    di_add_batch(sums, a, b, 5);
+    for (int i = 0; i < 5; i++) {
+        di_int expected = di_add(a[i], b[i]);
+        TEST_ASSERT_TRUE(di_eq(expected, sums[i]));
+        di_release(&expected);
+    }
+
+    // Results are independent: grow one past its slab space, release out of order
+    di_int kept = di_retain(sums[3]);
+    TEST_ASSERT_TRUE(di_reserve(sums[2], 64));
+    di_release(&sums[3]);
+    di_release(&sums[0]);
+    di_release(&sums[4]);
+    di_release(&sums[1]);
+    TEST_ASSERT_TRUE(di_is_one(kept));
+    di_release(&kept);
+    di_int two_pow_32 = di_from_string("4294967296", 10);
+    TEST_ASSERT_TRUE(di_eq(two_pow_32, sums[2]));
+    di_release(&two_pow_32);
+    di_release(&sums[2]);
+
+    for (int i = 0; i < 5; i++) {
+        di_release(&a[i]);
+        di_release(&b[i]);
+    }
+}
+
+void test_mul_batch_threads_match_serial(void) {
+    enum { COUNT = 300 };
+    di_int a[COUNT], b[COUNT], serial[COUNT], parallel[COUNT];
+    di_rng rng;
+    di_rng_seed(&rng, 63);
+    for (int i = 0; i < COUNT; i++) {
+        a[i] = di_random_r((size_t)(i % 50) * 40, &rng);
+        b[i] = di_random_r((size_t)(i % 7) * 300 + 1, &rng);
+        if (i % 3 == 0) {
+            di_int neg = di_negate(b[i]);
+            di_release(&b[i]);
+            b[i] = neg;
+        }
+    }
+
+    di_mul_batch(serial, a, b, COUNT);
+    di_set_threads(3);
+    di_mul_batch(parallel, a, b, COUNT);
+    di_set_threads(1);
+
+    for (int i = 0; i < COUNT; i++) {
+        di_int expected = di_mul(a[i], b[i]);
+        TEST_ASSERT_TRUE(di_eq(expected, serial[i]));
+        TEST_ASSERT_TRUE(di_eq(expected, parallel[i]));
+        di_release(&expected);
+    }
+    for (int i = 0; i < COUNT; i++) {
+        di_release(&a[i]);
+        di_release(&b[i]);
+        di_release(&serial[i]);
+        di_release(&parallel[i]);
+    }
+
+    // Empty batches touch nothing
+    di_mul_batch(NULL, NULL, NULL, 0);
+}
+
+void test_cmp_batch(void) {
+    di_int a[4] = { di_from_int32(-3), di_from_int32(10), di_from_int64(INT64_MAX), di_zero() };
+    di_int b[4] = { di_from_int32(2), di_from_int32(10), di_from_int32(1), di_from_int32(-1) };
+    int out[4];
+    di_cmp_batch(out, a, b, 4);
+    TEST_ASSERT_EQUAL_INT(-1, out[0]);
+    TEST_ASSERT_EQUAL_INT(0, out[1]);
+    TEST_ASSERT_EQUAL_INT(1, out[2]);
+    TEST_ASSERT_EQUAL_INT(1, out[3]);
+    for (int i = 0; i < 4; i++) {
+        di_release(&a[i]);
+        di_release(&b[i]);
+    }
+}
+
+// Structure-of-arrays vector tests
+static di_int* make_vec_test_values(size_t count) {
+    di_int* values = (di_int*)malloc(sizeof(di_int) * count);
+    di_rng rng;
+    di_rng_seed(&rng, 64);
+    for (size_t i = 0; i < count; i++) {
+        // Mostly small values, a few wide ones, every sign
+        values[i] = di_random_r(i % 17 == 0 ? 300 : (i * 13) % 100, &rng);
+        if (i % 3 == 1) {
+            di_int neg = di_negate(values[i]);
+            di_release(&values[i]);
+            values[i] = neg;
+        }
+    }
+    return values;
+}
+
+static void free_vec_test_values(di_int* values, size_t count) {
+    for (size_t i = 0; i < count; i++) di_release(&values[i]);
+    free(values);
+}
+
+void test_vec_round_trip(void) {
+    di_int values[5] = {
+        di_zero(), di_from_int32(-1), di_from_int64(INT64_MIN),
+        di_from_string("340282366920938463463374607431768211456", 10), di_from_int32(INT32_MAX)
+    };
+    di_vec vec = di_vec_from_ints(values, 5);
+    TEST_ASSERT_EQUAL_size_t(5, di_vec_count(vec));
+    for (size_t i = 0; i < 5; i++) {
+        di_int back = di_vec_get(vec, i);
+        TEST_ASSERT_TRUE(di_eq(values[i], back));
+        di_release(&back);
+        di_release(&values[i]);
+    }
+    di_vec_free(&vec);
+    TEST_ASSERT_NULL(vec);
+
+    di_vec empty = di_vec_from_ints(NULL, 0);
+    TEST_ASSERT_EQUAL_size_t(0, di_vec_count(empty));
+    di_vec_free(&empty);
+}
+
+void test_vec_add_sub_match_scalar(void) {
+    const size_t count = 101;
+    di_int* a = make_vec_test_values(count);
+    di_int* b = make_vec_test_values(count);
+    // Reverse b so lanes mix different widths and signs
+    for (size_t i = 0; i < count / 2; i++) {
+        di_int t = b[i];
+        b[i] = b[count - 1 - i];
+        b[count - 1 - i] = t;
+    }
+
+    di_vec va = di_vec_from_ints(a, count);
+    di_vec vb = di_vec_from_ints(b, count);
+    di_vec sum = di_vec_add(va, vb);
+    di_vec diff = di_vec_sub(va, vb);
+    di_vec zero = di_vec_sub(va, va);
+    for (size_t i = 0; i < count; i++) {
+        di_int expected_sum = di_add(a[i], b[i]);
+        di_int expected_diff = di_sub(a[i], b[i]);
+        di_int got_sum = di_vec_get(sum, i);
+        di_int got_diff = di_vec_get(diff, i);
+        di_int got_zero = di_vec_get(zero, i);
+        TEST_ASSERT_TRUE(di_eq(expected_sum, got_sum));
+        TEST_ASSERT_TRUE(di_eq(expected_diff, got_diff));
+        TEST_ASSERT_TRUE(di_is_zero(got_zero));
+        di_release(&expected_sum);
+        di_release(&expected_diff);
+        di_release(&got_sum);
+        di_release(&got_diff);
+        di_release(&got_zero);
+    }
+
+    di_vec_free(&va);
+    di_vec_free(&vb);
+    di_vec_free(&sum);
+    di_vec_free(&diff);
+    di_vec_free(&zero);
+    free_vec_test_values(a, count);
+    free_vec_test_values(b, count);
+}
+
+void test_vec_mul_i32_and_cmp(void) {
+    const size_t count = 70;
+    di_int* a = make_vec_test_values(count);
+    di_vec va = di_vec_from_ints(a, count);
+
+    const int32_t values[] = { 0, -1, 3, INT32_MAX, INT32_MIN };
+    const char* scalars[] = { "0", "-1", "3", "2147483647", "-2147483648" };
+    for (size_t s = 0; s < 5; s++) {
+        di_int scalar = di_from_string(scalars[s], 10);
+        di_vec product = di_vec_mul_i32(va, values[s]);
+        for (size_t i = 0; i < count; i++) {
+            di_int expected = di_mul(a[i], scalar);
+            di_int got = di_vec_get(product, i);
+            TEST_ASSERT_TRUE(di_eq(expected, got));
+            di_release(&expected);
+            di_release(&got);
+        }
+        di_vec_free(&product);
+        di_release(&scalar);
+    }
+
+    // Compare against the vector shifted by one element
+    di_vec shifted = di_vec_from_ints(a + 1, count - 1);
+    di_vec head = di_vec_from_ints(a, count - 1);
+    int out[69];
+    di_vec_cmp(out, head, shifted);
+    for (size_t i = 0; i < count - 1; i++) {
+        TEST_ASSERT_EQUAL_INT(di_compare(a[i], a[i + 1]), out[i]);
+    }
+
+    di_vec_free(&shifted);
+    di_vec_free(&head);
+    di_vec_free(&va);
+    free_vec_test_values(a, count);
+}
+
+// SIMD bitwise and shift tests
+void test_bitwise_long_operands(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 65);
+    // Lengths around vector widths exercise both the SIMD body and the tail
+    for (size_t bits = 1; bits < 4000; bits += 97) {
+        di_int a = di_random_r(bits, &rng);
+        di_int b = di_random_r(bits / 2 + 1, &rng);
+        di_int and_ab = di_and(a, b);
+        di_int or_ab = di_or(a, b);
+        di_int xor_ab = di_xor(b, a);
+
+        // (a & b) + (a | b) == a + b and (a | b) - (a & b) == a ^ b
+        di_int lhs = di_add(and_ab, or_ab);
+        di_int rhs = di_add(a, b);
+        di_int diff = di_sub(or_ab, and_ab);
+        TEST_ASSERT_TRUE(di_eq(lhs, rhs));
+        TEST_ASSERT_TRUE(di_eq(diff, xor_ab));
+
+        // ~a shares no bits with a and fills every bit below its top limb
+        di_int not_a = di_not(a);
+        di_int none = di_and(a, not_a);
+        di_int all = di_or(a, not_a);
+        di_int all_plus_one = di_add_i32(all, 1);
+        TEST_ASSERT_TRUE(di_is_zero(none));
+        TEST_ASSERT_EQUAL_size_t(di_bit_length(all) + 1, di_bit_length(all_plus_one));
+
+        di_release(&a);
+        di_release(&b);
+        di_release(&and_ab);
+        di_release(&or_ab);
+        di_release(&xor_ab);
+        di_release(&lhs);
+        di_release(&rhs);
+        di_release(&diff);
+        di_release(&not_a);
+        di_release(&none);
+        di_release(&all);
+        di_release(&all_plus_one);
+    }
+}
+
+void test_shift_left_long_operands(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 651);
+    di_int one = di_one();
+    for (size_t shift = 0; shift < 300; shift += 13) {
+        di_int a = di_random_r(2000 + shift, &rng);
+        di_int power = di_shift_left(one, shift);
+        di_int shifted = di_shift_left(a, shift);
+        di_int product = di_mul(a, power);
+        TEST_ASSERT_TRUE(di_eq(shifted, product));
+
+        di_int back = di_shift_right(shifted, shift);
+        TEST_ASSERT_TRUE(di_eq(back, a));
+
+        di_release(&a);
+        di_release(&power);
+        di_release(&shifted);
+        di_release(&product);
+        di_release(&back);
+    }
+    di_release(&one);
+}
+
+void test_shift_right_long_operands(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 652);
+    di_int one = di_one();
+    for (size_t shift = 1; shift < 300; shift += 11) {
+        di_int a = di_random_r(1500 + shift * 3, &rng);
+        di_int power = di_shift_left(one, shift);
+        di_int shifted = di_shift_right(a, shift);
+        di_int quotient = di_div(a, power);
+        TEST_ASSERT_TRUE(di_eq(shifted, quotient));
+
+        // Shifts act on the magnitude and keep the sign
+        di_int neg = di_negate(a);
+        di_int neg_shifted = di_shift_right(neg, shift);
+        di_int expected = di_negate(shifted);
+        TEST_ASSERT_TRUE(di_eq(neg_shifted, expected));
+
+        di_release(&a);
+        di_release(&power);
+        di_release(&shifted);
+        di_release(&quotient);
+        di_release(&neg);
+        di_release(&neg_shifted);
+        di_release(&expected);
+    }
+    di_release(&one);
+}
+
+// AVX-512 IFMA multiplication tests
+void test_mul_ifma_sizes(void) {
+    di_rng rng;
+    di_rng_seed(&rng, 66);
+    // Shorter operands from below DI_IFMA_MUL_THRESHOLD to past the
+    // Karatsuba switch; (a * b) / a == b checks against division
+    for (size_t bits = 100; bits < 60000; bits = bits * 5 / 4 + 31) {
+        di_int a = di_random_r(bits, &rng);
+        di_int b = di_random_r(bits / 3 + 64, &rng);
+        di_int ab = di_mul(a, b);
+        di_int ba = di_mul(b, a);
+        di_int q = di_div(ab, a);
+        di_int r = di_mod(ab, a);
+        TEST_ASSERT_TRUE(di_eq(ab, ba));
+        TEST_ASSERT_TRUE(di_eq(q, b));
+        TEST_ASSERT_TRUE(di_is_zero(r));
+        di_release(&a);
+        di_release(&b);
+        di_release(&ab);
+        di_release(&ba);
+        di_release(&q);
+        di_release(&r);
+    }
+}
+
+void test_mul_ifma_carries(void) {
+    // (2^k - 1)^2 = 2^2k - 2^(k+1) + 1 maxes out every digit product
+    di_int one = di_one();
+    for (size_t k = 200; k < 40000; k = k * 3 / 2 + 17) {
+        di_int pow2 = di_shift_left(one, k);
+        di_int ones = di_sub_i32(pow2, 1);
+        di_int square = di_mul(ones, ones);
+        di_int pow2k = di_shift_left(one, 2 * k);
+        di_int pow2k1 = di_shift_left(one, k + 1);
+        di_int diff = di_sub(pow2k, pow2k1);
+        di_int expected = di_add_i32(diff, 1);
+        TEST_ASSERT_TRUE(di_eq(square, expected));
+        di_release(&pow2);
+        di_release(&ones);
+        di_release(&square);
+        di_release(&pow2k);
+        di_release(&pow2k1);
+        di_release(&diff);
+        di_release(&expected);
+    }
+    di_release(&one);
+}
+
+void test_mod_pow_ifma(void) {
+    di_int one = di_one();
+
+    // Fermat for the Mersenne prime 2^521 - 1 (17 limbs)
+    di_int pow2 = di_shift_left(one, 521);
+    di_int p = di_sub_i32(pow2, 1);
+    di_int exp = di_sub_i32(p, 1);
+    di_int base = di_from_string("123456789012345678901234567890", 10);
+    di_int r = di_mod_pow(base, exp, p);
+    TEST_ASSERT_TRUE(di_is_one(r));
+    TEST_ASSERT_TRUE(di_is_prime(p, 5));
+    di_release(&r);
+
+    // 2^e mod (2^k - 1) = 2^(e mod k), for moduli on both sides of the
+    // IFMA threshold and of 52-bit digit boundaries
+    di_int two = di_from_string("2", 10);
+    di_int e = di_from_string("2000000011", 10);
+    for (size_t k = 130; k < 3000; k += 101) {
+        di_int pk = di_shift_left(one, k);
+        di_int mod = di_sub_i32(pk, 1);
+        di_int power = di_mod_pow(two, e, mod);
+        di_int expected = di_shift_left(one, 2000000011u % k);
+        TEST_ASSERT_TRUE(di_eq(power, expected));
+        di_release(&pk);
+        di_release(&mod);
+        di_release(&power);
+        di_release(&expected);
+    }
+
+    di_release(&one);
+    di_release(&pow2);
+    di_release(&p);
+    di_release(&exp);
+    di_release(&base);
+    di_release(&two);
+    di_release(&e);
+}
+
+// CPU dispatch tests
+static const char* const cpu_kernel_names[] = { "scalar", "wide", "avx2", "avx512", "ifma", "neon" };
+#define CPU_KERNEL_COUNT (sizeof(cpu_kernel_names) / sizeof(cpu_kernel_names[0]))
+
+void test_cpu_set_and_get(void) {
+    const char* initial = di_get_cpu();
+    TEST_ASSERT_NOT_NULL(initial);
+
+    TEST_ASSERT_TRUE(di_set_cpu("scalar"));
+    TEST_ASSERT_EQUAL_STRING("scalar", di_get_cpu());
+    TEST_ASSERT_FALSE(di_set_cpu("no-such-cpu"));
+    TEST_ASSERT_EQUAL_STRING("scalar", di_get_cpu());
+
+    // NULL picks the best set, which is where an unset DI_CPU starts too
+    TEST_ASSERT_TRUE(di_set_cpu(NULL));
+    const char* best = di_get_cpu();
+    TEST_ASSERT_TRUE(di_set_cpu(initial));
+    if (!getenv("DI_CPU")) TEST_ASSERT_EQUAL_STRING(best, initial);
+}
+
+// a + b, a - b, a * b, a / 1000000007, a & b and a << 7 under one kernel set
+static void cpu_kernel_results(di_int a, di_int b, di_int out[6]) {
+    di_int d = di_from_string("1000000007", 10);
+    out[0] = di_add(a, b);
+    out[1] = di_sub(a, b);
+    out[2] = di_mul(a, b);
+    out[3] = di_div(a, d);
+    out[4] = di_and(a, b);
+    out[5] = di_shift_left(a, 7);
+    di_release(&d);
+}
+
+void test_cpu_kernel_sets_agree(void) {
+    const char* initial = di_get_cpu();
+    di_rng rng;
+    di_rng_seed(&rng, 67);
+    for (size_t bits = 1; bits < 20000; bits = bits * 3 / 2 + 29) {
+        di_int a = di_random_r(bits, &rng);
+        di_int b = di_random_r(bits / 2 + 40, &rng);
+        di_int expected[6];
+        TEST_ASSERT_TRUE(di_set_cpu("scalar"));
+        cpu_kernel_results(a, b, expected);
+
+        for (size_t k = 1; k < CPU_KERNEL_COUNT; k++) {
+            if (!di_set_cpu(cpu_kernel_names[k])) continue;
+            di_int got[6];
+            cpu_kernel_results(a, b, got);
+            for (int i = 0; i < 6; i++) {
+                TEST_ASSERT_TRUE(di_eq(got[i], expected[i]));
+                di_release(&got[i]);
+            }
+        }
+        for (int i = 0; i < 6; i++) di_release(&expected[i]);
+        di_release(&a);
+        di_release(&b);
+    }
+    TEST_ASSERT_TRUE(di_set_cpu(initial));
+}
+
+void test_cpu_kernel_carries(void) {
+    const char* initial = di_get_cpu();
+    di_int one = di_one();
+    for (size_t k = 0; k < CPU_KERNEL_COUNT; k++) {
+        if (!di_set_cpu(cpu_kernel_names[k])) continue;
+        // Odd and even limb counts so the paired kernels leave a tail
+        for (size_t bits = 31; bits < 700; bits += 32) {
+            di_int pow2 = di_shift_left(one, bits);
+            di_int ones = di_sub(pow2, one);
+            di_int back = di_add(ones, one);
+            di_int zero = di_sub(ones, ones);
+            TEST_ASSERT_TRUE(di_eq(back, pow2));
+            TEST_ASSERT_TRUE(di_is_zero(zero));
+
+            // (2^k - 1)^2 + 2 * (2^k - 1) + 1 == 2^2k
+            di_int square = di_mul(ones, ones);
+            di_int twice = di_add(ones, ones);
+            di_int sum = di_add(square, twice);
+            di_int total = di_add(sum, one);
+            di_int pow2k = di_shift_left(one, 2 * bits);
+            TEST_ASSERT_TRUE(di_eq(total, pow2k));
+
+            di_release(&pow2);
+            di_release(&ones);
+            di_release(&back);
+            di_release(&zero);
+            di_release(&square);
+            di_release(&twice);
+            di_release(&sum);
+            di_release(&total);
+            di_release(&pow2k);
+        }
+    }
+    di_release(&one);
+    TEST_ASSERT_TRUE(di_set_cpu(initial));
+}
+
+// Statistics tests
+void test_stats_op_names(void) {
+    TEST_ASSERT_EQUAL_STRING("add", di_stats_op_name(DI_STATS_ADD));
+    TEST_ASSERT_EQUAL_STRING("from_string", di_stats_op_name(DI_STATS_FROM_STRING));
+    TEST_ASSERT_EQUAL_STRING("random_prime", di_stats_op_name(DI_STATS_RANDOM_PRIME));
+    TEST_ASSERT_EQUAL_STRING("vec", di_stats_op_name(DI_STATS_VEC));
+    TEST_ASSERT_EQUAL_STRING("unknown", di_stats_op_name(DI_STATS_OPS));
+    
+    di_stats st;
+#ifdef DI_STATS
+    TEST_ASSERT_TRUE(di_stats_get(&st));
+#else
+    TEST_ASSERT_FALSE(di_stats_get(&st));
+    TEST_ASSERT_EQUAL_UINT64(0, st.allocs);
+#endif
+}
+
+#ifdef DI_STATS
+void test_stats_counts_allocations(void) {
+    di_stats_reset();
+    di_stats before, after;
+    di_stats_get(&before);
+    
+    di_int a = di_from_string("123456789012345678901234567890", 10);
+    di_int b = di_from_int32(7);
+    di_int sum = di_add(a, b);
+    di_stats_get(&after);
+    TEST_ASSERT_EQUAL_UINT64(before.live_ints + 3, after.live_ints);
+    TEST_ASSERT_TRUE(after.allocs > before.allocs);
+    TEST_ASSERT_TRUE(after.bytes > before.bytes);
+    TEST_ASSERT_TRUE(after.peak_ints >= after.live_ints);
+    TEST_ASSERT_EQUAL_UINT64(1, after.ops[DI_STATS_FROM_STRING].calls);
+    TEST_ASSERT_TRUE(after.ops[DI_STATS_ADD].calls >= 1);
+    
+    di_release(&a);
+    di_release(&b);
+    di_release(&sum);
+    di_stats_get(&after);
+    TEST_ASSERT_EQUAL_UINT64(before.live_ints, after.live_ints);
+    TEST_ASSERT_EQUAL_UINT64(before.live_limbs, after.live_limbs);
+    TEST_ASSERT_EQUAL_UINT64(after.allocs - before.allocs, after.frees - before.frees);
+}
+
+void test_stats_reset_keeps_live_counts(void) {
+    di_int keep = di_from_int32(12345);
+    di_int x = di_shift_left(keep, 200);
+    di_stats_reset();
+    di_stats st;
+    di_stats_get(&st);
+    TEST_ASSERT_EQUAL_UINT64(0, st.allocs);
+    TEST_ASSERT_EQUAL_UINT64(0, st.ops[DI_STATS_SHIFT].calls);
+    // Equal on one thread; pool workers that freed others' integers add slack
+    TEST_ASSERT_TRUE(st.peak_ints >= st.live_ints);
+    TEST_ASSERT_TRUE(st.live_ints >= 2);
+    
+    di_int y = di_mul(x, x);
+    di_int z = di_shift_right(y, 100);
+    di_stats_get(&st);
+    TEST_ASSERT_EQUAL_UINT64(1, st.ops[DI_STATS_MUL].calls);
+    TEST_ASSERT_EQUAL_UINT64(2 * x->limb_count, st.ops[DI_STATS_MUL].limbs);
+    TEST_ASSERT_EQUAL_UINT64(1, st.ops[DI_STATS_SHIFT].calls);
+    TEST_ASSERT_EQUAL_UINT64(y->limb_count, st.ops[DI_STATS_SHIFT].limbs);
+    
+    di_release(&keep);
+    di_release(&x);
+    di_release(&y);
+    di_release(&z);
+}
+
+void test_stats_batch_counts_each_result(void) {
+    di_int a[3], b[3], out[3];
+    for (int i = 0; i < 3; i++) {
+        a[i] = di_from_int32(i + 1);
+        b[i] = di_from_int32(10 * (i + 1));
+    }
+    di_stats_reset();
+    di_stats st;
+    di_mul_batch(out, a, b, 3);
+    di_stats_get(&st);
+    TEST_ASSERT_EQUAL_UINT64(3, st.ops[DI_STATS_MUL].calls);
+    TEST_ASSERT_EQUAL_UINT64(2, st.allocs);
+    TEST_ASSERT_TRUE(st.peak_ints >= st.live_ints);
+    
+    // The shared slab goes back in one piece with the last result
+    di_release(&out[0]);
+    di_release(&out[1]);
+    di_stats_get(&st);
+    TEST_ASSERT_EQUAL_UINT64(0, st.frees);
+    di_release(&out[2]);
+    di_stats_get(&st);
+    TEST_ASSERT_EQUAL_UINT64(2, st.frees);
+    
+    for (int i = 0; i < 3; i++) {
+        di_release(&a[i]);
+        di_release(&b[i]);
+    }
+}
+
+#ifdef DI_THREADSAFE
+static void* stats_thread_worker(void* arg) {
+    di_int x = di_from_string((const char*)arg, 10);
+    di_int y = di_mul(x, x);
+    di_release(&x);
+    di_release(&y);
+    return NULL;
+}
+
+// Threads that exit hand their block to the next thread; counts add up
+void test_stats_keep_exited_thread_counts(void) {
+    di_stats_reset();
+    for (int i = 0; i < 16; i++) {
+        pthread_t thread;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, stats_thread_worker, "123456789012345678901"));
+        pthread_join(thread, NULL);
+    }
+    di_stats st;
+    di_stats_get(&st);
+    TEST_ASSERT_EQUAL_UINT64(16, st.ops[DI_STATS_FROM_STRING].calls);
+    TEST_ASSERT_EQUAL_UINT64(st.allocs, st.frees);
+}
+#endif
+#endif
+
+// Tracing tests
+void test_trace_disabled_or_empty(void) {
+    di_trace_reset();
+    di_trace_hist hist;
+#ifdef DI_TRACE
+    TEST_ASSERT_TRUE(di_trace_get(DI_STATS_MUL, 3, &hist));
+#else
+    TEST_ASSERT_FALSE(di_trace_get(DI_STATS_MUL, 3, &hist));
+    TEST_ASSERT_FALSE(di_trace_dump(NULL, NULL));
+#endif
+    TEST_ASSERT_EQUAL_UINT64(0, hist.count);
+    TEST_ASSERT_EQUAL_UINT64(0, hist.min_ns);
+}
+
+#ifdef DI_TRACE
+static void trace_count_lines(void* ctx, const char* line) {
+    int* lines = (int*)ctx;
+    if (*lines == 0) TEST_ASSERT_EQUAL_STRING_LEN("op,size_min,size_max,", line, 21);
+    if (strncmp(line, "mul,4,7,4,", 10) == 0) lines[1]++;
+    lines[0]++;
+}
+
+void test_trace_records_by_size(void) {
+    di_int one = di_one();
+    di_int a = di_shift_left(one, 3 * DI_LIMB_BITS - 1); // 3 limbs
+    di_int b = di_from_int32(5);                          // 1 limb
+    di_release(&one);
+    di_trace_reset();
+    
+    for (int i = 0; i < 3; i++) {
+        di_int p = di_mul(a, b);
+        di_release(&p);
+    }
+    di_trace_hist hist;
+    TEST_ASSERT_TRUE(di_trace_get(DI_STATS_MUL, 3, &hist)); // 4 limbs in total
+    TEST_ASSERT_EQUAL_UINT64(3, hist.count);
+    TEST_ASSERT_TRUE(hist.min_ns <= hist.max_ns);
+    TEST_ASSERT_TRUE(hist.total_ns >= hist.max_ns);
+    uint64_t binned = 0;
+    for (int i = 0; i < DI_TRACE_LATENCY_BINS; i++) binned += hist.bins[i];
+    TEST_ASSERT_EQUAL_UINT64(3, binned);
+    di_trace_get(DI_STATS_MUL, 2, &hist);
+    TEST_ASSERT_EQUAL_UINT64(0, hist.count);
+    
+    // di_mod() also records the calls it makes
+    di_int m = di_mod(a, b);
+    di_trace_get(DI_STATS_MOD, 3, &hist);
+    TEST_ASSERT_EQUAL_UINT64(1, hist.count);
+    di_trace_get(DI_STATS_DIV, 3, &hist);
+    TEST_ASSERT_EQUAL_UINT64(1, hist.count);
+    di_trace_get(DI_STATS_MUL, 3, &hist);
+    TEST_ASSERT_EQUAL_UINT64(4, hist.count);
+    
+    int lines[2] = { 0, 0 };
+    TEST_ASSERT_TRUE(di_trace_dump(trace_count_lines, lines));
+    TEST_ASSERT_EQUAL_INT(1, lines[1]);
+    TEST_ASSERT_TRUE(lines[0] >= 4);
+    
+    di_trace_reset();
+    di_trace_get(DI_STATS_MUL, 3, &hist);
+    TEST_ASSERT_EQUAL_UINT64(0, hist.count);
+    
+    di_release(&a);
+    di_release(&b);
+    di_release(&m);
+}
+
+// Calls recorded for op across all size buckets
+static uint64_t trace_calls(di_stats_op op) {
+    uint64_t calls = 0;
+    di_trace_hist hist;
+    for (int k = 0; k < DI_TRACE_SIZE_BUCKETS; k++) {
+        di_trace_get(op, k, &hist);
+        calls += hist.count;
+    }
+    return calls;
+}
+
+void test_trace_covers_library_operations(void) {
+    di_int a = di_from_string("123456789012345678901234567890", 10);
+    di_int b = di_from_int32(9876);
+    di_int pair[2] = { a, b };
+    di_int out[2];
+    uint8_t buf[64];
+    di_trace_reset();
+    
+    di_int results[7] = {
+        di_gcd(a, b), di_pow(b, 9), di_sqrt(a), di_product(pair, 2),
+        di_binomial(40, 20), di_next_prime(b), di_decode_varint(buf, di_encode_varint(a, buf, sizeof(buf)), NULL)
+    };
+    TEST_ASSERT_TRUE(di_is_prime(results[5], 20));
+    di_add_batch(out, pair, pair, 2);
+    
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_GCD));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_POW));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_SQRT));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_PRODUCT));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_FACTORIAL));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_EXPORT));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_IMPORT));
+    TEST_ASSERT_EQUAL_UINT64(1, trace_calls(DI_STATS_BATCH));
+    // di_next_prime() records itself and each candidate it tests
+    TEST_ASSERT_TRUE(trace_calls(DI_STATS_PRIME) >= 3);
+    
+    // di_binomial() is bucketed by n: 40 has bit length 6
+    di_trace_hist hist;
+    di_trace_get(DI_STATS_FACTORIAL, 6, &hist);
+    TEST_ASSERT_EQUAL_UINT64(1, hist.count);
+    
+    for (int i = 0; i < 7; i++) di_release(&results[i]);
+    di_release(&out[0]);
+    di_release(&out[1]);
+    di_release(&a);
+    di_release(&b);
+}
+
+#ifdef DI_THREADSAFE
+static void* trace_thread_worker(void* arg) {
+    (void)arg;
+    di_int x = di_from_int32(3);
+    di_int y = di_mul(x, x);
+    di_release(&x);
+    di_release(&y);
+    return NULL;
+}
+
+// Threads that exit hand their histograms to the next thread
+void test_trace_keeps_exited_thread_counts(void) {
+    di_trace_reset();
+    for (int i = 0; i < 16; i++) {
+        pthread_t thread;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, trace_thread_worker, NULL));
+        pthread_join(thread, NULL);
+    }
+    di_trace_hist hist;
+    di_trace_get(DI_STATS_MUL, 2, &hist);   // 1 + 1 limbs
+    TEST_ASSERT_EQUAL_UINT64(16, hist.count);
+}
+#endif
+#endif
+
 int main(void) {
     UNITY_BEGIN();
     
@@ -1543,6 +3615,15 @@ int main(void) {
     
     // Overflow detection tests
     RUN_TEST(test_overflow_detection_int32);
+    RUN_TEST(test_overflow_matrix_signed);
+    RUN_TEST(test_overflow_matrix_unsigned);
+    RUN_TEST(test_overflow_shift_and_negate_edges);
+    RUN_TEST(test_num_promotes_and_demotes);
+    RUN_TEST(test_num_matches_di_int);
+    RUN_TEST(test_num_from_int);
+    RUN_TEST(test_fixed_arithmetic);
+    RUN_TEST(test_fixed_overflow_leaves_destination);
+    RUN_TEST(test_fixed_matches_di_int);
     RUN_TEST(test_overflow_detection_int32_multiply);
     RUN_TEST(test_overflow_detection_int64_operations);
     
@@ -1565,14 +3646,18 @@ int main(void) {
     RUN_TEST(test_divide_basic);
     RUN_TEST(test_divide_with_remainder);
     RUN_TEST(test_divide_negative);
+    RUN_TEST(test_divide_mixed_signs_below_one);
     
     // Modular exponentiation tests
     RUN_TEST(test_mod_pow_basic);
     RUN_TEST(test_mod_pow_zero_exp);
+    RUN_TEST(test_pow_basic);
     
     // Prime testing tests
     RUN_TEST(test_is_prime_small_primes);
     RUN_TEST(test_is_prime_composites);
+    RUN_TEST(test_is_prime_strong_pseudoprimes);
+    RUN_TEST(test_is_prime_leaves_default_rng_alone);
     RUN_TEST(test_next_prime);
     
     // GCD/LCM tests
@@ -1583,6 +3668,7 @@ int main(void) {
     // Square root tests
     RUN_TEST(test_sqrt_perfect_square);
     RUN_TEST(test_sqrt_non_perfect_square);
+    RUN_TEST(test_sqrt_large);
     
     // Factorial tests
     RUN_TEST(test_factorial_small);
@@ -1618,5 +3704,107 @@ int main(void) {
     RUN_TEST(test_large_negative_modulo);
     RUN_TEST(test_mixed_large_negative_operations);
     
+    // Binary import/export tests
+    RUN_TEST(test_export_import_bytes_big_endian);
+    RUN_TEST(test_export_import_word_layouts);
+    RUN_TEST(test_export_edge_cases);
+    
+    // Varint encoding tests
+    RUN_TEST(test_varint_small_values);
+    RUN_TEST(test_varint_large_values);
+    RUN_TEST(test_varint_batch);
+    
+    // CBOR and DER codec tests
+    RUN_TEST(test_cbor_integers_and_bignums);
+    RUN_TEST(test_der_integers);
+    
+    // Read-only view tests
+    RUN_TEST(test_view_from_external_limbs);
+    RUN_TEST(test_view_arithmetic);
+    
+    // Columnar file storage tests
+    RUN_TEST(test_column_write_and_open);
+    RUN_TEST(test_column_rejects_invalid_files);
+    
+#ifdef DI_THREADSAFE
+    // Thread-safe reference counting tests
+    RUN_TEST(test_threadsafe_refcount);
+#endif
+    
+    // Reentrant random generator tests
+    RUN_TEST(test_rng_seeded_reproducible);
+    RUN_TEST(test_rng_range_with_explicit_generator);
+    
+    // xoshiro256** generator tests
+    RUN_TEST(test_rng_xoshiro_known_answer);
+    RUN_TEST(test_random_fill_odd_sizes);
+    RUN_TEST(test_rng_jump_streams_differ);
+    
+    // Secure random and unbiased range tests
+    RUN_TEST(test_rng_secure_os_source);
+    RUN_TEST(test_rng_entropy_callback);
+    RUN_TEST(test_random_range_rejection);
+    
+    // Prime generation tests
+    RUN_TEST(test_mod_pow_montgomery);
+    RUN_TEST(test_random_prime);
+    RUN_TEST(test_random_safe_prime);
+    
+    // Karatsuba and threaded multiplication tests
+    RUN_TEST(test_mul_karatsuba_identity);
+    RUN_TEST(test_mul_unbalanced_distributes);
+    RUN_TEST(test_mul_threads_match_serial);
+    
+    // Product tree tests
+    RUN_TEST(test_product_and_factorial);
+    RUN_TEST(test_binomial);
+    RUN_TEST(test_factorial_threads_match_serial);
+    
+    // Batch operation tests
+    RUN_TEST(test_add_batch_matches_add);
+    RUN_TEST(test_mul_batch_threads_match_serial);
+    RUN_TEST(test_cmp_batch);
+    
+    // Structure-of-arrays vector tests
+    RUN_TEST(test_vec_round_trip);
+    RUN_TEST(test_vec_add_sub_match_scalar);
+    RUN_TEST(test_vec_mul_i32_and_cmp);
+    
+    // SIMD bitwise and shift tests
+    RUN_TEST(test_bitwise_long_operands);
+    RUN_TEST(test_shift_left_long_operands);
+    RUN_TEST(test_shift_right_long_operands);
+    
+    // AVX-512 IFMA multiplication tests
+    RUN_TEST(test_mul_ifma_sizes);
+    RUN_TEST(test_mul_ifma_carries);
+    RUN_TEST(test_mod_pow_ifma);
+    
+    // CPU dispatch tests
+    RUN_TEST(test_cpu_set_and_get);
+    RUN_TEST(test_cpu_kernel_sets_agree);
+    RUN_TEST(test_cpu_kernel_carries);
+    
+    // Statistics tests
+    RUN_TEST(test_stats_op_names);
+#ifdef DI_STATS
+    RUN_TEST(test_stats_counts_allocations);
+    RUN_TEST(test_stats_reset_keeps_live_counts);
+    RUN_TEST(test_stats_batch_counts_each_result);
+#ifdef DI_THREADSAFE
+    RUN_TEST(test_stats_keep_exited_thread_counts);
+#endif
+#endif
+    
+    // Tracing tests
+    RUN_TEST(test_trace_disabled_or_empty);
+#ifdef DI_TRACE
+    RUN_TEST(test_trace_records_by_size);
+    RUN_TEST(test_trace_covers_library_operations);
+#ifdef DI_THREADSAFE
+    RUN_TEST(test_trace_keeps_exited_thread_counts);
+#endif
+#endif
+    
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+// Threshold tuner for dynamic_int.h
+//
+// Measures where each algorithm crossover pays off on this machine and
+// writes the results as a header of #defines. dynamic_int.h includes
+// dynamic_int_tuned.h automatically when it is on the include path (define
+// DI_NO_TUNED to ignore it).
+//
+// Usage: di_tune [OUTPUT]      (default: dynamic_int_tuned.h)
+//
+// A crossover is found the way GMP's tuneup does it: at each size n the
+// operation is timed with the threshold set to n (the faster algorithm is
+// used once at the top level) and to n + 1 (it is not), and the threshold
+// is the first size where the faster algorithm wins several sizes in a row.
+//
+// Build with the same DI_LIMB_BITS and on the same CPU as the code that
+// will use the header; for an MCU, cross-compile this file and run it on
+// the board.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define DI_TUNING
+#define DI_IMPLEMENTATION
+#include "dynamic_int.h"
+
+#define TUNE_BATCH_NS 10e6      // Time each measurement for at least 10 ms
+#define TUNE_ROUNDS 3           // Keep the fastest of this many batches
+#define TUNE_WINS 3             // Consecutive wins that make a crossover
+#define TUNE_NEVER ((size_t)-1 / 4)
+
+typedef void (*tune_setup)(size_t limbs);
+typedef void (*tune_op)(void);
+
+static di_int tune_a;
+static di_int tune_b;
+static di_int tune_m;
+static di_rng tune_rng;
+
+static double tune_now_ns(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Exactly 'limbs' limbs: top bit set so sizes do not drift
+static di_int tune_random(size_t limbs) {
+    di_int r = di_random_r(limbs * DI_LIMB_BITS - 1, &tune_rng);
+    di_int one = di_one();
+    di_int top = di_shift_left(one, limbs * DI_LIMB_BITS - 1);
+    di_int value = di_or(r, top);
+    di_release(&r);
+    di_release(&one);
+    di_release(&top);
+    return value;
+}
+
+static void tune_release(void) {
+    di_release(&tune_a);
+    di_release(&tune_b);
+    di_release(&tune_m);
+}
+
+/* Operations */
+
+static void setup_mul(size_t limbs) {
+    tune_release();
+    tune_a = tune_random(limbs);
+    tune_b = tune_random(limbs);
+}
+
+static void run_mul(void) {
+    di_int r = di_mul(tune_a, tune_b);
+    di_release(&r);
+}
+
+#ifdef DI_HAS_IFMA
+// Odd modulus, so di_mod_pow() takes the Montgomery path
+static void setup_mod_pow(size_t limbs) {
+    setup_mul(limbs);
+    di_int m = tune_random(limbs);
+    di_int one = di_one();
+    tune_m = di_or(m, one);
+    di_release(&m);
+    di_release(&one);
+}
+
+static void run_mod_pow(void) {
+    di_int r = di_mod_pow(tune_a, tune_b, tune_m);
+    di_release(&r);
+}
+#endif
+
+/* Measurement */
+
+static double tune_time(tune_op op) {
+    size_t iterations = 1;
+    double elapsed;
+    for (;;) {
+        double start = tune_now_ns();
+        for (size_t i = 0; i < iterations; i++) op();
+        elapsed = tune_now_ns() - start;
+        if (elapsed >= TUNE_BATCH_NS) break;
+        iterations *= 2;
+    }
+    return elapsed / (double)iterations;
+}
+
+// Time with and without the faster algorithm at the top level, alternating
+// so that clock drift hits both sides; returns with/without
+static double tune_ratio(size_t* threshold, size_t n, tune_op op) {
+    double with = 0, without = 0;
+    for (int round = 0; round < TUNE_ROUNDS; round++) {
+        *threshold = n;
+        double t = tune_time(op);
+        if (round == 0 || t < with) with = t;
+        *threshold = n + 1;
+        t = tune_time(op);
+        if (round == 0 || t < without) without = t;
+    }
+    return with / without;
+}
+
+// Smallest size in [lo, hi] where the faster algorithm wins TUNE_WINS
+// sizes in a row; hi + 1 when it never does
+static size_t tune_crossover(const char* name, size_t* threshold, size_t lo, size_t hi,
+                             tune_setup setup, tune_op op) {
+    size_t first_win = 0;
+    int wins = 0;
+    printf("%s\n", name);
+    for (size_t n = lo; n <= hi; n += n < 32 ? 1 : n / 8) {
+        setup(n);
+        double ratio = tune_ratio(threshold, n, op);
+        printf("  %5zu limbs  %.3f\n", n, ratio);
+        fflush(stdout);
+        if (ratio < 1.0) {
+            if (wins++ == 0) first_win = n;
+            if (wins == TUNE_WINS) {
+                *threshold = first_win;
+                return first_win;
+            }
+        } else {
+            wins = 0;
+        }
+    }
+    *threshold = wins ? first_win : hi + 1;
+    return *threshold;
+}
+
+static const di_kernels* tune_best_kernels(bool ifma) {
+    for (size_t i = 0; i < sizeof(di_kernel_sets) / sizeof(di_kernel_sets[0]); i++) {
+        const di_kernels* k = di_kernel_sets[i];
+        if (k->ifma == ifma && di_kernels_supported(k)) return k;
+    }
+    return NULL;
+}
+
+static void tune_define(FILE* out, const char* name, size_t value) {
+    fprintf(out, "#ifndef %s\n#define %s %zu\n#endif\n", name, name, value);
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "dynamic_int_tuned.h";
+    if (argc > 2 || strcmp(path, "--help") == 0) {
+        fprintf(stderr, "usage: %s [OUTPUT]\n", argv[0]);
+        return 2;
+    }
+    di_rng_seed(&tune_rng, 69);
+
+    // Plain Karatsuba, measured with the best kernel set that is not IFMA
+    const di_kernels* plain = tune_best_kernels(false);
+    di_set_cpu(plain->name);
+    size_t karatsuba = tune_crossover("DI_KARATSUBA_THRESHOLD", &di_tune_karatsuba, 4, 256,
+                                      setup_mul, run_mul);
+
+    const di_kernels* ifma = NULL;
+    size_t ifma_mul = 0, ifma_karatsuba = 0, ifma_mont = 0;
+#ifdef DI_HAS_IFMA
+    ifma = tune_best_kernels(true);
+    if (ifma) {
+        di_set_cpu(ifma->name);
+        // IFMA against the scalar loop, with Karatsuba out of the way
+        di_tune_karatsuba = TUNE_NEVER;
+        di_tune_ifma_karatsuba = TUNE_NEVER;
+        ifma_mul = tune_crossover("DI_IFMA_MUL_THRESHOLD", &di_tune_ifma_mul, 2, 128,
+                                  setup_mul, run_mul);
+        di_tune_karatsuba = karatsuba;
+        // Operands past DI_IFMA_MAX_DIGITS take the scalar loop anyway
+        size_t ifma_limit = DI_IFMA_MAX_DIGITS * 52 / DI_LIMB_BITS;
+        ifma_karatsuba = tune_crossover("DI_IFMA_KARATSUBA_THRESHOLD", &di_tune_ifma_karatsuba,
+                                        64, ifma_limit, setup_mul, run_mul);
+        ifma_mont = tune_crossover("DI_IFMA_MONT_THRESHOLD", &di_tune_ifma_mont, 2, 64,
+                                   setup_mod_pow, run_mod_pow);
+    }
+#else
+    (void)di_tune_ifma_mont;    // Only the IFMA Montgomery code reads it
+#endif
+    tune_release();
+
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return 1;
+    }
+    fprintf(out, "// Generated by di_tune (tune.c) for %d-bit limbs on a CPU using the\n"
+                 "// \"%s\" kernel set. Rerun the tune target to refresh it; delete it or\n"
+                 "// define DI_NO_TUNED to go back to the defaults.\n\n",
+            DI_LIMB_BITS, ifma ? ifma->name : plain->name);
+    fprintf(out, "#ifndef DYNAMIC_INT_TUNED_H\n#define DYNAMIC_INT_TUNED_H\n\n");
+    fprintf(out, "#if DI_LIMB_BITS == %d\n", DI_LIMB_BITS);
+    tune_define(out, "DI_KARATSUBA_THRESHOLD", karatsuba);
+    if (ifma) {
+        tune_define(out, "DI_IFMA_MUL_THRESHOLD", ifma_mul);
+        tune_define(out, "DI_IFMA_KARATSUBA_THRESHOLD", ifma_karatsuba);
+        tune_define(out, "DI_IFMA_MONT_THRESHOLD", ifma_mont);
+    }
+    fprintf(out, "#endif\n\n#endif // DYNAMIC_INT_TUNED_H\n");
+    if (fclose(out) != 0) {
+        perror(path);
+        return 1;
+    }
+    printf("wrote %s\n", path);
+    return 0;
+}